@@ -209,14 +209,17 @@ int32_t base32hex_decode(const uint8_t  *in,
 		return KNOT_BASE32HEX_ESIZE;
 	}
 
-	const uint8_t	*stop = in + in_len;
+	if (in_len == 0) {
+		return 0;
+	}
+
+	const uint8_t	*last = in + in_len - 8;
 	uint8_t		*bin = out;
 	uint8_t		pad_len = 0;
 	uint8_t		c1, c2, c3, c4, c5, c6, c7, c8;
 
-	// Decoding loop takes 8 characters and creates 5 bytes.
-	while (in < stop) {
-		// Filling and transforming 8 Base32hex chars.
+	// Decoding loop takes 8 characters and creates 5 bytes (no padding).
+	while (in < last) {
 		c1 = base32hex_dec[in[0]];
 		c2 = base32hex_dec[in[1]];
 		c3 = base32hex_dec[in[2]];
@@ -226,102 +229,107 @@ int32_t base32hex_decode(const uint8_t  *in,
 		c7 = base32hex_dec[in[6]];
 		c8 = base32hex_dec[in[7]];
 
-		// Check 8. char if is bad or padding.
-		if (c8 >= PD) {
-			if (c8 == PD && pad_len == 0) {
-				pad_len = 1;
-			} else {
-				return KNOT_BASE32HEX_ECHAR;
-			}
+		// Both bad and padding characters have some of the upper bits set.
+		if ((c1 | c2 | c3 | c4 | c5 | c6 | c7 | c8) >= PD) {
+			return KNOT_BASE32HEX_ECHAR;
 		}
 
-		// Check 7. char if is bad or padding (if so, 6. must be too).
-		if (c7 >= PD) {
-			if (c7 == PD && c6 == PD && pad_len == 1) {
-				pad_len = 3;
-			} else {
-				return KNOT_BASE32HEX_ECHAR;
-			}
-		}
+		bin[0] = (c1 << 3) + (c2 >> 2);
+		bin[1] = (c2 << 6) + (c3 << 1) + (c4 >> 4);
+		bin[2] = (c4 << 4) + (c5 >> 1);
+		bin[3] = (c5 << 7) + (c6 << 2) + (c7 >> 3);
+		bin[4] = (c7 << 5) + c8;
+		bin += 5;
+		in += 8;
+	}
 
-		// Check 6. char if is bad or padding.
-		if (c6 >= PD) {
-			if (!(c6 == PD && pad_len == 3)) {
-				return KNOT_BASE32HEX_ECHAR;
-			}
+	// Filling and transforming the last 8 Base32hex chars.
+	c1 = base32hex_dec[in[0]];
+	c2 = base32hex_dec[in[1]];
+	c3 = base32hex_dec[in[2]];
+	c4 = base32hex_dec[in[3]];
+	c5 = base32hex_dec[in[4]];
+	c6 = base32hex_dec[in[5]];
+	c7 = base32hex_dec[in[6]];
+	c8 = base32hex_dec[in[7]];
+
+	// Check 8. char if is bad or padding.
+	if (c8 >= PD) {
+		if (c8 == PD) {
+			pad_len = 1;
+		} else {
+			return KNOT_BASE32HEX_ECHAR;
 		}
+	}
 
-		// Check 5. char if is bad or padding.
-		if (c5 >= PD) {
-			if (c5 == PD && pad_len == 3) {
-				pad_len = 4;
-			} else {
-				return KNOT_BASE32HEX_ECHAR;
-			}
+	// Check 7. char if is bad or padding (if so, 6. must be too).
+	if (c7 >= PD) {
+		if (c7 == PD && c6 == PD && pad_len == 1) {
+			pad_len = 3;
+		} else {
+			return KNOT_BASE32HEX_ECHAR;
 		}
+	}
 
-		// Check 4. char if is bad or padding (if so, 3. must be too).
-		if (c4 >= PD) {
-			if (c4 == PD && c3 == PD && pad_len == 4) {
-				pad_len = 6;
-			} else {
-				return KNOT_BASE32HEX_ECHAR;
-			}
+	// Check 6. char if is bad or padding.
+	if (c6 >= PD) {
+		if (!(c6 == PD && pad_len == 3)) {
+			return KNOT_BASE32HEX_ECHAR;
 		}
+	}
 
-		// Check 3. char if is bad or padding.
-		if (c3 >= PD) {
-			if (!(c3 == PD && pad_len == 6)) {
-				return KNOT_BASE32HEX_ECHAR;
-			}
+	// Check 5. char if is bad or padding.
+	if (c5 >= PD) {
+		if (c5 == PD && pad_len == 3) {
+			pad_len = 4;
+		} else {
+			return KNOT_BASE32HEX_ECHAR;
 		}
+	}
 
-		// 1. and 2. chars must not be padding.
-		if (c2 >= PD || c1 >= PD) {
+	// Check 4. char if is bad or padding (if so, 3. must be too).
+	if (c4 >= PD) {
+		if (c4 == PD && c3 == PD && pad_len == 4) {
+			pad_len = 6;
+		} else {
 			return KNOT_BASE32HEX_ECHAR;
 		}
+	}
 
-		// Computing of output data based on padding length.
-		switch (pad_len) {
-		case 0:
-			bin[4] = (c7 << 5) + c8;
-			// FALLTHROUGH
-		case 1:
-			bin[3] = (c5 << 7) + (c6 << 2) + (c7 >> 3);
-			// FALLTHROUGH
-		case 3:
-			bin[2] = (c4 << 4) + (c5 >> 1);
-			// FALLTHROUGH
-		case 4:
-			bin[1] = (c2 << 6) + (c3 << 1) + (c4 >> 4);
-			// FALLTHROUGH
-		case 6:
-			bin[0] = (c1 << 3) + (c2 >> 2);
+	// Check 3. char if is bad or padding.
+	if (c3 >= PD) {
+		if (!(c3 == PD && pad_len == 6)) {
+			return KNOT_BASE32HEX_ECHAR;
 		}
+	}
 
-		// Update output end.
-		switch (pad_len) {
-		case 0:
-			bin += 5;
-			break;
-		case 1:
-			bin += 4;
-			break;
-		case 3:
-			bin += 3;
-			break;
-		case 4:
-			bin += 2;
-			break;
-		case 6:
-			bin += 1;
-			break;
-		}
+	// 1. and 2. chars must not be padding.
+	if (c2 >= PD || c1 >= PD) {
+		return KNOT_BASE32HEX_ECHAR;
+	}
 
-		in += 8;
+	// Computing of output data based on padding length.
+	switch (pad_len) {
+	case 0:
+		bin[4] = (c7 << 5) + c8;
+		// FALLTHROUGH
+	case 1:
+		bin[3] = (c5 << 7) + (c6 << 2) + (c7 >> 3);
+		// FALLTHROUGH
+	case 3:
+		bin[2] = (c4 << 4) + (c5 >> 1);
+		// FALLTHROUGH
+	case 4:
+		bin[1] = (c2 << 6) + (c3 << 1) + (c4 >> 4);
+		// FALLTHROUGH
+	case 6:
+		bin[0] = (c1 << 3) + (c2 >> 2);
 	}
 
-	return (bin - out);
+	// Number of output bytes of the last quantum based on padding length.
+	static const uint8_t last_len[] = { 5, 4, 0, 3, 2, 0, 1 };
+
+	return (bin - out) + last_len[pad_len];
 }
 
 int32_t base32hex_decode_alloc(const uint8_t  *in,
@@ -20,6 +20,11 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+ #define HAVE_X86_SIMD
+ #include <immintrin.h>
+#endif
+
 /*! \brief Maximal length of binary input to Base64 encoding. */
 #define MAX_BIN_DATA_LEN	((INT32_MAX / 4) * 3)
 
@@ -81,6 +86,278 @@ static const uint8_t base64_dec[256] = {
 	[ 42] = KO, ['U'] = 20, [128] = KO, [171] = KO, [214] = KO,
 };
 
+#ifdef HAVE_X86_SIMD
+/*! \brief Supported vector instruction sets. */
+enum {
+	SIMD_UNKNOWN = 0,
+	SIMD_NONE,
+	SIMD_SSSE3,
+	SIMD_AVX2,
+};
+
+#ifdef HAVE_ATOMIC
+ #define ATOMIC_GET(src)	__atomic_load_n(&(src), __ATOMIC_RELAXED)
+ #define ATOMIC_SET(dst, val)	__atomic_store_n(&(dst), (val), __ATOMIC_RELAXED)
+#else
+ // The detected level is always the same, so a racy update is harmless.
+ #define ATOMIC_GET(src)	(src)
+ #define ATOMIC_SET(dst, val)	((dst) = (val))
+#endif
+
+/*! \brief Cached vector instruction set level. */
+static int simd_cached = SIMD_UNKNOWN;
+
+/*! \brief Returns the best vector instruction set supported by the CPU. */
+static int simd_level(void)
+{
+	int cached = ATOMIC_GET(simd_cached);
+	if (cached != SIMD_UNKNOWN) {
+		return cached;
+	}
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		cached = SIMD_AVX2;
+	} else if (__builtin_cpu_supports("ssse3")) {
+		cached = SIMD_SSSE3;
+	} else {
+		cached = SIMD_NONE;
+	}
+	ATOMIC_SET(simd_cached, cached);
+
+	return cached;
+}
+
+/*
+ * The vector codecs follow the algorithms described by Wojciech Mula and
+ * Daniel Lemire (https://arxiv.org/abs/1704.00605). Encoding splits each
+ * 3-byte group into four 6-bit indices by multiplication and translates them
+ * into the alphabet using a 16-entry offset table. Decoding validates the
+ * characters with two nibble-indexed bitmask tables, translates them back and
+ * packs four 6-bit values into three bytes by multiply-add instructions.
+ */
+
+/*! \brief Offsets from a 6-bit value to its character, indexed by value class. */
+#define ENC_LUT	'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, \
+		'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, \
+		'/' - 63, 'A', 0, 0
+/*! \brief Places three input bytes into a 32-bit word as [b1, b0, b2, b1]. */
+#define ENC_SHUF	1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+/*! \brief Character class bitmasks indexed by the low nibble. */
+#define DEC_LUT_LO	0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, \
+			0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+/*! \brief Character class bitmasks indexed by the high nibble. */
+#define DEC_LUT_HI	0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, \
+			0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+/*! \brief Offsets from a character to its 6-bit value, indexed by the high nibble. */
+#define DEC_LUT_ROLL	0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+/*! \brief Moves three decoded bytes from each 32-bit word to the front. */
+#define DEC_SHUF	2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+__attribute__((target("ssse3")))
+static size_t encode_ssse3(const uint8_t *in, size_t in_len, uint8_t *out)
+{
+	const __m128i shuf = _mm_setr_epi8(ENC_SHUF);
+	const __m128i lut = _mm_setr_epi8(ENC_LUT);
+	const __m128i mask_ac = _mm_set1_epi32(0x0FC0FC00);
+	const __m128i mul_ac = _mm_set1_epi32(0x04000040);
+	const __m128i mask_bd = _mm_set1_epi32(0x003F03F0);
+	const __m128i mul_bd = _mm_set1_epi32(0x01000010);
+
+	size_t done = 0;
+
+	// Each step reads 16 bytes but consumes only 12 of them.
+	while (in_len - done >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(in + done));
+		v = _mm_shuffle_epi8(v, shuf);
+
+		__m128i idx = _mm_or_si128(
+			_mm_mulhi_epu16(_mm_and_si128(v, mask_ac), mul_ac),
+			_mm_mullo_epi16(_mm_and_si128(v, mask_bd), mul_bd));
+
+		__m128i cls = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+		__m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+		cls = _mm_or_si128(cls, _mm_and_si128(upper, _mm_set1_epi8(13)));
+		v = _mm_add_epi8(idx, _mm_shuffle_epi8(lut, cls));
+
+		_mm_storeu_si128((__m128i *)out, v);
+		out += 16;
+		done += 12;
+	}
+
+	return done;
+}
+
+__attribute__((target("avx2")))
+static size_t encode_avx2(const uint8_t *in, size_t in_len, uint8_t *out)
+{
+	const __m256i shuf = _mm256_setr_epi8(ENC_SHUF, ENC_SHUF);
+	const __m256i lut = _mm256_setr_epi8(ENC_LUT, ENC_LUT);
+	const __m256i mask_ac = _mm256_set1_epi32(0x0FC0FC00);
+	const __m256i mul_ac = _mm256_set1_epi32(0x04000040);
+	const __m256i mask_bd = _mm256_set1_epi32(0x003F03F0);
+	const __m256i mul_bd = _mm256_set1_epi32(0x01000010);
+
+	size_t done = 0;
+
+	// Each step reads 12 + 16 bytes but consumes only 24 of them.
+	while (in_len - done >= 28) {
+		__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(
+			_mm_loadu_si128((const __m128i *)(in + done))),
+			_mm_loadu_si128((const __m128i *)(in + done + 12)), 1);
+		v = _mm256_shuffle_epi8(v, shuf);
+
+		__m256i idx = _mm256_or_si256(
+			_mm256_mulhi_epu16(_mm256_and_si256(v, mask_ac), mul_ac),
+			_mm256_mullo_epi16(_mm256_and_si256(v, mask_bd), mul_bd));
+
+		__m256i cls = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+		__m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+		cls = _mm256_or_si256(cls, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+		v = _mm256_add_epi8(idx, _mm256_shuffle_epi8(lut, cls));
+
+		_mm256_storeu_si256((__m256i *)out, v);
+		out += 32;
+		done += 24;
+	}
+
+	return done + encode_ssse3(in + done, in_len - done, out);
+}
+
+__attribute__((target("ssse3")))
+static size_t decode_ssse3(const uint8_t *in, size_t in_len, uint8_t *out)
+{
+	const __m128i lut_lo = _mm_setr_epi8(DEC_LUT_LO);
+	const __m128i lut_hi = _mm_setr_epi8(DEC_LUT_HI);
+	const __m128i lut_roll = _mm_setr_epi8(DEC_LUT_ROLL);
+	const __m128i shuf = _mm_setr_epi8(DEC_SHUF);
+	const __m128i mask_2f = _mm_set1_epi8(0x2F);
+	const __m128i pack_ab = _mm_set1_epi32(0x01400140);
+	const __m128i pack_abcd = _mm_set1_epi32(0x00011000);
+
+	size_t done = 0;
+
+	// Each step writes 16 bytes but produces only 12 of them. The last
+	// quantum, which can contain padding, is always left to the caller.
+	while (in_len - done >= 24) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(in + done));
+
+		__m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), mask_2f);
+		__m128i lo_nibbles = _mm_and_si128(v, mask_2f);
+		__m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+		__m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+
+		// Stop at any invalid character, the caller reports it.
+		__m128i bad = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+		if (_mm_movemask_epi8(bad) != 0xFFFF) {
+			break;
+		}
+
+		__m128i eq_2f = _mm_cmpeq_epi8(v, mask_2f);
+		__m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+		v = _mm_add_epi8(v, roll);
+
+		v = _mm_maddubs_epi16(v, pack_ab);
+		v = _mm_madd_epi16(v, pack_abcd);
+		v = _mm_shuffle_epi8(v, shuf);
+
+		_mm_storeu_si128((__m128i *)out, v);
+		out += 12;
+		done += 16;
+	}
+
+	return done;
+}
+
+__attribute__((target("avx2")))
+static size_t decode_avx2(const uint8_t *in, size_t in_len, uint8_t *out)
+{
+	const __m256i lut_lo = _mm256_setr_epi8(DEC_LUT_LO, DEC_LUT_LO);
+	const __m256i lut_hi = _mm256_setr_epi8(DEC_LUT_HI, DEC_LUT_HI);
+	const __m256i lut_roll = _mm256_setr_epi8(DEC_LUT_ROLL, DEC_LUT_ROLL);
+	const __m256i shuf = _mm256_setr_epi8(DEC_SHUF, DEC_SHUF);
+	const __m256i perm = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+	const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+	const __m256i pack_ab = _mm256_set1_epi32(0x01400140);
+	const __m256i pack_abcd = _mm256_set1_epi32(0x00011000);
+
+	size_t done = 0;
+
+	// Each step writes 32 bytes but produces only 24 of them.
+	while (in_len - done >= 48) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(in + done));
+
+		__m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), mask_2f);
+		__m256i lo_nibbles = _mm256_and_si256(v, mask_2f);
+		__m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+		__m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+
+		__m256i bad = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+		if ((uint32_t)_mm256_movemask_epi8(bad) != UINT32_MAX) {
+			break;
+		}
+
+		__m256i eq_2f = _mm256_cmpeq_epi8(v, mask_2f);
+		__m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+		v = _mm256_add_epi8(v, roll);
+
+		v = _mm256_maddubs_epi16(v, pack_ab);
+		v = _mm256_madd_epi16(v, pack_abcd);
+		v = _mm256_shuffle_epi8(v, shuf);
+		v = _mm256_permutevar8x32_epi32(v, perm);
+
+		_mm256_storeu_si256((__m256i *)out, v);
+		out += 24;
+		done += 32;
+	}
+
+	return done + decode_ssse3(in + done, in_len - done, out);
+}
+#endif
+
+/*!
+ * \brief Encodes a prefix of the input using vector instructions if available.
+ *
+ * \return Number of consumed input bytes (multiple of 3).
+ */
+static size_t encode_vector(const uint8_t *in, size_t in_len, uint8_t *out)
+{
+#ifdef HAVE_X86_SIMD
+	switch (simd_level()) {
+	case SIMD_AVX2:
+		return encode_avx2(in, in_len, out);
+	case SIMD_SSSE3:
+		return encode_ssse3(in, in_len, out);
+	default:
+		break;
+	}
+#endif
+	return 0;
+}
+
+/*!
+ * \brief Decodes a prefix of the input using vector instructions if available.
+ *
+ * The last quantum is never processed. Decoding stops before a block with
+ * an invalid character.
+ *
+ * \return Number of consumed input characters (multiple of 4).
+ */
+static size_t decode_vector(const uint8_t *in, size_t in_len, uint8_t *out)
+{
+#ifdef HAVE_X86_SIMD
+	switch (simd_level()) {
+	case SIMD_AVX2:
+		return decode_avx2(in, in_len, out);
+	case SIMD_SSSE3:
+		return decode_ssse3(in, in_len, out);
+	default:
+		break;
+	}
+#endif
+	return 0;
+}
+
 int32_t base64_encode(const uint8_t  *in,
                       const uint32_t in_len,
                       uint8_t        *out,
@@ -98,6 +375,11 @@ int32_t base64_encode(const uint8_t  *in,
 	const uint8_t	*stop = in + in_len - rest_len;
 	uint8_t		*text = out;
 
+	// Bulk encoding of the leading blocks.
+	size_t done = encode_vector(in, in_len, text);
+	in += done;
+	text += (done / 3) * 4;
+
 	// Encoding loop takes 3 bytes and creates 4 characters.
 	while (in < stop) {
 		text[0] = base64_enc[in[0] >> 2];
@@ -176,71 +458,81 @@ int32_t base64_decode(const uint8_t  *in,
 		return KNOT_BASE64_ESIZE;
 	}
 
-	const uint8_t	*stop = in + in_len;
+	if (in_len == 0) {
+		return 0;
+	}
+
+	const uint8_t	*last = in + in_len - 4;
 	uint8_t		*bin = out;
 	uint8_t		pad_len = 0;
 	uint8_t		c1, c2, c3, c4;
 
-	// Decoding loop takes 4 characters and creates 3 bytes.
-	while (in < stop) {
-		// Filling and transforming 4 Base64 chars.
+	// Bulk decoding of the leading blocks.
+	size_t done = decode_vector(in, in_len, bin);
+	in += done;
+	bin += (done / 4) * 3;
+
+	// Decoding loop takes 4 characters and creates 3 bytes (no padding).
+	while (in < last) {
 		c1 = base64_dec[in[0]];
 		c2 = base64_dec[in[1]];
 		c3 = base64_dec[in[2]];
 		c4 = base64_dec[in[3]];
 
-		// Check 4. char if is bad or padding.
-		if (c4 >= PD) {
-			if (c4 == PD && pad_len == 0) {
-				pad_len = 1;
-			} else {
-				return KNOT_BASE64_ECHAR;
-			}
+		// Both bad and padding characters have some of the upper bits set.
+		if ((c1 | c2 | c3 | c4) >= PD) {
+			return KNOT_BASE64_ECHAR;
 		}
 
-		// Check 3. char if is bad or padding.
-		if (c3 >= PD) {
-			if (c3 == PD && pad_len == 1) {
-				pad_len = 2;
-			} else {
-				return KNOT_BASE64_ECHAR;
-			}
-		}
+		bin[0] = (c1 << 2) + (c2 >> 4);
+		bin[1] = (c2 << 4) + (c3 >> 2);
+		bin[2] = (c3 << 6) + c4;
+		bin += 3;
+		in += 4;
+	}
 
-		// Check 1. and 2. chars if are not padding.
-		if (c2 >= PD || c1 >= PD) {
+	// Filling and transforming the last 4 Base64 chars.
+	c1 = base64_dec[in[0]];
+	c2 = base64_dec[in[1]];
+	c3 = base64_dec[in[2]];
+	c4 = base64_dec[in[3]];
+
+	// Check 4. char if is bad or padding.
+	if (c4 >= PD) {
+		if (c4 == PD) {
+			pad_len = 1;
+		} else {
 			return KNOT_BASE64_ECHAR;
 		}
+	}
 
-		// Computing of output data based on padding length.
-		switch (pad_len) {
-		case 0:
-			bin[2] = (c3 << 6) + c4;
-			// FALLTHROUGH
-		case 1:
-			bin[1] = (c2 << 4) + (c3 >> 2);
-			// FALLTHROUGH
-		case 2:
-			bin[0] = (c1 << 2) + (c2 >> 4);
+	// Check 3. char if is bad or padding.
+	if (c3 >= PD) {
+		if (c3 == PD && pad_len == 1) {
+			pad_len = 2;
+		} else {
+			return KNOT_BASE64_ECHAR;
 		}
+	}
 
-		// Update output end.
-		switch (pad_len) {
-		case 0:
-			bin += 3;
-			break;
-		case 1:
-			bin += 2;
-			break;
-		case 2:
-			bin += 1;
-			break;
-		}
+	// Check 1. and 2. chars if are not padding.
+	if (c2 >= PD || c1 >= PD) {
+		return KNOT_BASE64_ECHAR;
+	}
 
-		in += 4;
+	// Computing of output data based on padding length.
+	switch (pad_len) {
+	case 0:
+		bin[2] = (c3 << 6) + c4;
+		// FALLTHROUGH
+	case 1:
+		bin[1] = (c2 << 4) + (c3 >> 2);
+		// FALLTHROUGH
+	case 2:
+		bin[0] = (c1 << 2) + (c2 >> 4);
 	}
 
-	return (bin - out);
+	return (bin - out) + (3 - pad_len);
 }
 
 int32_t base64_decode_alloc(const uint8_t  *in,
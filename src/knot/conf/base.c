@@ -29,6 +29,7 @@
 #include "contrib/files.h"
 #include "contrib/sockaddr.h"
 #include "contrib/string.h"
+#include "contrib/wire_ctx.h"
 
 // The active configuration.
 conf_t *s_conf;
@@ -91,6 +92,47 @@ int conf_refresh_txn(
 	return conf->api->txn_begin(conf->db, &conf->read_txn, KNOT_DB_RDONLY);
 }
 
+static void init_cache_nsid(
+	conf_t *conf)
+{
+	free(conf->cache.srv_nsid_opt);
+	conf->cache.srv_nsid_opt = NULL;
+	conf->cache.srv_nsid_opt_len = 0;
+
+	// Use the hostname if NSID is not configured, empty NSID disables it.
+	const uint8_t *data;
+	size_t len;
+	conf_val_t val = conf_get(conf, C_SRV, C_NSID);
+	if (val.code == KNOT_EOK) {
+		data = conf_bin(&val, &len);
+		if (len == 0) {
+			return;
+		}
+	} else if (conf->hostname != NULL) {
+		data = (const uint8_t *)conf->hostname;
+		len = strlen(conf->hostname);
+	} else {
+		return;
+	}
+	if (len > UINT16_MAX - KNOT_EDNS_OPTION_HDRLEN) {
+		return;
+	}
+
+	// Prebuild the whole option, it's copied into the responses as is.
+	size_t opt_len = KNOT_EDNS_OPTION_HDRLEN + len;
+	uint8_t *opt = malloc(opt_len);
+	if (opt == NULL) {
+		return;
+	}
+	wire_ctx_t wire = wire_ctx_init(opt, opt_len);
+	wire_ctx_write_u16(&wire, KNOT_EDNS_OPTION_NSID);
+	wire_ctx_write_u16(&wire, len);
+	wire_ctx_write(&wire, data, len);
+
+	conf->cache.srv_nsid_opt = opt;
+	conf->cache.srv_nsid_opt_len = opt_len;
+}
+
 void conf_refresh_hostname(
 	conf_t *conf)
 {
@@ -104,6 +146,9 @@ void conf_refresh_hostname(
 		// Empty hostname fallback, NULL cannot be passed to strlen!
 		conf->hostname = strdup("");
 	}
+
+	// The hostname is the default NSID.
+	init_cache_nsid(conf);
 }
 
 static void init_cache(
@@ -167,7 +212,7 @@ static void init_cache(
 	val = conf_get(conf, C_CTL, C_TIMEOUT);
 	conf->cache.ctl_timeout = conf_int(&val) * 1000;
 
-	conf->cache.srv_nsid = conf_get(conf, C_SRV, C_NSID);
+	init_cache_nsid(conf);
 
 	val = conf_get(conf, C_SRV, C_ECS);
 	conf->cache.srv_ecs = conf_bool(&val);
@@ -414,6 +459,7 @@ void conf_free(
 	yp_schema_free(conf->schema);
 	free(conf->filename);
 	free(conf->hostname);
+	free(conf->cache.srv_nsid_opt);
 	if (conf->api != NULL) {
 		conf->api->txn_abort(&conf->read_txn);
 	}
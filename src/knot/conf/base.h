@@ -116,7 +116,8 @@ typedef struct {
 		size_t srv_bg_threads;
 		size_t srv_max_tcp_clients;
 		int ctl_timeout;
-		conf_val_t srv_nsid;
+		uint8_t *srv_nsid_opt;    /*!< Prebuilt response NSID option (or NULL). */
+		uint16_t srv_nsid_opt_len;
 		bool srv_ecs;
 		bool srv_ans_rotate;
 	} cache;
@@ -785,47 +785,12 @@ get_error:
 	return ret;
 }
 
-static void upd_changes(
-	const conf_io_t *io,
+static void upd_zone_change(
+	const uint8_t *id,
+	size_t id_len,
 	conf_io_type_t type,
-	yp_flag_t flags,
-	bool any_id)
+	yp_flag_t flags)
 {
-	// Update common flags.
-	conf()->io.flags |= flags;
-
-	// Return if not important change.
-	if (type == CONF_IO_TNONE) {
-		return;
-	}
-
-	// Update reference item.
-	if (flags & CONF_IO_FREF) {
-		// Expected an identifier, which cannot be changed.
-		assert(type != CONF_IO_TCHANGE);
-
-		// Re-check and reload all zones if a reference has been removed.
-		if (type == CONF_IO_TUNSET) {
-			conf()->io.flags |= CONF_IO_FCHECK_ZONES | CONF_IO_FRLD_ZONES;
-		}
-		return;
-	// Return if no specific zone operation.
-	} else if (!(flags & CONF_IO_FZONE)) {
-		return;
-	}
-
-	// Don't process each zone individually, process all instead.
-	if (any_id) {
-		// Diff all zone changes.
-		conf()->io.flags |= CONF_IO_FCHECK_ZONES | CONF_IO_FDIFF_ZONES;
-
-		// Reload just with important changes.
-		if (flags & CONF_IO_FRLD_ZONE) {
-			conf()->io.flags |= CONF_IO_FRLD_ZONES;
-		}
-		return;
-	}
-
 	// Prepare zone changes storage if it doesn't exist.
 	trie_t *zones = conf()->io.zones;
 	if (zones == NULL) {
@@ -837,7 +802,7 @@ static void upd_changes(
 	}
 
 	// Get zone status or create new.
-	trie_val_t *val = trie_get_ins(zones, io->id, io->id_len);
+	trie_val_t *val = trie_get_ins(zones, id, id_len);
 	conf_io_type_t *current = (conf_io_type_t *)val;
 
 	switch (type) {
@@ -855,7 +820,7 @@ static void upd_changes(
 	case CONF_IO_TUNSET:
 		if (*current & CONF_IO_TSET) {
 			// Remove inserted zone -> no change.
-			trie_del(zones, io->id, io->id_len, NULL);
+			trie_del(zones, id, id_len, NULL);
 		} else {
 			// Remove existing zone.
 			*current |= type;
@@ -874,6 +839,113 @@ static void upd_changes(
 	}
 }
 
+static void upd_tpl_changes(
+	const conf_io_t *io,
+	yp_flag_t flags,
+	bool any_id)
+{
+	// Diff all zone changes if all templates changed.
+	if (any_id) {
+		conf()->io.flags |= CONF_IO_FCHECK_ZONES | CONF_IO_FDIFF_ZONES;
+
+		// Reload just with important changes.
+		if (flags & CONF_IO_FRLD_ZONE) {
+			conf()->io.flags |= CONF_IO_FRLD_ZONES;
+		}
+		return;
+	}
+
+	bool is_default = (io->id_len == CONF_DEFAULT_ID[0] &&
+	                   memcmp(io->id, CONF_DEFAULT_ID + 1, io->id_len) == 0);
+
+	conf_iter_t iter;
+	int ret = conf_db_iter_begin(conf(), conf()->io.txn, C_ZONE, &iter);
+	while (ret == KNOT_EOK) {
+		const uint8_t *id;
+		size_t id_len;
+		ret = conf_db_iter_id(conf(), &iter, &id, &id_len);
+		if (ret != KNOT_EOK) {
+			conf_db_iter_finish(conf(), &iter);
+			break;
+		}
+
+		// Mark the zones using the changed template.
+		conf_val_t val;
+		conf_db_get(conf(), conf()->io.txn, C_ZONE, C_TPL, id, id_len, &val);
+		bool match = false;
+		if (val.code == KNOT_EOK) {
+			conf_val(&val);
+			match = (val.len == io->id_len &&
+			         memcmp(val.data, io->id, val.len) == 0);
+		} else {
+			match = is_default;
+		}
+		if (match) {
+			upd_zone_change(id, id_len, CONF_IO_TCHANGE, flags);
+		}
+
+		ret = conf_db_iter_next(conf(), &iter);
+	}
+
+	// Check and diff all zones if the zones couldn't be listed.
+	if (ret != KNOT_EOF && ret != KNOT_ENOENT) {
+		conf()->io.flags |= CONF_IO_FCHECK_ZONES | CONF_IO_FDIFF_ZONES;
+		if (flags & CONF_IO_FRLD_ZONE) {
+			conf()->io.flags |= CONF_IO_FRLD_ZONES;
+		}
+	}
+}
+
+static void upd_changes(
+	const conf_io_t *io,
+	conf_io_type_t type,
+	yp_flag_t flags,
+	bool any_id)
+{
+	// Update common flags.
+	conf()->io.flags |= flags;
+
+	// Return if not important change.
+	if (type == CONF_IO_TNONE) {
+		return;
+	}
+
+	// Update zones using a changed or added template.
+	if ((flags & CONF_IO_FTPL) && type != CONF_IO_TUNSET) {
+		upd_tpl_changes(io, flags, any_id);
+		return;
+	}
+
+	// Update reference item.
+	if (flags & CONF_IO_FREF) {
+		// Expected an identifier, which cannot be changed.
+		assert(type != CONF_IO_TCHANGE);
+
+		// Re-check and reload all zones if a reference has been removed.
+		if (type == CONF_IO_TUNSET) {
+			conf()->io.flags |= CONF_IO_FCHECK_ZONES | CONF_IO_FRLD_ZONES;
+		}
+		return;
+	// Return if no specific zone operation.
+	} else if (!(flags & CONF_IO_FZONE)) {
+		return;
+	}
+
+	// Don't process each zone individually, process all instead.
+	if (any_id) {
+		// Diff all zone changes.
+		conf()->io.flags |= CONF_IO_FCHECK_ZONES | CONF_IO_FDIFF_ZONES;
+
+		// Reload just with important changes.
+		if (flags & CONF_IO_FRLD_ZONE) {
+			conf()->io.flags |= CONF_IO_FRLD_ZONES;
+		}
+		return;
+	}
+
+	upd_zone_change(io->id, io->id_len, type, flags);
+}
+
 static int set_item(
 	conf_io_t *io)
 {
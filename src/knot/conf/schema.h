@@ -41,6 +41,7 @@
 #define C_DNSKEY_TTL		"\x0A""dnskey-ttl"
 #define C_DNSSEC_POLICY		"\x0D""dnssec-policy"
 #define C_DNSSEC_SIGNING	"\x0E""dnssec-signing"
+#define C_DNSSEC_VALIDATION	"\x11""dnssec-validation"
 #define C_DOMAIN		"\x06""domain"
 #define C_DS_PUSH		"\x07""ds-push"
 #define C_ECS			"\x12""edns-client-subnet"
@@ -88,6 +89,9 @@
 #define C_POLICY		"\x06""policy"
 #define C_PROPAG_DELAY		"\x11""propagation-delay"
 #define C_RMT			"\x06""remote"
+#define C_RRSIG_BATCH		"\x0B""rrsig-batch"
+#define C_RRSIG_BATCH_INTERVAL	"\x14""rrsig-batch-interval"
+#define C_RRSIG_JITTER		"\x0C""rrsig-jitter"
 #define C_RRSIG_LIFETIME	"\x0E""rrsig-lifetime"
 #define C_RRSIG_PREREFRESH	"\x11""rrsig-pre-refresh"
 #define C_RRSIG_REFRESH		"\x0D""rrsig-refresh"
@@ -285,6 +285,12 @@ int check_policy(
 	                                    C_RRSIG_REFRESH, args->id, args->id_len);
 	conf_val_t prerefresh = conf_rawid_get_txn(args->extra->conf, args->extra->txn, C_POLICY,
 	                                    C_RRSIG_PREREFRESH, args->id, args->id_len);
+	conf_val_t jitter = conf_rawid_get_txn(args->extra->conf, args->extra->txn, C_POLICY,
+	                                    C_RRSIG_JITTER, args->id, args->id_len);
+	conf_val_t batch = conf_rawid_get_txn(args->extra->conf, args->extra->txn, C_POLICY,
+	                                    C_RRSIG_BATCH, args->id, args->id_len);
+	conf_val_t batch_ival = conf_rawid_get_txn(args->extra->conf, args->extra->txn, C_POLICY,
+	                                    C_RRSIG_BATCH_INTERVAL, args->id, args->id_len);
 	conf_val_t prop_del = conf_rawid_get_txn(args->extra->conf, args->extra->txn, C_POLICY,
 						 C_PROPAG_DELAY, args->id, args->id_len);
 	conf_val_t zsk_life = conf_rawid_get_txn(args->extra->conf, args->extra->txn, C_POLICY,
@@ -322,6 +328,19 @@ int check_policy(
 		return KNOT_EINVAL;
 	}
 
+	int64_t jitter_val = conf_int(&jitter);
+	if (lifetime_val <= refresh_val + preref_val + jitter_val) {
+		args->err_str = "RRSIG refresh + pre-refresh + jitter has to be lower than RRSIG lifetime";
+		return KNOT_EINVAL;
+	}
+
+	int64_t batch_val = conf_int(&batch);
+	int64_t batch_ival_val = conf_int(&batch_ival);
+	if (batch_val > 0 && batch_ival_val >= refresh_val) {
+		args->err_str = "RRSIG batch interval has to be lower than RRSIG refresh";
+		return KNOT_EINVAL;
+	}
+
 	bool sts_val = conf_bool(&sts);
 	int64_t prop_del_val = conf_int(&prop_del);
 	int64_t zsk_life_val = conf_int(&zsk_life);
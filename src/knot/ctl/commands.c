@@ -35,7 +35,9 @@
 #include "contrib/macros.h"
 #include "contrib/mempattern.h"
 #include "contrib/string.h"
+#include "contrib/time.h"
 #include "contrib/ucw/lists.h"
+#include "contrib/wire_ctx.h"
 #include "libzscanner/scanner.h"
 #include "contrib/strtonum.h"
 
@@ -511,9 +513,13 @@ static int zone_txn_abort(zone_t *zone, ctl_args_t *args)
 	return KNOT_EOK;
 }
 
+/*! Export frame size, the maximum control item length. */
+#define EXPORT_FRAME_SIZE	65535
+
 typedef struct {
 	ctl_args_t *args;
 	int type_filter; // -1: no specific type, [0, 2^16]: specific type.
+	bool binary;     // Wire format records in binary frames.
 	knot_dump_style_t style;
 	knot_ctl_data_t data;
 	knot_dname_txt_storage_t zone;
@@ -521,6 +527,8 @@ typedef struct {
 	char ttl[16];
 	char type[32];
 	char rdata[2 * 65536];
+	size_t frame_len;
+	uint8_t frame[EXPORT_FRAME_SIZE];
 } send_ctx_t;
 
 static int create_send_ctx(send_ctx_t **out, const knot_dname_t *zone_name,
@@ -532,6 +540,7 @@ static int create_send_ctx(send_ctx_t **out, const knot_dname_t *zone_name,
 	}
 
 	ctx->args = args;
+	ctx->binary = (ctl_str_to_cmd(args->data[KNOT_CTL_IDX_CMD]) == CTL_ZONE_EXPORT);
 
 	// Set the dump style.
 	ctx->style.show_ttl = true;
@@ -540,10 +549,14 @@ static int create_send_ctx(send_ctx_t **out, const knot_dname_t *zone_name,
 
 	// Set the output data buffers.
 	ctx->data[KNOT_CTL_IDX_ZONE]  = ctx->zone;
-	ctx->data[KNOT_CTL_IDX_OWNER] = ctx->owner;
-	ctx->data[KNOT_CTL_IDX_TTL]   = ctx->ttl;
-	ctx->data[KNOT_CTL_IDX_TYPE]  = ctx->type;
-	ctx->data[KNOT_CTL_IDX_DATA]  = ctx->rdata;
+	if (ctx->binary) {
+		ctx->data[KNOT_CTL_IDX_DATA]  = (const char *)ctx->frame;
+	} else {
+		ctx->data[KNOT_CTL_IDX_DATA]  = ctx->rdata;
+		ctx->data[KNOT_CTL_IDX_OWNER] = ctx->owner;
+		ctx->data[KNOT_CTL_IDX_TTL]   = ctx->ttl;
+		ctx->data[KNOT_CTL_IDX_TYPE]  = ctx->type;
+	}
 
 	// Set the ZONE.
 	if (knot_dname_to_str(ctx->zone, zone_name, sizeof(ctx->zone)) == NULL) {
@@ -605,10 +618,78 @@ static int send_rrset(knot_rrset_t *rrset, send_ctx_t *ctx)
 	return KNOT_EOK;
 }
 
+static int flush_frame(send_ctx_t *ctx)
+{
+	if (ctx->frame_len == 0) {
+		return KNOT_EOK;
+	}
+
+	size_t len = ctx->frame_len;
+	ctx->frame_len = 0;
+
+	return knot_ctl_send_binary(ctx->args->ctl, KNOT_CTL_TYPE_DATA, &ctx->data,
+	                            KNOT_CTL_IDX_DATA, len);
+}
+
+static int write_frame(send_ctx_t *ctx, const uint8_t *data, size_t data_len)
+{
+	// Records can span multiple frames.
+	while (data_len > 0) {
+		size_t chunk = MIN(data_len, sizeof(ctx->frame) - ctx->frame_len);
+		memcpy(ctx->frame + ctx->frame_len, data, chunk);
+		ctx->frame_len += chunk;
+		data += chunk;
+		data_len -= chunk;
+
+		if (ctx->frame_len == sizeof(ctx->frame)) {
+			int ret = flush_frame(ctx);
+			if (ret != KNOT_EOK) {
+				return ret;
+			}
+		}
+	}
+
+	return KNOT_EOK;
+}
+
+static int export_rrset(knot_rrset_t *rrset, send_ctx_t *ctx)
+{
+	uint8_t header[KNOT_DNAME_MAXLEN + 10];
+
+	int owner_len = knot_dname_to_wire(header, rrset->owner, KNOT_DNAME_MAXLEN);
+	if (owner_len < 0) {
+		return owner_len;
+	}
+
+	knot_rdata_t *rr = rrset->rrs.rdata;
+	for (size_t i = 0; i < rrset->rrs.count; ++i) {
+		// Uncompressed RR in the wire format.
+		wire_ctx_t w = wire_ctx_init(header + owner_len, 10);
+		wire_ctx_write_u16(&w, rrset->type);
+		wire_ctx_write_u16(&w, rrset->rclass);
+		wire_ctx_write_u32(&w, rrset->ttl);
+		wire_ctx_write_u16(&w, rr->len);
+		assert(w.error == KNOT_EOK);
+
+		int ret = write_frame(ctx, header, owner_len + 10);
+		if (ret == KNOT_EOK) {
+			ret = write_frame(ctx, rr->data, rr->len);
+		}
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+
+		rr = knot_rdataset_next(rr);
+	}
+
+	return KNOT_EOK;
+}
+
 static int send_node(zone_node_t *node, void *ctx_void)
 {
 	send_ctx_t *ctx = ctx_void;
-	if (knot_dname_to_str(ctx->owner, node->owner, sizeof(ctx->owner)) == NULL) {
+	if (!ctx->binary &&
+	    knot_dname_to_str(ctx->owner, node->owner, sizeof(ctx->owner)) == NULL) {
 		return KNOT_EINVAL;
 	}
 
@@ -620,7 +701,8 @@ static int send_node(zone_node_t *node, void *ctx_void)
 			continue;
 		}
 
-		int ret = send_rrset(&rrset, ctx);
+		int ret = ctx->binary ? export_rrset(&rrset, ctx) :
+		                        send_rrset(&rrset, ctx);
 		if (ret != KNOT_EOK) {
 			return ret;
 		}
@@ -701,6 +783,11 @@ static int zone_read(zone_t *zone, ctl_args_t *args)
 		}
 	}
 
+	// Send the last incomplete frame.
+	if (ret == KNOT_EOK && ctx->binary) {
+		ret = flush_frame(ctx);
+	}
+
 zone_read_failed:
 	mm_free(&args->mm, ctx);
 
@@ -1334,6 +1421,7 @@ static int ctl_zone(ctl_args_t *args, ctl_cmd_t cmd)
 	case CTL_ZONE_THAW:
 		return zones_apply(args, zone_thaw);
 	case CTL_ZONE_READ:
+	case CTL_ZONE_EXPORT:
 		return zones_apply(args, zone_read);
 	case CTL_ZONE_BEGIN:
 		return zones_apply(args, zone_txn_begin);
@@ -1745,6 +1833,119 @@ static int ctl_conf_modify(ctl_args_t *args, ctl_cmd_t cmd)
 	return ret;
 }
 
+static int conf_zone_modify(ctl_args_t *args, ctl_cmd_t cmd, size_t *count)
+{
+	int ret = KNOT_EOK;
+
+	while (true) {
+		const char *zone = args->data[KNOT_CTL_IDX_ZONE];
+		const char *tpl  = args->data[KNOT_CTL_IDX_DATA];
+
+		if (zone == NULL) {
+			ret = KNOT_EINVAL;
+		} else if (cmd == CTL_CONF_ZONE_ADD) {
+			ret = conf_io_set(C_ZONE + 1, C_DOMAIN + 1, NULL, zone);
+			if (ret == KNOT_EOK && tpl != NULL) {
+				ret = conf_io_set(C_ZONE + 1, C_TPL + 1, zone, tpl);
+			}
+		} else {
+			ret = conf_io_unset(C_ZONE + 1, NULL, zone, NULL);
+		}
+		if (ret != KNOT_EOK) {
+			send_error(args, knot_strerror(ret));
+			break;
+		}
+		(*count)++;
+
+		// Get next data unit.
+		ret = knot_ctl_receive(args->ctl, &args->type, &args->data);
+		if (ret != KNOT_EOK || args->type != KNOT_CTL_TYPE_DATA) {
+			break;
+		}
+		ctl_log_data(&args->data);
+	}
+
+	return ret;
+}
+
+static int ctl_conf_zone(ctl_args_t *args, ctl_cmd_t cmd)
+{
+	conf_io_t io = {
+		.fcn = send_block,
+		.misc = args->ctl
+	};
+
+	// Use the open transaction if any, otherwise process the whole batch.
+	bool batch = (conf()->io.txn == NULL);
+
+	struct timespec t_begin = time_now();
+
+	int ret = conf_io_begin(!batch);
+	if (ret != KNOT_EOK) {
+		send_error(args, knot_strerror(ret));
+		return ret;
+	}
+
+	size_t count = 0;
+	ret = conf_zone_modify(args, cmd, &count);
+	if (ret != KNOT_EOK) {
+		conf_io_abort(!batch);
+		return ret;
+	}
+
+	struct timespec t_write = time_now();
+	struct timespec t_check = t_write;
+
+	if (batch) {
+		ret = conf_io_check(&io);
+		if (ret != KNOT_EOK) {
+			conf_io_abort(false);
+			// A semantic error is already sent by the check function.
+			if (io.error.code == KNOT_EOK) {
+				send_error(args, knot_strerror(ret));
+			}
+			return ret;
+		}
+		t_check = time_now();
+	}
+
+	ret = conf_io_commit(!batch);
+	if (ret != KNOT_EOK) {
+		conf_io_abort(!batch);
+		send_error(args, knot_strerror(ret));
+		return ret;
+	}
+
+	if (batch) {
+		ret = server_reload(args->server);
+		if (ret != KNOT_EOK) {
+			send_error(args, knot_strerror(ret));
+			return ret;
+		}
+	}
+
+	struct timespec t_end = time_now();
+
+	char buff[128];
+	ret = snprintf(buff, sizeof(buff), "%s %zu zones, write %.0f ms, "
+	               "check %.0f ms, reload %.0f ms",
+	               (cmd == CTL_CONF_ZONE_ADD) ? "added" : "removed", count,
+	               time_diff_ms(&t_begin, &t_write),
+	               time_diff_ms(&t_write, &t_check),
+	               time_diff_ms(&t_check, &t_end));
+	if (ret <= 0 || (size_t)ret >= sizeof(buff)) {
+		return KNOT_ESPACE;
+	}
+
+	log_ctl_info("control, %s", buff);
+
+	knot_ctl_data_t data = {
+		[KNOT_CTL_IDX_DATA] = buff
+	};
+
+	return knot_ctl_send(args->ctl, KNOT_CTL_TYPE_DATA, &data);
+}
+
 typedef struct {
 	const char *name;
 	int (*fcn)(ctl_args_t *, ctl_cmd_t);
@@ -1771,6 +1972,7 @@ static const desc_t cmd_table[] = {
 	[CTL_ZONE_THAW]       = { "zone-thaw",          ctl_zone },
 
 	[CTL_ZONE_READ]       = { "zone-read",       ctl_zone },
+	[CTL_ZONE_EXPORT]     = { "zone-export",     ctl_zone },
 	[CTL_ZONE_BEGIN]      = { "zone-begin",      ctl_zone },
 	[CTL_ZONE_COMMIT]     = { "zone-commit",     ctl_zone },
 	[CTL_ZONE_ABORT]      = { "zone-abort",      ctl_zone },
@@ -1790,6 +1992,8 @@ static const desc_t cmd_table[] = {
 	[CTL_CONF_GET]        = { "conf-get",        ctl_conf_read },
 	[CTL_CONF_SET]        = { "conf-set",        ctl_conf_modify },
 	[CTL_CONF_UNSET]      = { "conf-unset",      ctl_conf_modify },
+	[CTL_CONF_ZONE_ADD]   = { "conf-zone-add",   ctl_conf_zone },
+	[CTL_CONF_ZONE_REMOVE] = { "conf-zone-remove", ctl_conf_zone },
 };
 
 #define MAX_CTL_CODE (sizeof(cmd_table) / sizeof(desc_t) - 1)
@@ -1818,6 +2022,23 @@ ctl_cmd_t ctl_str_to_cmd(const char *cmd_str)
 	return CTL_NONE;
 }
 
+bool ctl_cmd_readonly(ctl_cmd_t cmd)
+{
+	switch (cmd) {
+	case CTL_STATUS:
+	case CTL_STATS:
+	case CTL_ZONE_STATUS:
+	case CTL_ZONE_READ:
+	case CTL_ZONE_EXPORT:
+	case CTL_ZONE_DIFF:
+	case CTL_ZONE_GET:
+	case CTL_ZONE_STATS:
+		return true;
+	default:
+		return false;
+	}
+}
+
 int ctl_exec(ctl_cmd_t cmd, ctl_args_t *args)
 {
 	if (args == NULL) {
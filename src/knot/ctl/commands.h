@@ -61,6 +61,7 @@ typedef enum {
 	CTL_ZONE_THAW,
 
 	CTL_ZONE_READ,
+	CTL_ZONE_EXPORT,
 	CTL_ZONE_BEGIN,
 	CTL_ZONE_COMMIT,
 	CTL_ZONE_ABORT,
@@ -80,6 +81,8 @@ typedef enum {
 	CTL_CONF_GET,
 	CTL_CONF_SET,
 	CTL_CONF_UNSET,
+	CTL_CONF_ZONE_ADD,
+	CTL_CONF_ZONE_REMOVE,
 } ctl_cmd_t;
 
 /*! Control command parameters. */
@@ -109,6 +112,19 @@ const char *ctl_cmd_to_str(ctl_cmd_t cmd);
  */
 ctl_cmd_t ctl_str_to_cmd(const char *cmd_str);
 
+/*!
+ * Checks if the command only reads the server state.
+ *
+ * Such commands can be executed in parallel with each other.
+ * The configuration commands are excluded as they can use the
+ * configuration transaction, which is bound to one thread.
+ *
+ * \param[in] cmd  Command.
+ *
+ * \return True if read-only.
+ */
+bool ctl_cmd_readonly(ctl_cmd_t cmd);
+
 /*!
  * Executes a control command.
  *
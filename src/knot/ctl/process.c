@@ -14,6 +14,8 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <pthread.h>
+
 #include "contrib/mempattern.h"
 #include "contrib/ucw/mempool.h"
 #include "knot/common/log.h"
@@ -21,6 +23,23 @@
 #include "knot/ctl/process.h"
 #include "libknot/error.h"
 
+/*! Lock shared by the read-only commands, other commands hold it exclusively. */
+static pthread_rwlock_t ctl_rwlock = PTHREAD_RWLOCK_INITIALIZER;
+
+void ctl_lock(bool exclusive)
+{
+	if (exclusive) {
+		pthread_rwlock_wrlock(&ctl_rwlock);
+	} else {
+		pthread_rwlock_rdlock(&ctl_rwlock);
+	}
+}
+
+void ctl_unlock(void)
+{
+	pthread_rwlock_unlock(&ctl_rwlock);
+}
+
 int ctl_process(knot_ctl_t *ctl, server_t *server)
 {
 	if (ctl == NULL || server == NULL) {
@@ -93,7 +112,9 @@ int ctl_process(knot_ctl_t *ctl, server_t *server)
 		}
 
 		// Execute the command.
+		ctl_lock(!ctl_cmd_readonly(cmd));
 		int cmd_ret = ctl_exec(cmd, &args);
+		ctl_unlock();
 		switch (cmd_ret) {
 		case KNOT_EOK:
 			strip = false;
@@ -19,9 +19,27 @@
 #include "libknot/libknot.h"
 #include "knot/server/server.h"
 
+/*!
+ * Locks the execution of control commands.
+ *
+ * The read-only commands share the lock, so they can be executed in parallel
+ * over several control connections. Other commands and any other changes
+ * of the server state they could interfere with hold the lock exclusively.
+ *
+ * \param[in] exclusive  Lock exclusively.
+ */
+void ctl_lock(bool exclusive);
+
+/*!
+ * Unlocks the execution of control commands.
+ */
+void ctl_unlock(void);
+
 /*!
  * Processes incoming control commands.
  *
+ * Can be called in parallel for different control connections.
+ *
  * \param[in] ctl     Control context.
  * \param[in] server  Server instance.
  *
@@ -80,6 +80,15 @@ static void policy_load(knot_kasp_policy_t *policy, conf_val_t *id)
 	val = conf_id_get(conf(), C_POLICY, C_RRSIG_PREREFRESH, id);
 	policy->rrsig_prerefresh = conf_int(&val);
 
+	val = conf_id_get(conf(), C_POLICY, C_RRSIG_JITTER, id);
+	policy->rrsig_jitter = conf_int(&val);
+
+	val = conf_id_get(conf(), C_POLICY, C_RRSIG_BATCH, id);
+	policy->rrsig_batch = conf_int(&val);
+
+	val = conf_id_get(conf(), C_POLICY, C_RRSIG_BATCH_INTERVAL, id);
+	policy->rrsig_batch_interval = conf_int(&val);
+
 	val = conf_id_get(conf(), C_POLICY, C_NSEC3, id);
 	policy->nsec3_enabled = conf_bool(&val);
 
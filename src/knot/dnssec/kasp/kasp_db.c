@@ -150,20 +150,93 @@ static key_params_t *txn2params(knot_lmdb_txn_t *txn)
 	return p;
 }
 
-int kasp_db_list_keys(knot_lmdb_db_t *db, const knot_dname_t *zone_name, list_t *dst)
+/*! \brief Insert a key-value pair unless exactly the same one is stored already. */
+static void insert_changed(knot_lmdb_txn_t *txn, MDB_val *key, MDB_val *val)
+{
+	if (knot_lmdb_find(txn, key, KNOT_LMDB_EXACT) &&
+	    txn->cur_val.mv_size == val->mv_size &&
+	    (val->mv_size == 0 ||
+	     memcmp(txn->cur_val.mv_data, val->mv_data, val->mv_size) == 0)) {
+		return;
+	}
+	knot_lmdb_insert(txn, key, val);
+}
+
+static void txn_list_keys(knot_lmdb_txn_t *txn, const knot_dname_t *zone_name, list_t *dst)
 {
-	init_list(dst);
-	knot_lmdb_txn_t txn = { 0 };
 	MDB_val prefix = make_key_str(KASPDBKEY_PARAMS, zone_name, NULL);
-	knot_lmdb_begin(db, &txn, false);
-	knot_lmdb_foreach(&txn, &prefix) {
-		key_params_t *p = txn2params(&txn);
+	knot_lmdb_foreach(txn, &prefix) {
+		key_params_t *p = txn2params(txn);
 		if (p != NULL) {
 			ptrlist_add(dst, p, NULL);
 		}
 	}
-	knot_lmdb_abort(&txn);
 	free(prefix.mv_data);
+}
+
+static void txn_add_key(knot_lmdb_txn_t *txn, const knot_dname_t *zone_name,
+                        const key_params_t *params)
+{
+	MDB_val k = make_key_str(KASPDBKEY_PARAMS, zone_name, params->id);
+	MDB_val v = params_serialize(params);
+	if (k.mv_data == NULL || v.mv_data == NULL) {
+		txn->ret = KNOT_ENOMEM;
+	} else {
+		insert_changed(txn, &k, &v);
+	}
+	free(k.mv_data);
+	free(v.mv_data);
+}
+
+static void txn_load_nsec3salt(knot_lmdb_txn_t *txn, const knot_dname_t *zone_name,
+                               dnssec_binary_t *nsec3salt, knot_time_t *salt_created)
+{
+	MDB_val key = make_key_str(KASPDBKEY_NSEC3SALT, zone_name, NULL);
+	memset(nsec3salt, 0, sizeof(*nsec3salt));
+	if (knot_lmdb_find(txn, &key, KNOT_LMDB_EXACT | KNOT_LMDB_FORCE)) {
+		nsec3salt->size = txn->cur_val.mv_size;
+		nsec3salt->data = malloc(txn->cur_val.mv_size + 1); // +1 because it can be zero
+		if (nsec3salt->data == NULL) {
+			txn->ret = KNOT_ENOMEM;
+		} else {
+			memcpy(nsec3salt->data, txn->cur_val.mv_data, txn->cur_val.mv_size);
+		}
+		*(uint8_t *)key.mv_data = KASPDBKEY_NSEC3TIME;
+	}
+	if (knot_lmdb_find(txn, &key, KNOT_LMDB_EXACT | KNOT_LMDB_FORCE)) {
+		knot_lmdb_unmake_curval(txn, "L", salt_created);
+	}
+	free(key.mv_data);
+	if (txn->ret != KNOT_EOK) {
+		free(nsec3salt->data);
+		nsec3salt->data = NULL;
+	}
+}
+
+static void txn_store_nsec3salt(knot_lmdb_txn_t *txn, const knot_dname_t *zone_name,
+                                const dnssec_binary_t *nsec3salt, knot_time_t salt_created)
+{
+	MDB_val key = make_key_str(KASPDBKEY_NSEC3SALT, zone_name, NULL);
+	MDB_val val1 = { nsec3salt->size, nsec3salt->data };
+	uint64_t tmp = htobe64(salt_created);
+	MDB_val val2 = { sizeof(tmp), &tmp };
+	if (key.mv_data == NULL) {
+		txn->ret = KNOT_ENOMEM;
+		return;
+	}
+	insert_changed(txn, &key, &val1);
+	*(uint8_t *)key.mv_data = KASPDBKEY_NSEC3TIME;
+	insert_changed(txn, &key, &val2);
+	free(key.mv_data);
+}
+
+int kasp_db_list_keys(knot_lmdb_db_t *db, const knot_dname_t *zone_name, list_t *dst)
+{
+	init_list(dst);
+	knot_lmdb_txn_t txn = { 0 };
+	knot_lmdb_begin(db, &txn, false);
+	txn_list_keys(&txn, zone_name, dst);
+	knot_lmdb_abort(&txn);
 	if (txn.ret != KNOT_EOK) {
 		ptrlist_deep_free(dst, NULL);
 		return txn.ret;
@@ -171,6 +244,42 @@ int kasp_db_list_keys(knot_lmdb_db_t *db, const knot_dname_t *zone_name, list_t
 	return (EMPTY_LIST(*dst) ? KNOT_ENOENT : KNOT_EOK);
 }
 
+int kasp_db_load_zone(knot_lmdb_db_t *db, const knot_dname_t *zone_name, list_t *keys,
+                      dnssec_binary_t *nsec3salt, knot_time_t *salt_created)
+{
+	init_list(keys);
+	knot_lmdb_txn_t txn = { 0 };
+	knot_lmdb_begin(db, &txn, false);
+	txn_list_keys(&txn, zone_name, keys);
+	if (txn.ret == KNOT_EOK) {
+		txn_load_nsec3salt(&txn, zone_name, nsec3salt, salt_created);
+		if (txn.ret == KNOT_ENOENT) { // the salt is optional
+			txn.ret = KNOT_EOK;
+		}
+	}
+	knot_lmdb_abort(&txn);
+	if (txn.ret != KNOT_EOK) {
+		ptrlist_deep_free(keys, NULL);
+	}
+	return txn.ret;
+}
+
+int kasp_db_store_zone(knot_lmdb_db_t *db, const knot_dname_t *zone_name,
+                       const key_params_t *keys, size_t num_keys,
+                       const dnssec_binary_t *nsec3salt, knot_time_t salt_created)
+{
+	knot_lmdb_txn_t txn = { 0 };
+	knot_lmdb_begin(db, &txn, true);
+	for (size_t i = 0; i < num_keys && txn.ret == KNOT_EOK; i++) {
+		txn_add_key(&txn, zone_name, &keys[i]);
+	}
+	if (txn.ret == KNOT_EOK) {
+		txn_store_nsec3salt(&txn, zone_name, nsec3salt, salt_created);
+	}
+	knot_lmdb_commit(&txn);
+	return txn.ret;
+}
+
 static bool keyid_inuse(knot_lmdb_txn_t *txn, const char *key_id, key_params_t **params)
 {
 	uint8_t pf = KASPDBKEY_PARAMS;
@@ -272,47 +381,20 @@ int kasp_db_share_key(knot_lmdb_db_t *db, const knot_dname_t *zone_from,
 int kasp_db_store_nsec3salt(knot_lmdb_db_t *db, const knot_dname_t *zone_name,
 			    const dnssec_binary_t *nsec3salt, knot_time_t salt_created)
 {
-	MDB_val key = make_key_str(KASPDBKEY_NSEC3SALT, zone_name, NULL);
-	MDB_val val1 = { nsec3salt->size, nsec3salt->data };
-	uint64_t tmp = htobe64(salt_created);
-	MDB_val val2 = { sizeof(tmp), &tmp };
 	knot_lmdb_txn_t txn = { 0 };
 	knot_lmdb_begin(db, &txn, true);
-	knot_lmdb_insert(&txn, &key, &val1);
-	if (key.mv_data != NULL) {
-		*(uint8_t *)key.mv_data = KASPDBKEY_NSEC3TIME;
-	}
-	knot_lmdb_insert(&txn, &key, &val2);
+	txn_store_nsec3salt(&txn, zone_name, nsec3salt, salt_created);
 	knot_lmdb_commit(&txn);
-	free(key.mv_data);
 	return txn.ret;
 }
 
 int kasp_db_load_nsec3salt(knot_lmdb_db_t *db, const knot_dname_t *zone_name,
 			   dnssec_binary_t *nsec3salt, knot_time_t *salt_created)
 {
-	MDB_val key = make_key_str(KASPDBKEY_NSEC3SALT, zone_name, NULL);
 	knot_lmdb_txn_t txn = { 0 };
-	memset(nsec3salt, 0, sizeof(*nsec3salt));
 	knot_lmdb_begin(db, &txn, false);
-	if (knot_lmdb_find(&txn, &key, KNOT_LMDB_EXACT | KNOT_LMDB_FORCE)) {
-		nsec3salt->size = txn.cur_val.mv_size;
-		nsec3salt->data = malloc(txn.cur_val.mv_size + 1); // +1 because it can be zero
-		if (nsec3salt->data == NULL) {
-			txn.ret = KNOT_ENOMEM;
-		} else {
-			memcpy(nsec3salt->data, txn.cur_val.mv_data, txn.cur_val.mv_size);
-		}
-		*(uint8_t *)key.mv_data = KASPDBKEY_NSEC3TIME;
-	}
-	if (knot_lmdb_find(&txn, &key, KNOT_LMDB_EXACT | KNOT_LMDB_FORCE)) {
-		knot_lmdb_unmake_curval(&txn, "L", salt_created);
-	}
+	txn_load_nsec3salt(&txn, zone_name, nsec3salt, salt_created);
 	knot_lmdb_abort(&txn);
-	free(key.mv_data);
-	if (txn.ret != KNOT_EOK) {
-		free(nsec3salt->data);
-	}
 	return txn.ret;
 }
 
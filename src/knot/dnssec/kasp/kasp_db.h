@@ -43,6 +43,39 @@ typedef enum { // the enum values MUST match those from keyclass_t !!
  */
 int kasp_db_list_keys(knot_lmdb_db_t *db, const knot_dname_t *zone_name, list_t *dst);
 
+/*!
+ * \brief Load all keys and the NSEC3 salt of a zone in one transaction.
+ *
+ * \param db            KASP db
+ * \param zone_name     name of the zone in question
+ * \param keys          output if KNOT_EOK: ptrlist of keys' params (possibly empty)
+ * \param nsec3salt     output if KNOT_EOK: NSEC3 salt (empty if not stored)
+ * \param salt_created  output if KNOT_EOK: timestamp of salt creation (unchanged if not stored)
+ *
+ * \return KNOT_E*
+ */
+int kasp_db_load_zone(knot_lmdb_db_t *db, const knot_dname_t *zone_name, list_t *keys,
+                      dnssec_binary_t *nsec3salt, knot_time_t *salt_created);
+
+/*!
+ * \brief Store all keys and the NSEC3 salt of a zone in one transaction.
+ *
+ * Only the records differing from the stored ones are written, so that
+ * storing an unchanged zone doesn't modify the database at all.
+ *
+ * \param db            KASP db
+ * \param zone_name     name of the zone the keys belong to
+ * \param keys          keys' params, incl. IDs
+ * \param num_keys      number of keys
+ * \param nsec3salt     NSEC3 salt
+ * \param salt_created  timestamp of salt creation
+ *
+ * \return KNOT_E*
+ */
+int kasp_db_store_zone(knot_lmdb_db_t *db, const knot_dname_t *zone_name,
+                       const key_params_t *keys, size_t num_keys,
+                       const dnssec_binary_t *nsec3salt, knot_time_t salt_created);
+
 /*!
  * \brief Remove a key from zone. Delete the key if no zone has it anymore.
  *
@@ -172,20 +172,18 @@ int kasp_zone_load(knot_kasp_zone_t *zone,
 
 	list_t key_params;
 	init_list(&key_params);
-	int ret = kasp_db_list_keys(kdb, zone_name, &key_params);
-	if (ret == KNOT_ENOENT) {
-		zone->keys = NULL;
-		zone->num_keys = 0;
-		ret = KNOT_EOK;
-		goto kzl_salt;
-	} else if (ret != KNOT_EOK) {
+	int ret = kasp_db_load_zone(kdb, zone_name, &key_params, &salt, &sc);
+	if (ret != KNOT_EOK) {
 		goto kzl_end;
 	}
 
 	num_dkeys = list_size(&key_params);
-	dkeys = calloc(num_dkeys, sizeof(*dkeys));
-	if (dkeys == NULL) {
-		goto kzl_end;
+	if (num_dkeys > 0) {
+		dkeys = calloc(num_dkeys, sizeof(*dkeys));
+		if (dkeys == NULL) {
+			ret = KNOT_ENOMEM;
+			goto kzl_end;
+		}
 	}
 
 	ptrnode_t *n;
@@ -199,10 +197,6 @@ int kasp_zone_load(knot_kasp_zone_t *zone,
 		}
 	}
 
-kzl_salt:
-	(void)kasp_db_load_nsec3salt(kdb, zone_name, &salt, &sc);
-	// if error, salt was probably not present, no problem to have zero ?
-
 	zone->dname = knot_dname_copy(zone_name, NULL);
 	if (zone->dname == NULL) {
 		ret = KNOT_ENOMEM;
@@ -219,6 +213,7 @@ kzl_end:
 	ptrlist_deep_free(&key_params, NULL);
 	if (ret != KNOT_EOK) {
 		free(dkeys);
+		free(salt.data);
 	}
 	return ret;
 }
@@ -252,20 +247,20 @@ int kasp_zone_save(const knot_kasp_zone_t *zone,
 		return KNOT_EINVAL;
 	}
 
-	key_params_t parm;
+	key_params_t *parms = malloc((zone->num_keys + 1) * sizeof(*parms));
+	if (parms == NULL) {
+		return KNOT_ENOMEM;
+	}
 	for (size_t i = 0; i < zone->num_keys; i++) {
-		kaspkey2params(&zone->keys[i], &parm);
-
-		// Force overwrite already existing key-val pairs.
-		int ret = kasp_db_add_key(kdb, zone_name, &parm);
-		if (ret != KNOT_EOK) {
-			return ret;
-		}
+		kaspkey2params(&zone->keys[i], &parms[i]);
 	}
 
+	// Only the changed key-val pairs are written.
+	int ret = kasp_db_store_zone(kdb, zone_name, parms, zone->num_keys,
+	                             &zone->nsec3_salt, zone->nsec3_salt_created);
+	free(parms);
 
-	return kasp_db_store_nsec3salt(kdb, zone_name, &zone->nsec3_salt,
-	                               zone->nsec3_salt_created);
+	return ret;
 }
 
 int kasp_zone_init(knot_kasp_zone_t **zone)
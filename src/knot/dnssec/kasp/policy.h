@@ -102,6 +102,9 @@ typedef struct {
 	uint32_t rrsig_lifetime;            // like knot_time_t
 	uint32_t rrsig_refresh_before;      // like knot_timediff_t
 	uint32_t rrsig_prerefresh;          // like knot_timediff_t
+	uint32_t rrsig_jitter;              // like knot_timediff_t
+	uint32_t rrsig_batch;               // max nodes re-signed at once, 0 = unlimited
+	uint32_t rrsig_batch_interval;      // like knot_timediff_t
 	// NSEC3
 	bool nsec3_enabled;
 	bool nsec3_opt_out;
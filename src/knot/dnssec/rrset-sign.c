@@ -16,6 +16,7 @@
 
 #include <assert.h>
 
+#include "contrib/openbsd/siphash.h"
 #include "contrib/wire_ctx.h"
 #include "libdnssec/error.h"
 #include "knot/dnssec/rrset-sign.h"
@@ -257,6 +258,27 @@ static int rrsigs_create_rdata(knot_rrset_t *rrsigs, dnssec_sign_ctx_t *ctx,
 	return knot_rrset_add_rdata(rrsigs, rrsig, rrsig_size, mm);
 }
 
+/*!
+ * \brief Get the RRSIG lifetime reduction of the RRSet.
+ *
+ * The value is derived from the RRSet owner and type only, so that the RRSet
+ * keeps its position in the re-signing schedule across signing events.
+ */
+static uint32_t rrsig_jitter(const knot_rrset_t *covered, uint32_t jitter)
+{
+	if (jitter == 0) {
+		return 0;
+	}
+
+	static const SIPHASH_KEY key = { 0 };
+	SIPHASH_CTX ctx;
+	SipHash24_Init(&ctx, &key);
+	SipHash24_Update(&ctx, covered->owner, knot_dname_size(covered->owner));
+	SipHash24_Update(&ctx, &covered->type, sizeof(covered->type));
+
+	return SipHash24_End(&ctx) % ((uint64_t)jitter + 1);
+}
+
 int knot_sign_rrset(knot_rrset_t *rrsigs, const knot_rrset_t *covered,
                     const dnssec_key_t *key, dnssec_sign_ctx_t *sign_ctx,
                     const kdnssec_ctx_t *dnssec_ctx, knot_mm_t *mm, knot_time_t *expires)
@@ -269,7 +291,8 @@ int knot_sign_rrset(knot_rrset_t *rrsigs, const knot_rrset_t *covered,
 	}
 
 	uint32_t sig_incept = dnssec_ctx->now - RRSIG_INCEPT_IN_PAST;
-	uint32_t sig_expire = dnssec_ctx->now + dnssec_ctx->policy->rrsig_lifetime;
+	uint32_t sig_expire = dnssec_ctx->now + dnssec_ctx->policy->rrsig_lifetime -
+	                      rrsig_jitter(covered, dnssec_ctx->policy->rrsig_jitter);
 
 	int ret = rrsigs_create_rdata(rrsigs, sign_ctx, covered, key, sig_incept,
 	                              sig_expire, mm);
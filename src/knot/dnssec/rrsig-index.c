@@ -0,0 +1,265 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "knot/dnssec/rrsig-index.h"
+#include "libknot/libknot.h"
+#include "contrib/wire_ctx.h"
+
+typedef struct {
+	heap_val_t hpos;
+	knot_time_t expire;   /*!< Earliest RRSIG expiration in the node. */
+	bool nsec3;           /*!< The node belongs to the NSEC3 tree. */
+	knot_dname_t owner[]; /*!< Node owner. */
+} rrsig_index_entry_t;
+
+#define KEY_FINGERPRINT_SIZE 4
+
+/*! \brief Trie key of a node, distinguishing normal and NSEC3 trees. */
+static uint8_t *entry_key(const knot_dname_t *owner, bool nsec3, uint8_t *storage,
+                          uint32_t *key_len)
+{
+	knot_dname_storage_t lf_storage;
+	uint8_t *lf = knot_dname_lf(owner, lf_storage);
+	assert(lf);
+
+	storage[0] = nsec3;
+	memcpy(storage + 1, lf + 1, *lf);
+	*key_len = *lf + 1;
+
+	return storage;
+}
+
+static int entry_cmp(void *a, void *b)
+{
+	knot_time_t a_expire = ((rrsig_index_entry_t *)a)->expire;
+	knot_time_t b_expire = ((rrsig_index_entry_t *)b)->expire;
+
+	return (a_expire > b_expire) - (a_expire < b_expire);
+}
+
+static uint8_t key_flags(const zone_key_t *key)
+{
+	return (key->is_ksk             << 0) |
+	       (key->is_zsk             << 1) |
+	       (key->is_active          << 2) |
+	       (key->is_public          << 3) |
+	       (key->is_ready           << 4) |
+	       (key->is_zsk_active_plus << 5) |
+	       (key->is_ksk_active_plus << 6);
+}
+
+static void key_fingerprint(const zone_key_t *key, uint8_t *out)
+{
+	wire_ctx_t wire = wire_ctx_init(out, KEY_FINGERPRINT_SIZE);
+	wire_ctx_write_u16(&wire, dnssec_key_get_keytag(key->key));
+	wire_ctx_write_u8(&wire, dnssec_key_get_algorithm(key->key));
+	wire_ctx_write_u8(&wire, key_flags(key));
+	assert(wire.error == KNOT_EOK);
+}
+
+static void keys_fingerprint(const zone_keyset_t *keyset, uint8_t *out)
+{
+	for (size_t i = 0; i < keyset->count; i++) {
+		key_fingerprint(&keyset->keys[i], out + i * KEY_FINGERPRINT_SIZE);
+	}
+}
+
+rrsig_index_t *rrsig_index_new(const zone_keyset_t *keyset)
+{
+	if (keyset == NULL) {
+		return NULL;
+	}
+
+	rrsig_index_t *index = calloc(1, sizeof(*index));
+	if (index == NULL) {
+		return NULL;
+	}
+
+	index->keys_size = keyset->count * KEY_FINGERPRINT_SIZE;
+	index->keys = malloc(index->keys_size + 1);
+	index->nodes = trie_create(NULL);
+	if (index->keys == NULL || index->nodes == NULL ||
+	    !heap_init(&index->heap, entry_cmp, 0)) {
+		trie_free(index->nodes);
+		free(index->keys);
+		free(index);
+		return NULL;
+	}
+	keys_fingerprint(keyset, index->keys);
+
+	return index;
+}
+
+void rrsig_index_free(rrsig_index_t *index)
+{
+	if (index == NULL) {
+		return;
+	}
+
+	for (int i = 1; i <= index->heap.num; i++) {
+		free(*HELEMENT(&index->heap, i));
+	}
+	heap_deinit(&index->heap);
+	trie_free(index->nodes);
+	free(index->keys);
+	free(index);
+}
+
+bool rrsig_index_keys_match(const rrsig_index_t *index, const zone_keyset_t *keyset)
+{
+	if (index == NULL || keyset == NULL ||
+	    index->keys_size != keyset->count * KEY_FINGERPRINT_SIZE) {
+		return false;
+	}
+
+	for (size_t i = 0; i < keyset->count; i++) {
+		uint8_t key[KEY_FINGERPRINT_SIZE];
+		key_fingerprint(&keyset->keys[i], key);
+		if (memcmp(key, index->keys + i * KEY_FINGERPRINT_SIZE, sizeof(key)) != 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+typedef struct {
+	rrsig_index_t *index;
+	bool nsec3;
+} add_node_ctx_t;
+
+static int add_node(zone_node_t *node, void *data)
+{
+	add_node_ctx_t *ctx = data;
+	rrsig_index_t *index = ctx->index;
+
+	knot_time_t expire = 0;
+	const knot_rdataset_t *rrsigs = node_rdataset(node, KNOT_RRTYPE_RRSIG);
+	if (rrsigs != NULL) {
+		knot_rdata_t *rr = rrsigs->rdata;
+		for (uint16_t i = 0; i < rrsigs->count; i++) {
+			uint32_t rr_expire = knot_rrsig_sig_expiration(rr);
+			expire = knot_time_min(expire, knot_time_from_u32(rr_expire));
+			rr = knot_rdataset_next(rr);
+		}
+	}
+
+	uint8_t key_storage[KNOT_DNAME_MAXLEN + 1];
+	uint32_t key_len;
+	uint8_t *key = entry_key(node->owner, ctx->nsec3, key_storage, &key_len);
+
+	// drop the previous entry of the node
+	trie_val_t old = NULL;
+	if (trie_del(index->nodes, key, key_len, &old) == KNOT_EOK) {
+		rrsig_index_entry_t *entry = old;
+		heap_delete(&index->heap, heap_find(&index->heap, &entry->hpos));
+		free(entry);
+	}
+
+	if (expire == 0) {
+		return KNOT_EOK;
+	}
+
+	size_t owner_size = knot_dname_size(node->owner);
+	rrsig_index_entry_t *entry = malloc(sizeof(*entry) + owner_size);
+	if (entry == NULL) {
+		return KNOT_ENOMEM;
+	}
+	entry->expire = expire;
+	entry->nsec3 = ctx->nsec3;
+	memcpy(entry->owner, node->owner, owner_size);
+
+	trie_val_t *val = trie_get_ins(index->nodes, key, key_len);
+	if (val == NULL) {
+		free(entry);
+		return KNOT_ENOMEM;
+	}
+	if (!heap_insert(&index->heap, &entry->hpos)) {
+		trie_del(index->nodes, key, key_len, NULL);
+		free(entry);
+		return KNOT_ENOMEM;
+	}
+	*val = entry;
+
+	return KNOT_EOK;
+}
+
+int rrsig_index_add_tree(rrsig_index_t *index, zone_tree_t *tree, bool nsec3)
+{
+	if (index == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	add_node_ctx_t ctx = { index, nsec3 };
+
+	return zone_tree_apply(tree, add_node, &ctx);
+}
+
+int rrsig_index_pop(rrsig_index_t *index, knot_time_t until, size_t limit,
+                    zone_contents_t *contents, zone_tree_t *nodes,
+                    zone_tree_t *nsec3_nodes)
+{
+	if (index == NULL || contents == NULL || nodes == NULL || nsec3_nodes == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	int ret = KNOT_EOK;
+	size_t found = 0;
+	while (ret == KNOT_EOK && !EMPTY_HEAP(&index->heap) &&
+	       (limit == 0 || found < limit)) {
+		rrsig_index_entry_t *entry = (rrsig_index_entry_t *)*HHEAD(&index->heap);
+		if (knot_time_cmp(entry->expire, until) > 0) {
+			break;
+		}
+		heap_delmin(&index->heap);
+
+		uint8_t key_storage[KNOT_DNAME_MAXLEN + 1];
+		uint32_t key_len;
+		uint8_t *key = entry_key(entry->owner, entry->nsec3, key_storage, &key_len);
+		trie_del(index->nodes, key, key_len, NULL);
+
+		zone_tree_t *tree = entry->nsec3 ? contents->nsec3_nodes : contents->nodes;
+		zone_node_t *node = zone_tree_get(tree, entry->owner);
+		if (node != NULL) {
+			found++;
+			ret = zone_tree_insert(entry->nsec3 ? nsec3_nodes : nodes, &node);
+		}
+		free(entry);
+	}
+
+	return ret;
+}
+
+knot_time_t rrsig_index_next(const rrsig_index_t *index)
+{
+	if (index == NULL || EMPTY_HEAP(&index->heap)) {
+		return 0;
+	}
+
+	return ((rrsig_index_entry_t *)*HHEAD(&index->heap))->expire;
+}
+
+knot_time_t rrsig_index_next_batch(const rrsig_index_t *index, knot_time_t now,
+                                   uint32_t interval, knot_time_t deadline)
+{
+	knot_time_t next = knot_time_add(now, interval);
+	next = knot_time_min(next, rrsig_index_next(index));
+	return knot_time_min(next, deadline);
+}
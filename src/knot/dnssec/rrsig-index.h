@@ -0,0 +1,114 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "contrib/qp-trie/trie.h"
+#include "contrib/time.h"
+#include "contrib/ucw/heap.h"
+#include "knot/dnssec/zone-keys.h"
+#include "knot/zone/contents.h"
+
+/*!
+ * \brief Index of zone nodes ordered by the earliest RRSIG expiration.
+ *
+ * The index is owned by the zone contents it describes and it's passed on
+ * to the next contents version only by the signing code, which updates it
+ * with the nodes changed meanwhile.
+ */
+typedef struct rrsig_index {
+	struct heap heap;      /*!< Min-heap of rrsig_index_entry_t. */
+	trie_t *nodes;         /*!< Entries by node owner, for updates. */
+	uint8_t *keys;         /*!< Fingerprint of the keyset used for signing. */
+	size_t keys_size;      /*!< Size of the keyset fingerprint. */
+} rrsig_index_t;
+
+/*!
+ * \brief Create an empty index for the given signing keyset.
+ *
+ * \param keyset  Zone keys used for signing.
+ *
+ * \return New index or NULL.
+ */
+rrsig_index_t *rrsig_index_new(const zone_keyset_t *keyset);
+
+/*!
+ * \brief Free the index including all its entries.
+ */
+void rrsig_index_free(rrsig_index_t *index);
+
+/*!
+ * \brief Check if the index was built with the same signing keys.
+ *
+ * \param index   RRSIG index.
+ * \param keyset  Zone keys used for signing.
+ *
+ * \return True if the keys and their roles are the same.
+ */
+bool rrsig_index_keys_match(const rrsig_index_t *index, const zone_keyset_t *keyset);
+
+/*!
+ * \brief Add or update all nodes in a zone tree in the index.
+ *
+ * Nodes without any RRSIG are removed from the index.
+ *
+ * \param index  RRSIG index.
+ * \param tree   Zone tree with the nodes to be added.
+ * \param nsec3  The nodes belong to the NSEC3 tree.
+ *
+ * \return KNOT_E*
+ */
+int rrsig_index_add_tree(rrsig_index_t *index, zone_tree_t *tree, bool nsec3);
+
+/*!
+ * \brief Remove the entries expiring until given time and collect their nodes.
+ *
+ * Nodes which no longer exist in the contents are silently dropped and don't
+ * count towards the limit.
+ *
+ * \param index        RRSIG index.
+ * \param until        Remove entries expiring until (including) this time.
+ * \param limit        Maximal number of nodes to collect (0 for unlimited).
+ * \param contents     Zone contents to look the nodes up in.
+ * \param nodes        Output: tree of the collected normal nodes.
+ * \param nsec3_nodes  Output: tree of the collected NSEC3 nodes.
+ *
+ * \return KNOT_E*
+ */
+int rrsig_index_pop(rrsig_index_t *index, knot_time_t until, size_t limit,
+                    zone_contents_t *contents, zone_tree_t *nodes,
+                    zone_tree_t *nsec3_nodes);
+
+/*!
+ * \brief Get the earliest RRSIG expiration in the index (0 if empty).
+ */
+knot_time_t rrsig_index_next(const rrsig_index_t *index);
+
+/*!
+ * \brief Get the time of the next re-signing batch.
+ *
+ * The batch is postponed by the batch interval to let other events run,
+ * but not past the earliest RRSIG expiration in the index or the deadline.
+ *
+ * \param index     RRSIG index.
+ * \param now       Current time.
+ * \param interval  Interval between re-signing batches.
+ * \param deadline  Another time the zone must be re-signed at (0 for none).
+ *
+ * \return Time of the next batch.
+ */
+knot_time_t rrsig_index_next_batch(const rrsig_index_t *index, knot_time_t now,
+                                   uint32_t interval, knot_time_t deadline);
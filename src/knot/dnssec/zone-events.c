@@ -23,6 +23,7 @@
 #include "knot/common/log.h"
 #include "knot/dnssec/key-events.h"
 #include "knot/dnssec/policy.h"
+#include "knot/dnssec/rrsig-index.h"
 #include "knot/dnssec/zone-events.h"
 #include "knot/dnssec/zone-keys.h"
 #include "knot/dnssec/zone-nsec.h"
@@ -141,6 +142,92 @@ int knot_dnssec_nsec3resalt(kdnssec_ctx_t *ctx, knot_time_t *salt_changed, knot_
 	return ret;
 }
 
+/*!
+ * \brief Take over the RRSIG expiration index from the current zone contents.
+ *
+ * The index is detached from the contents in any case, so that it can be
+ * updated and passed to the new contents. NULL is returned if the index
+ * doesn't exist or can't be used for signing with the current keys.
+ */
+static rrsig_index_t *take_rrsig_index(zone_update_t *update, const kdnssec_ctx_t *ctx,
+                                       const zone_keyset_t *keyset)
+{
+	if (!(update->flags & UPDATE_INCREMENTAL) || update->zone->contents == NULL) {
+		return NULL;
+	}
+
+	rrsig_index_t *index = update->zone->contents->rrsig_index;
+	update->zone->contents->rrsig_index = NULL;
+
+	if (ctx->rrsig_drop_existing || ctx->keytag_conflict ||
+	    !rrsig_index_keys_match(index, keyset)) {
+		rrsig_index_free(index);
+		return NULL;
+	}
+
+	return index;
+}
+
+/*!
+ * \brief Check if the update changed nothing but the zone apex.
+ */
+static bool apex_only_changed(zone_update_t *update)
+{
+	changeset_iter_t itt;
+	if (changeset_iter_all(&itt, &update->change) != KNOT_EOK) {
+		return false;
+	}
+
+	bool apex_only = true;
+	knot_rrset_t rr = changeset_iter_next(&itt);
+	while (apex_only && !knot_rrset_empty(&rr)) {
+		apex_only = knot_dname_is_equal(rr.owner, update->new_cont->apex->owner);
+		rr = changeset_iter_next(&itt);
+	}
+	changeset_iter_clear(&itt);
+
+	return apex_only;
+}
+
+/*!
+ * \brief Update the RRSIG expiration index and store it with the zone contents.
+ *
+ * \param update  Zone update after signing.
+ * \param index   RRSIG index, consumed in any case.
+ * \param full    Index all nodes instead of just the changed ones.
+ *
+ * \return KNOT_E*
+ */
+static int store_rrsig_index(zone_update_t *update, rrsig_index_t *index, bool full)
+{
+	int ret;
+	if (full) {
+		ret = rrsig_index_add_tree(index, update->new_cont->nodes, false);
+		if (ret == KNOT_EOK) {
+			ret = rrsig_index_add_tree(index, update->new_cont->nsec3_nodes, true);
+		}
+	} else {
+		ret = rrsig_index_add_tree(index, update->a_ctx->node_ptrs, false);
+		if (ret == KNOT_EOK) {
+			ret = rrsig_index_add_tree(index, update->a_ctx->nsec3_ptrs, true);
+		}
+	}
+	if (ret != KNOT_EOK) {
+		rrsig_index_free(index);
+		return ret;
+	}
+
+	// an unchanged incremental update isn't committed, keep the current contents
+	zone_contents_t *contents = update->new_cont;
+	if ((update->flags & UPDATE_INCREMENTAL) && zone_update_no_change(update)) {
+		contents = update->zone->contents;
+	}
+	rrsig_index_free(contents->rrsig_index);
+	contents->rrsig_index = index;
+
+	return KNOT_EOK;
+}
+
 int knot_dnssec_zone_sign(zone_update_t *update,
                           zone_sign_flags_t flags,
                           zone_sign_roll_flags_t roll_flags,
@@ -154,6 +241,8 @@ int knot_dnssec_zone_sign(zone_update_t *update,
 	const knot_dname_t *zone_name = update->new_cont->apex->owner;
 	kdnssec_ctx_t ctx = { 0 };
 	zone_keyset_t keyset = { 0 };
+	rrsig_index_t *index = NULL;
+	bool index_full = true;
 
 	// signing pipeline
 
@@ -194,8 +283,26 @@ int knot_dnssec_zone_sign(zone_update_t *update,
 		goto done;
 	}
 
+	// re-sign just the expiring nodes if nothing but the apex has changed
+	index = take_rrsig_index(update, &ctx, &keyset);
+	if (index != NULL && !apex_only_changed(update)) {
+		rrsig_index_free(index);
+		index = NULL;
+	}
+	index_full = (index == NULL);
+
 	knot_time_t zone_expire = 0;
-	result = knot_zone_sign(update, &keyset, &ctx, &zone_expire);
+	if (index_full) {
+		result = knot_zone_sign(update, &keyset, &ctx, &zone_expire);
+		if (result == KNOT_EOK) {
+			index = rrsig_index_new(&keyset);
+			if (index == NULL) {
+				result = KNOT_ENOMEM;
+			}
+		}
+	} else {
+		result = knot_zone_sign_indexed(update, &keyset, &ctx, index);
+	}
 	if (result != KNOT_EOK) {
 		log_zone_error(zone_name, "DNSSEC, failed to sign zone content (%s)",
 		               knot_strerror(result));
@@ -225,8 +332,29 @@ int knot_dnssec_zone_sign(zone_update_t *update,
 	log_zone_info(zone_name, "DNSSEC, successfully signed");
 
 done:
+	if (result == KNOT_EOK && index != NULL) {
+		result = store_rrsig_index(update, index, index_full);
+		if (result == KNOT_EOK && !index_full) {
+			zone_expire = rrsig_index_next(index);
+		}
+	} else {
+		rrsig_index_free(index);
+	}
+
 	if (result == KNOT_EOK) {
 		reschedule->next_sign = schedule_next(&ctx, &keyset, next_resign, zone_expire);
+
+		// let the other events run between the re-signing batches
+		if (!index_full && ctx.policy->rrsig_batch > 0) {
+			knot_time_t deadline = knot_time_min(next_resign,
+			                                     knot_get_next_zone_key_event(&keyset));
+			knot_time_t batch_next = rrsig_index_next_batch(index, ctx.now,
+			                                                ctx.policy->rrsig_batch_interval,
+			                                                deadline);
+			if (knot_time_cmp(reschedule->next_sign, batch_next) < 0) {
+				reschedule->next_sign = batch_next;
+			}
+		}
 	}
 
 	free_zone_keys(&keyset);
@@ -245,6 +373,7 @@ int knot_dnssec_sign_update(zone_update_t *update, zone_sign_reschedule_t *resch
 	const knot_dname_t *zone_name = update->new_cont->apex->owner;
 	kdnssec_ctx_t ctx = { 0 };
 	zone_keyset_t keyset = { 0 };
+	rrsig_index_t *index = NULL;
 
 	result = sign_init(update->new_cont, 0, 0, update->zone->kaspdb, &ctx, reschedule);
 	if (result != KNOT_EOK) {
@@ -260,6 +389,8 @@ int knot_dnssec_sign_update(zone_update_t *update, zone_sign_reschedule_t *resch
 		goto done;
 	}
 
+	index = take_rrsig_index(update, &ctx, &keyset);
+
 	result = zone_adjust_update(update, adjust_cb_flags, NULL, update->a_ctx->node_ptrs);
 	if (result != KNOT_EOK) {
 		goto done;
@@ -306,6 +437,12 @@ int knot_dnssec_sign_update(zone_update_t *update, zone_sign_reschedule_t *resch
 	log_zone_info(zone_name, "DNSSEC, successfully signed");
 
 done:
+	if (result == KNOT_EOK && index != NULL) {
+		result = store_rrsig_index(update, index, false);
+	} else {
+		rrsig_index_free(index);
+	}
+
 	if (result == KNOT_EOK) {
 		reschedule->next_sign = schedule_next(&ctx, &keyset, 0, expire_at);
 	}
@@ -680,6 +680,64 @@ int knot_zone_sign(zone_update_t *update,
 	return result;
 }
 
+int knot_zone_sign_indexed(zone_update_t *update,
+                           zone_keyset_t *zone_keys,
+                           const kdnssec_ctx_t *dnssec_ctx,
+                           rrsig_index_t *index)
+{
+	if (!update || !zone_keys || !dnssec_ctx || !index ||
+	    dnssec_ctx->policy->signing_threads < 1) {
+		return KNOT_EINVAL;
+	}
+
+	zone_tree_t *nodes = zone_tree_create(true);
+	zone_tree_t *nsec3_nodes = zone_tree_create(true);
+	if (nodes == NULL || nsec3_nodes == NULL) {
+		zone_tree_free(&nodes);
+		zone_tree_free(&nsec3_nodes);
+		return KNOT_ENOMEM;
+	}
+	// the NSEC3 tree is missing in NSEC zones, but it would be alike
+	zone_tree_t *nsec3_tree = update->new_cont->nsec3_nodes;
+	nodes->flags = update->new_cont->nodes->flags;
+	nsec3_nodes->flags = (nsec3_tree != NULL) ? nsec3_tree->flags : nodes->flags;
+
+	// the same margin as in knot_check_signature()
+	knot_time_t until = dnssec_ctx->now + dnssec_ctx->policy->rrsig_refresh_before +
+	                    dnssec_ctx->policy->rrsig_prerefresh;
+	int result = rrsig_index_pop(index, until, dnssec_ctx->policy->rrsig_batch,
+	                             update->new_cont, nodes, nsec3_nodes);
+
+	// the apex is always checked as it may have been changed by key management
+	zone_node_t *apex = update->new_cont->apex;
+	if (result == KNOT_EOK) {
+		result = zone_tree_insert(nodes, &apex);
+	}
+
+	knot_time_t expire = 0;
+	if (result == KNOT_EOK) {
+		result = zone_tree_sign(nodes, dnssec_ctx->policy->signing_threads,
+		                        zone_keys, dnssec_ctx, update, &expire);
+	}
+	if (result == KNOT_EOK && !zone_tree_is_empty(nsec3_nodes)) {
+		result = zone_tree_sign(nsec3_nodes, dnssec_ctx->policy->signing_threads,
+		                        zone_keys, dnssec_ctx, update, &expire);
+	}
+
+	// re-add the checked nodes, even those not changed by signing
+	if (result == KNOT_EOK) {
+		result = rrsig_index_add_tree(index, nodes, false);
+	}
+	if (result == KNOT_EOK) {
+		result = rrsig_index_add_tree(index, nsec3_nodes, true);
+	}
+
+	zone_tree_free(&nodes);
+	zone_tree_free(&nsec3_nodes);
+
+	return result;
+}
+
 keyptr_dynarray_t knot_zone_sign_get_cdnskeys(const kdnssec_ctx_t *ctx,
 					      zone_keyset_t *zone_keys)
 {
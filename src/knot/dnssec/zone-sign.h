@@ -20,6 +20,7 @@
 #include "knot/updates/zone-update.h"
 #include "knot/zone/contents.h"
 #include "knot/dnssec/context.h"
+#include "knot/dnssec/rrsig-index.h"
 #include "knot/dnssec/zone-keys.h"
 
 int rrset_add_zone_key(knot_rrset_t *rrset, zone_key_t *zone_key);
@@ -88,6 +89,25 @@ int knot_zone_sign(zone_update_t *update,
                    const kdnssec_ctx_t *dnssec_ctx,
                    knot_time_t *expire_at);
 
+/*!
+ * \brief Update signatures of the nodes due for re-signing according to the index.
+ *
+ * Only the nodes with signatures expiring within the refresh interval and
+ * the zone apex are checked, the rest of the zone is expected to be signed.
+ * The checked nodes are added back to the index with updated expirations.
+ *
+ * \param update      Zone Update containing the zone and to be updated with new RRSIGs.
+ * \param zone_keys   Zone keys.
+ * \param dnssec_ctx  DNSSEC context.
+ * \param index       RRSIG expiration index of the zone.
+ *
+ * \return Error code, KNOT_EOK if successful.
+ */
+int knot_zone_sign_indexed(zone_update_t *update,
+                           zone_keyset_t *zone_keys,
+                           const kdnssec_ctx_t *dnssec_ctx,
+                           rrsig_index_t *index);
+
 /*!
  * \brief Check if zone SOA signatures are expired.
  *
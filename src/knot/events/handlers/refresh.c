@@ -151,13 +151,59 @@ static time_t bootstrap_next(const zone_timers_t *timers)
 	return interval;
 }
 
-static int xfr_validate(zone_contents_t *zone, struct refresh_data *data)
+/*! \brief Check if the rdataset of the type differs from the previous version. */
+static bool rrtype_changed(zone_node_t *node, uint16_t type)
+{
+	zone_node_t *old = binode_counterpart(node);
+	if (!node_rrtype_exists(node, type) &&
+	    (old == NULL || !node_rrtype_exists(old, type))) {
+		return false;
+	}
+
+	return !binode_rdata_shared(node, type);
+}
+
+static int check_deleg_changed(zone_node_t *node, void *ctx)
+{
+	if (rrtype_changed(node, KNOT_RRTYPE_NS) ||
+	    rrtype_changed(node, KNOT_RRTYPE_DS)) {
+		*(bool *)ctx = true;
+		return KNOT_EOF;
+	}
+
+	return KNOT_EOK;
+}
+
+/*!
+ * \brief Check if some delegation was changed.
+ *
+ * A changed NS or DS set may change the authoritativeness of nodes below
+ * the changed node, which therefore have to be validated too.
+ */
+static bool deleg_changed(zone_tree_t *nodes)
+{
+	bool changed = false;
+	int ret = zone_tree_apply(nodes, check_deleg_changed, &changed);
+
+	return changed || (ret != KNOT_EOK && ret != KNOT_EOF);
+}
+
+/*!
+ * \brief Check the transferred zone.
+ *
+ * \param zone         New zone contents.
+ * \param nodes        Changed nodes to be DNSSEC-validated, NULL for all nodes.
+ * \param nsec3_nodes  Changed NSEC3 nodes to be DNSSEC-validated.
+ * \param data         Refresh data.
+ */
+static int xfr_validate(zone_contents_t *zone, zone_tree_t *nodes,
+                        zone_tree_t *nsec3_nodes, struct refresh_data *data)
 {
 	sem_handler_t handler = {
 		.cb = err_handler_logger
 	};
 
-	int ret = sem_checks_process(zone, false, &handler, time(NULL));
+	int ret = sem_checks_process(zone, false, &handler, time(NULL), 1);
 	if (ret != KNOT_EOK) {
 		// error is logged by the error handler
 		return ret;
@@ -170,6 +216,23 @@ static int xfr_validate(zone_contents_t *zone, struct refresh_data *data)
 		return KNOT_EZONESIZE;
 	}
 
+	conf_val_t val = conf_zone_get(data->conf, C_DNSSEC_VALIDATION, data->zone->name);
+	if (conf_bool(&val)) {
+		// Findings of the previous checks mustn't fail the validation.
+		sem_handler_t dnssec_handler = {
+			.cb = err_handler_logger
+		};
+		ret = sem_checks_dnssec(zone, nodes, nsec3_nodes, &dnssec_handler,
+		                        time(NULL), conf_bg_threads(data->conf));
+		if (ret != KNOT_EOK) {
+			ns_log(LOG_WARNING, data->zone->name,
+			       data->xfr_type == XFR_TYPE_IXFR ? LOG_OPERATION_IXFR : LOG_OPERATION_AXFR,
+			       LOG_DIRECTION_IN, data->remote, "DNSSEC validation failed (%s)",
+			       knot_strerror(ret));
+			return ret;
+		}
+	}
+
 	return KNOT_EOK;
 }
 
@@ -252,9 +315,9 @@ static int axfr_finalize(struct refresh_data *data)
 {
 	zone_contents_t *new_zone = data->axfr.zone;
 
-	int ret = zone_adjust_contents(new_zone, adjust_cb_flags, NULL, false, NULL); // adjust_cb_nsec3_pointer not needed as we don't check DNSSEC in xfr_validate()
+	int ret = zone_adjust_contents(new_zone, adjust_cb_flags, NULL, false, NULL); // adjust_cb_nsec3_pointer not needed as xfr_validate() doesn't check NSEC3 chain
 	if (ret == KNOT_EOK) {
-		ret = xfr_validate(new_zone, data);
+		ret = xfr_validate(new_zone, NULL, NULL, data);
 	}
 	if (ret != KNOT_EOK) {
 		return ret;
@@ -526,9 +589,14 @@ static int ixfr_finalize(struct refresh_data *data)
 		}
 	}
 
-	ret = zone_adjust_contents(up.new_cont, adjust_cb_flags, NULL, false, NULL); // adjust_cb_nsec3_pointer not needed as we don't check DNSSEC in xfr_validate()
+	ret = zone_adjust_contents(up.new_cont, adjust_cb_flags, NULL, false, NULL); // adjust_cb_nsec3_pointer not needed as xfr_validate() doesn't check NSEC3 chain
 	if (ret == KNOT_EOK) {
-		ret = xfr_validate(up.new_cont, data);
+		// only the changed nodes need to be validated unless the keys
+		// or some delegation changed
+		bool full = !binode_rdata_shared(up.new_cont->apex, KNOT_RRTYPE_DNSKEY) ||
+		            deleg_changed(up.a_ctx->node_ptrs);
+		ret = xfr_validate(up.new_cont, full ? NULL : up.a_ctx->node_ptrs,
+		                   full ? NULL : up.a_ctx->nsec3_ptrs, data);
 	}
 	if (ret != KNOT_EOK) {
 		zone_update_clear(&up);
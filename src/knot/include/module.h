@@ -315,6 +315,9 @@ knotd_conf_t knotd_conf_mod(knotd_mod_t *mod, const yp_name_t *item_name);
 /*!
  * Gets zone configuration value.
  *
+ * \note Items cached in the zone structure (disable-any, dnssec-signing) are
+ *       served without configuration database access during query processing.
+ *
  * \param[in] mod        Module context.
  * \param[in] item_name  Zone section item name.
  * \param[in] zone       Zone name.
@@ -379,6 +382,7 @@ typedef enum {
 	KNOTD_QUERY_FLAG_LIMIT_ANY  = 1 << 2, /*!< Limit ANY QTYPE (respond with TC=1). */
 	KNOTD_QUERY_FLAG_LIMIT_SIZE = 1 << 3, /*!< Apply UDP size limit. */
 	KNOTD_QUERY_FLAG_COOKIE     = 1 << 4, /*!< Valid DNS Cookie indication. */
+	KNOTD_QUERY_FLAG_BATCH      = 1 << 5, /*!< End stage processed for a batch of queries. */
 } knotd_query_flag_t;
 
 /*! Query processing data context parameters. */
@@ -484,6 +488,19 @@ typedef knotd_state_t (*knotd_mod_hook_f)
 typedef knotd_in_state_t (*knotd_mod_in_hook_f)
 	(knotd_in_state_t state, knot_pkt_t *pkt, knotd_qdata_t *qdata, knotd_mod_t *mod);
 
+/*!
+ * General processing hook for a batch of queries.
+ *
+ * \param[in,out] states  Current processing states, to be updated in place.
+ * \param[in,out] pkts    Response packets.
+ * \param[in] qdatas      Query data.
+ * \param[in] count       Number of queries in the batch.
+ * \param[in] mod         Module context.
+ */
+typedef void (*knotd_mod_batch_hook_f)
+	(knotd_state_t *states, knot_pkt_t **pkts, knotd_qdata_t **qdatas,
+	 unsigned count, knotd_mod_t *mod);
+
 /*!
  * Registers general processing module hook.
  *
@@ -495,6 +512,24 @@ typedef knotd_in_state_t (*knotd_mod_in_hook_f)
  */
 int knotd_mod_hook(knotd_mod_t *mod, knotd_stage_t stage, knotd_mod_hook_f hook);
 
+/*!
+ * Registers general processing module hook with a batch variant.
+ *
+ * The batch hook is used if the server processes more queries at once
+ * (e.g. a UDP recvmmsg() batch), otherwise the per-query hook is used.
+ *
+ * \note Only KNOTD_STAGE_END is processed in batches so far.
+ *
+ * \param[in] mod    Module context.
+ * \param[in] stage  Processing stage (KNOTD_STAGE_BEGIN or KNOTD_STAGE_END).
+ * \param[in] hook   Module hook.
+ * \param[in] batch  Module batch hook (optional).
+ *
+ * \return Error code, KNOT_EOK if success.
+ */
+int knotd_mod_batch_hook(knotd_mod_t *mod, knotd_stage_t stage, knotd_mod_hook_f hook,
+                         knotd_mod_batch_hook_f batch);
+
 /*!
  * Registers Internet class module hook.
  *
@@ -32,6 +32,7 @@ struct journal_read {
 	const knot_dname_t *zone;
 	wire_ctx_t wire;
 	uint32_t next;
+	bool zone_in_journal;
 };
 
 int journal_read_get_error(const journal_read_t *ctx, int another_error)
@@ -53,6 +54,7 @@ static bool go_next_changeset(journal_read_t *ctx, bool go_zone, const knot_dnam
 		return false;
 	}
 	ctx->next = journal_next_serial(&ctx->txn.cur_val);
+	ctx->zone_in_journal = go_zone;
 	update_ctx_wire(ctx);
 	return true;
 }
@@ -237,6 +239,86 @@ void journal_read_clear_changeset(changeset_t *ch)
 	memset(ch, 0, sizeof(*ch));
 }
 
+static uint32_t raw_soa_serial(const uint8_t *rdata, size_t len)
+{
+	wire_ctx_t wire = wire_ctx_init_const(rdata, len);
+	wire_ctx_skip(&wire, knot_dname_size(wire.position));
+	wire_ctx_skip(&wire, knot_dname_size(wire.position));
+	uint32_t serial = wire_ctx_read_u32(&wire);
+	return wire.error == KNOT_EOK ? serial : 0;
+}
+
+bool journal_read_skim(journal_read_t *ctx, journal_skim_cb_t cb, void *cb_ctx,
+                       journal_skim_t *skim)
+{
+	memset(skim, 0, sizeof(*skim));
+
+	bool first = true, in_remove = false;
+	while (ctx->txn.ret == KNOT_EOK) {
+		if (!make_data_available(ctx)) {
+			if (!first || !go_next_changeset(ctx, false, ctx->zone)) {
+				break;
+			}
+		}
+		if (first) {
+			skim->zone_in_journal = ctx->zone_in_journal;
+			in_remove = !ctx->zone_in_journal;
+		}
+
+		const uint8_t *owner = ctx->wire.position;
+		size_t owner_size = knot_dname_size(owner);
+		wire_ctx_skip(&ctx->wire, owner_size);
+		uint16_t type = wire_ctx_read_u16(&ctx->wire);
+		wire_ctx_skip(&ctx->wire, sizeof(uint16_t));
+		uint16_t rrs_count = wire_ctx_read_u16(&ctx->wire);
+		skim->size += owner_size + 3 * sizeof(uint16_t);
+
+		bool apex_soa = (type == KNOT_RRTYPE_SOA &&
+		                 ctx->wire.error == KNOT_EOK &&
+		                 knot_dname_is_equal(owner, ctx->zone));
+		if (apex_soa && !first) {
+			in_remove = false;
+		}
+
+		for (int i = 0; i < rrs_count && ctx->wire.error == KNOT_EOK; i++) {
+			if (!make_data_available(ctx)) {
+				ctx->wire.error = KNOT_EFEWDATA;
+				break;
+			}
+			wire_ctx_skip(&ctx->wire, sizeof(uint32_t));
+			uint16_t len = wire_ctx_read_u16(&ctx->wire);
+			if (apex_soa && i == 0 && ctx->wire.error == KNOT_EOK &&
+			    wire_ctx_available(&ctx->wire) >= len) {
+				uint32_t serial = raw_soa_serial(ctx->wire.position, len);
+				if (first && !skim->zone_in_journal) {
+					skim->serial_from = serial;
+				} else {
+					skim->serial_to = serial;
+				}
+			}
+			wire_ctx_skip(&ctx->wire, len);
+			skim->size += sizeof(uint32_t) + sizeof(uint16_t) + len;
+		}
+
+		if (ctx->wire.error != KNOT_EOK) {
+			ctx->txn.ret = ctx->wire.error == KNOT_ERANGE ? KNOT_EMALF : ctx->wire.error;
+			break;
+		}
+
+		if (in_remove) {
+			skim->remove_count += rrs_count;
+		} else {
+			skim->add_count += rrs_count;
+		}
+		if (cb != NULL) {
+			ctx->txn.ret = cb(in_remove, type, rrs_count, cb_ctx);
+		}
+		first = false;
+	}
+
+	return !first && ctx->txn.ret == KNOT_EOK;
+}
+
 static int just_load_md(zone_journal_t j, journal_metadata_t *md, bool *has_zij)
 {
 	knot_lmdb_txn_t txn = { 0 };
@@ -24,6 +24,20 @@ typedef int (*journal_read_cb_t)(bool in_remove_section, const knot_rrset_t *rr,
 
 typedef int (*journal_walk_cb_t)(bool special, const changeset_t *ch, void *ctx);
 
+typedef int (*journal_skim_cb_t)(bool in_remove_section, uint16_t type, uint16_t rr_count, void *ctx);
+
+/*!
+ * \brief Summary of a changeset obtained without decoding its records.
+ */
+typedef struct {
+	bool zone_in_journal;   //!< The changeset is a zone-in-journal.
+	uint32_t serial_from;   //!< SOA serial before the change (not for zone-in-journal).
+	uint32_t serial_to;     //!< SOA serial after the change.
+	size_t size;            //!< Serialized size in bytes.
+	size_t remove_count;    //!< Number of removed records including SOA.
+	size_t add_count;       //!< Number of added records including SOA.
+} journal_skim_t;
+
 /*!
  * \brief Start reading journal from specified changeset.
  *
@@ -90,6 +104,22 @@ bool journal_read_changeset(journal_read_t *ctx, changeset_t *ch);
  */
 void journal_read_clear_changeset(changeset_t *ch);
 
+/*!
+ * \brief Skim a single changeset from journal without decoding its records.
+ *
+ * This is much cheaper than journal_read_changeset() as neither the records
+ * nor the changeset trees are allocated.
+ *
+ * \param ctx      Journal reading context.
+ * \param cb       Optional callback to be called for each RRSet header.
+ * \param cb_ctx   Arbitrary context to be passed to the callback.
+ * \param skim     Output: the changeset summary.
+ *
+ * \return True if a changeset was skimmed, false if no more or error.
+ */
+bool journal_read_skim(journal_read_t *ctx, journal_skim_cb_t cb, void *cb_ctx,
+                       journal_skim_t *skim);
+
 /*!
  * \brief Obtain error code from the journal_read operations previously performed.
  *
@@ -14,10 +14,13 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <urcu.h>
+
 #include "libknot/libknot.h"
 #include "knot/nameserver/internet.h"
 #include "knot/nameserver/nsec_proofs.h"
 #include "knot/nameserver/query_module.h"
+#include "knot/nameserver/referral_cache.h"
 #include "knot/zone/serial.h"
 #include "contrib/mempattern.h"
 
@@ -144,11 +147,10 @@ static int put_answer(knot_pkt_t *pkt, uint16_t type, knotd_qdata_t *qdata)
 	int ret = KNOT_EOK;
 	switch (type) {
 	case KNOT_RRTYPE_ANY: /* Append all RRSets. */ {
-		conf_val_t val = conf_zone_get(conf(), C_DISABLE_ANY,
-		                               qdata->extra->zone->name);
 		/* If ANY not allowed, set TC bit. */
+		const zone_conf_cache_t *cache = rcu_dereference(qdata->extra->zone->conf_cache);
 		if ((qdata->params->flags & KNOTD_QUERY_FLAG_LIMIT_ANY) &&
-		    conf_bool(&val)) {
+		    cache->disable_any) {
 			knot_wire_set_tc(pkt->wire);
 			return KNOT_ESPACE;
 		}
@@ -185,13 +187,18 @@ static int put_authority_soa(knot_pkt_t *pkt, knotd_qdata_t *qdata,
 	                            KNOT_COMPR_HINT_NONE, KNOT_PF_NOTRUNC);
 }
 
-/*! \brief Put the delegation NS RRSet to the Authority section. */
-static int put_delegation(knot_pkt_t *pkt, knotd_qdata_t *qdata)
+/*! \brief Find closest delegation point. */
+static void find_delegation(knotd_qdata_t *qdata)
 {
-	/* Find closest delegation point. */
 	while (!(qdata->extra->node->flags & NODE_FLAGS_DELEG)) {
 		qdata->extra->node = node_parent(qdata->extra->node);
 	}
+}
+
+/*! \brief Put the delegation NS RRSet to the Authority section. */
+static int put_delegation(knot_pkt_t *pkt, knotd_qdata_t *qdata)
+{
+	find_delegation(qdata);
 
 	/* Insert NS record. */
 	knot_rrset_t rrset = node_rrset(qdata->extra->node, KNOT_RRTYPE_NS);
@@ -217,6 +224,9 @@ static int put_additional(knot_pkt_t *pkt, const knot_rrset_t *rr,
 
 	additional_t *additional = (additional_t *)rr->additional;
 
+	/* Same rotation as for the RRSets put by process_query_put_rr(). */
+	uint16_t rotate = conf()->cache.srv_ans_rotate ? knot_wire_get_id(qdata->query->wire) : 0;
+
 	/* Iterate over the additionals. */
 	for (uint16_t i = 0; i < additional->count; i++) {
 		glue_t *glue = &additional->glues[i];
@@ -230,6 +240,28 @@ static int put_additional(knot_pkt_t *pkt, const knot_rrset_t *rr,
 		uint16_t hint = knot_compr_hint(info, KNOT_COMPR_HINT_RDATA +
 		                                glue->ns_pos);
 		const zone_node_t *gluenode = glue_node(glue, qdata->extra->node);
+
+		/* Append pre-rendered glue pointing to the name in the RDATA. */
+		const glue_wire_t *glue_wire = gluenode->glue_wire;
+		if (glue_wire != NULL && hint >= KNOT_WIRE_HEADER_SIZE) {
+			const uint8_t *wire = glue_wire->data;
+			for (int k = 0; k < ar_type_count; ++k) {
+				uint16_t wire_len = glue_wire->len[k];
+				if (wire_len == 0) {
+					continue;
+				}
+				knot_rrset_t rrset = node_rrset(gluenode, ar_type_list[k]);
+				ret = knot_pkt_put_wire_rotate(pkt, hint, &rrset, wire,
+				                               wire_len, rotate, flags);
+				if (ret != KNOT_EOK) {
+					qdata->extra->incomplete = true;
+					break;
+				}
+				wire += wire_len;
+			}
+			continue;
+		}
+
 		knot_rrset_t rrsigs = node_rrset(gluenode, KNOT_RRTYPE_RRSIG);
 		for (int k = 0; k < ar_type_count; ++k) {
 			knot_rrset_t rrset = node_rrset(gluenode, ar_type_list[k]);
@@ -239,6 +271,7 @@ static int put_additional(knot_pkt_t *pkt, const knot_rrset_t *rr,
 			ret = process_query_put_rr(pkt, qdata, &rrset, &rrsigs,
 			                           hint, flags);
 			if (ret != KNOT_EOK) {
+				qdata->extra->incomplete = true;
 				break;
 			}
 		}
@@ -569,6 +602,20 @@ static int solve_additional_dnssec(int state, knot_pkt_t *pkt, knotd_qdata_t *qd
 	}
 }
 
+/*! \brief Checks if the referral can be answered from the worker cache. */
+static bool referral_cacheable(knot_pkt_t *pkt, knotd_qdata_t *qdata, bool with_dnssec)
+{
+	struct query_plan *plan = qdata->extra->zone->query_plan;
+
+	return qdata->extra->referral_cache != NULL &&
+	       pkt->sections[KNOT_ANSWER].count == 0 &&
+	       !query_plan_has_stage(plan, KNOTD_STAGE_AUTHORITY) &&
+	       !query_plan_has_stage(plan, KNOTD_STAGE_ADDITIONAL) &&
+	       !conf()->cache.srv_ans_rotate &&
+	       /* Proof of an insecure delegation depends on the QNAME. */
+	       (!with_dnssec || node_rrtype_exists(qdata->extra->node, KNOT_RRTYPE_DS));
+}
+
 /*! \brief Helper for internet_query repetitive code. */
 #define SOLVE_STEP(solver, state, context) \
 	state = (solver)(state, pkt, qdata, context); \
@@ -587,10 +634,8 @@ static int answer_query(knot_pkt_t *pkt, knotd_qdata_t *qdata)
 	bool with_dnssec = have_dnssec(qdata);
 
 	/* Resolve PREANSWER. */
-	if (plan != NULL) {
-		WALK_LIST(step, plan->stage[KNOTD_STAGE_PREANSWER]) {
-			SOLVE_STEP(step->process, state, step->ctx);
-		}
+	WALK_PLAN(step, plan, KNOTD_STAGE_PREANSWER) {
+		SOLVE_STEP(step->process, state, step->ctx);
 	}
 
 	/* Resolve ANSWER. */
@@ -599,22 +644,37 @@ static int answer_query(knot_pkt_t *pkt, knotd_qdata_t *qdata)
 	if (with_dnssec) {
 		SOLVE_STEP(solve_answer_dnssec, state, NULL);
 	}
-	if (plan != NULL) {
-		WALK_LIST(step, plan->stage[KNOTD_STAGE_ANSWER]) {
-			SOLVE_STEP(step->process, state, step->ctx);
-		}
+	WALK_PLAN(step, plan, KNOTD_STAGE_ANSWER) {
+		SOLVE_STEP(step->process, state, step->ctx);
 	}
 
 	/* Resolve AUTHORITY. */
 	knot_pkt_begin(pkt, KNOT_AUTHORITY);
+
+	/* Reuse the rendered referral from the same delegation point. */
+	bool cached_referral = false;
+	if (state == KNOTD_IN_STATE_DELEG) {
+		find_delegation(qdata);
+		cached_referral = referral_cacheable(pkt, qdata, with_dnssec);
+	}
+	if (cached_referral) {
+		int ret = referral_cache_get(qdata->extra->referral_cache, pkt,
+		                             qdata->extra->contents, qdata->extra->node,
+		                             with_dnssec);
+		if (ret == KNOT_EOK) {
+			knot_wire_set_rcode(pkt->wire, qdata->rcode);
+			return KNOT_STATE_DONE;
+		} else if (ret != KNOT_ENOENT && ret != KNOT_ESPACE) {
+			return KNOT_STATE_FAIL;
+		}
+	}
+
 	SOLVE_STEP(solve_authority, state, NULL);
 	if (with_dnssec) {
 		SOLVE_STEP(solve_authority_dnssec, state, NULL);
 	}
-	if (plan != NULL) {
-		WALK_LIST(step, plan->stage[KNOTD_STAGE_AUTHORITY]) {
-			SOLVE_STEP(step->process, state, step->ctx);
-		}
+	WALK_PLAN(step, plan, KNOTD_STAGE_AUTHORITY) {
+		SOLVE_STEP(step->process, state, step->ctx);
 	}
 
 	/* Resolve ADDITIONAL. */
@@ -623,10 +683,14 @@ static int answer_query(knot_pkt_t *pkt, knotd_qdata_t *qdata)
 	if (with_dnssec) {
 		SOLVE_STEP(solve_additional_dnssec, state, NULL);
 	}
-	if (plan != NULL) {
-		WALK_LIST(step, plan->stage[KNOTD_STAGE_ADDITIONAL]) {
-			SOLVE_STEP(step->process, state, step->ctx);
-		}
+	WALK_PLAN(step, plan, KNOTD_STAGE_ADDITIONAL) {
+		SOLVE_STEP(step->process, state, step->ctx);
+	}
+
+	if (cached_referral && state == KNOTD_IN_STATE_DELEG && !qdata->extra->incomplete) {
+		referral_cache_put(qdata->extra->referral_cache, pkt,
+		                   qdata->extra->contents, qdata->extra->node,
+		                   with_dnssec);
 	}
 
 	/* Write resulting RCODE. */
@@ -58,7 +58,7 @@ int internet_process_query(knot_pkt_t *pkt, knotd_qdata_t *qdata);
 
 /*! \brief Require authentication. */
 #define NS_NEED_AUTH(qdata, action) \
-	if (!process_query_acl_check(conf(), (action), (qdata)) || \
+	if (!process_query_acl_check((action), (qdata)) || \
 	    process_query_verify(qdata) != KNOT_EOK) { \
 		return KNOT_STATE_FAIL; \
 	}
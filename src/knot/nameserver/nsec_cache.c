@@ -0,0 +1,172 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "knot/nameserver/nsec_cache.h"
+#include "knot/dnssec/zone-nsec.h"
+#include "libdnssec/error.h"
+#include "libknot/error.h"
+
+/*! \brief Cached hash of one name. */
+typedef struct {
+	knot_dname_storage_t name;
+	uint8_t name_len;       /*!< Zero for an unused slot. */
+	uint8_t algorithm;
+	uint16_t iterations;
+	uint8_t salt_len;
+	uint8_t salt[NSEC_CACHE_SALT_MAX];
+	uint8_t hash_len;
+	uint8_t hash[NSEC_CACHE_HASH_MAX];
+} nsec3_cache_entry_t;
+
+/*! \brief Cached wildcard non-existence proof. */
+typedef struct {
+	uint64_t generation;    /*!< Zero for an unused slot. */
+	const zone_node_t *encloser;
+	const zone_node_t *proof;
+} wildcard_cache_entry_t;
+
+struct nsec_cache {
+	nsec3_cache_entry_t hashes[NSEC_CACHE_NSEC3_SIZE];
+	wildcard_cache_entry_t wildcards[NSEC_CACHE_WILDCARD_SIZE];
+};
+
+nsec_cache_t *nsec_cache_new(void)
+{
+	return calloc(1, sizeof(nsec_cache_t));
+}
+
+void nsec_cache_free(nsec_cache_t *cache)
+{
+	free(cache);
+}
+
+static nsec3_cache_entry_t *get_hash_slot(nsec_cache_t *cache, const knot_dname_t *name,
+                                          size_t name_len, uint16_t iterations)
+{
+	// FNV-1a, collisions only cause evictions.
+	uint32_t h = 2166136261u ^ iterations;
+	for (size_t i = 0; i < name_len; i++) {
+		h = (h ^ name[i]) * 16777619u;
+	}
+
+	return &cache->hashes[h % NSEC_CACHE_NSEC3_SIZE];
+}
+
+static bool entry_match(const nsec3_cache_entry_t *entry, const knot_dname_t *name,
+                        size_t name_len, const dnssec_nsec3_params_t *params)
+{
+	return entry->name_len == name_len &&
+	       entry->algorithm == params->algorithm &&
+	       entry->iterations == params->iterations &&
+	       entry->salt_len == params->salt.size &&
+	       (params->salt.size == 0 ||
+	        memcmp(entry->salt, params->salt.data, params->salt.size) == 0) &&
+	       memcmp(entry->name, name, name_len) == 0;
+}
+
+int nsec_cache_nsec3_owner(nsec_cache_t *cache, uint8_t *out, size_t out_size,
+                           const knot_dname_t *owner, const knot_dname_t *zone_apex,
+                           const dnssec_nsec3_params_t *params)
+{
+	if (out == NULL || owner == NULL || zone_apex == NULL || params == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	if (cache == NULL || params->salt.size > NSEC_CACHE_SALT_MAX) {
+		return knot_create_nsec3_owner(out, out_size, owner, zone_apex, params);
+	}
+
+	size_t name_len = knot_dname_size(owner);
+	nsec3_cache_entry_t *entry = get_hash_slot(cache, owner, name_len, params->iterations);
+	if (entry_match(entry, owner, name_len, params)) {
+		return knot_nsec3_hash_to_dname(out, out_size, entry->hash,
+		                                entry->hash_len, zone_apex);
+	}
+
+	dnssec_binary_t data = {
+		.data = (uint8_t *)owner,
+		.size = name_len
+	};
+
+	dnssec_binary_t hash = { 0 };
+
+	int ret = dnssec_nsec3_hash(&data, params, &hash);
+	if (ret != DNSSEC_EOK) {
+		return knot_error_from_libdnssec(ret);
+	}
+
+	ret = knot_nsec3_hash_to_dname(out, out_size, hash.data, hash.size, zone_apex);
+
+	// Replace the slot content.
+	if (ret == KNOT_EOK && hash.size <= NSEC_CACHE_HASH_MAX) {
+		memcpy(entry->name, owner, name_len);
+		entry->name_len = name_len;
+		entry->algorithm = params->algorithm;
+		entry->iterations = params->iterations;
+		entry->salt_len = params->salt.size;
+		if (params->salt.size > 0) {
+			memcpy(entry->salt, params->salt.data, params->salt.size);
+		}
+		entry->hash_len = hash.size;
+		memcpy(entry->hash, hash.data, hash.size);
+	}
+
+	dnssec_binary_free(&hash);
+
+	return ret;
+}
+
+static wildcard_cache_entry_t *get_wildcard_slot(nsec_cache_t *cache,
+                                                 const zone_node_t *encloser)
+{
+	// Nodes are allocated at least 8-byte aligned.
+	uint64_t h = ((uintptr_t)encloser >> 3) * 0x9E3779B97F4A7C15ull;
+
+	return &cache->wildcards[(h >> 32) % NSEC_CACHE_WILDCARD_SIZE];
+}
+
+const zone_node_t *nsec_cache_wildcard_get(nsec_cache_t *cache,
+                                           const zone_contents_t *zone,
+                                           const zone_node_t *encloser)
+{
+	if (cache == NULL || zone == NULL || encloser == NULL) {
+		return NULL;
+	}
+
+	wildcard_cache_entry_t *entry = get_wildcard_slot(cache, encloser);
+	if (entry->generation != zone->generation || entry->encloser != encloser) {
+		return NULL;
+	}
+
+	return entry->proof;
+}
+
+void nsec_cache_wildcard_put(nsec_cache_t *cache, const zone_contents_t *zone,
+                             const zone_node_t *encloser, const zone_node_t *proof)
+{
+	if (cache == NULL || zone == NULL || encloser == NULL || proof == NULL) {
+		return;
+	}
+
+	wildcard_cache_entry_t *entry = get_wildcard_slot(cache, encloser);
+	entry->generation = zone->generation;
+	entry->encloser = encloser;
+	entry->proof = proof;
+}
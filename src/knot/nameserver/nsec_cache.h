@@ -0,0 +1,107 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libdnssec/nsec.h"
+#include "libknot/dname.h"
+#include "knot/zone/contents.h"
+
+/*! \brief Number of cached NSEC3 hashes. */
+#define NSEC_CACHE_NSEC3_SIZE	512
+/*! \brief Number of cached wildcard proofs. */
+#define NSEC_CACHE_WILDCARD_SIZE	1024
+/*! \brief Maximal salt length of cacheable hashes. */
+#define NSEC_CACHE_SALT_MAX	32
+/*! \brief Maximal raw hash length. */
+#define NSEC_CACHE_HASH_MAX	32
+
+/*!
+ * \brief Per-worker cache of denial of existence proof data.
+ *
+ * Denial of existence in NSEC3 zones requires hashing of the next closer
+ * name for each answer. The cache remembers the hashes of recently proven
+ * names, so repeated queries for the same non-existent name don't repeat
+ * the iterated hashing.
+ *
+ * Both NSEC and NSEC3 negative answers also prove that no wildcard exists
+ * at the closest encloser, which depends only on the encloser. The covering
+ * node is remembered per encloser and zone contents generation.
+ *
+ * Unlike referrals (see referral_cache.h), the rendered AUTHORITY section
+ * isn't cached, as the record covering the QNAME (or its next closer name)
+ * differs for each non-existent name.
+ *
+ * The cache is not thread-safe, each worker owns one.
+ */
+typedef struct nsec_cache nsec_cache_t;
+
+/*!
+ * \brief Allocates an empty cache.
+ *
+ * \return Cache or NULL if not enough memory.
+ */
+nsec_cache_t *nsec_cache_new(void);
+
+/*!
+ * \brief Deallocates the cache.
+ */
+void nsec_cache_free(nsec_cache_t *cache);
+
+/*!
+ * \brief Creates NSEC3 owner name for the given name, using the cache.
+ *
+ * This is a drop-in replacement for knot_create_nsec3_owner().
+ *
+ * \param cache      Cache (may be NULL, then no caching is done).
+ * \param out        Output buffer.
+ * \param out_size   Size of the output buffer.
+ * \param owner      Name to be hashed.
+ * \param zone_apex  Zone apex name.
+ * \param params     NSEC3 parameters.
+ *
+ * \return KNOT_E*
+ */
+int nsec_cache_nsec3_owner(nsec_cache_t *cache, uint8_t *out, size_t out_size,
+                           const knot_dname_t *owner, const knot_dname_t *zone_apex,
+                           const dnssec_nsec3_params_t *params);
+
+/*!
+ * \brief Gets the cached node proving wildcard non-existence at the encloser.
+ *
+ * \param cache     Cache (may be NULL).
+ * \param zone      Zone contents.
+ * \param encloser  Closest (provable) encloser.
+ *
+ * \return NSEC or NSEC3 node or NULL if not cached.
+ */
+const zone_node_t *nsec_cache_wildcard_get(nsec_cache_t *cache,
+                                           const zone_contents_t *zone,
+                                           const zone_node_t *encloser);
+
+/*!
+ * \brief Stores the node proving wildcard non-existence at the encloser.
+ *
+ * \param cache     Cache (may be NULL).
+ * \param zone      Zone contents.
+ * \param encloser  Closest (provable) encloser.
+ * \param proof     NSEC or NSEC3 node covering the wildcard.
+ */
+void nsec_cache_wildcard_put(nsec_cache_t *cache, const zone_contents_t *zone,
+                             const zone_node_t *encloser, const zone_node_t *proof);
@@ -19,6 +19,7 @@
 #include "libknot/libknot.h"
 #include "knot/nameserver/nsec_proofs.h"
 #include "knot/nameserver/internet.h"
+#include "knot/nameserver/nsec_cache.h"
 #include "knot/dnssec/zone-nsec.h"
 
 /*!
@@ -172,34 +173,31 @@ static int put_nsec3_from_node(const zone_node_t *node,
 }
 
 /*!
- * \brief Find NSEC for given name and put it into the response.
+ * \brief Find NSEC for given name.
  *
  * Note this function allows the name to match the QNAME. The NODATA proof
  * for empty non-terminal is equivalent to NXDOMAIN proof, except that the
  * names may exist. This is why.
  */
-static int put_covering_nsec(const zone_contents_t *zone,
-                             const knot_dname_t *name,
-                             knotd_qdata_t *qdata,
-                             knot_pkt_t *resp)
+static int find_covering_nsec(const zone_contents_t *zone,
+                              const knot_dname_t *name,
+                              const zone_node_t **proof)
 {
 	const zone_node_t *match = NULL;
 	const zone_node_t *closest = NULL;
 	const zone_node_t *prev = NULL;
 
-	const zone_node_t *proof = NULL;
-
 	int ret = zone_contents_find_dname(zone, name, &match, &closest, &prev);
 	if (ret == ZONE_NAME_FOUND) {
-		proof = match;
+		*proof = match;
 	} else if (ret == ZONE_NAME_NOT_FOUND) {
-		proof = nsec_previous(prev);
+		*proof = nsec_previous(prev);
 	} else {
 		assert(ret < 0);
 		return ret;
 	}
 
-	return put_nsec_from_node(proof, qdata, resp);
+	return KNOT_EOK;
 }
 
 /*!
@@ -210,15 +208,25 @@ static int put_covering_nsec3(const zone_contents_t *zone,
                               knotd_qdata_t *qdata,
                               knot_pkt_t *resp)
 {
-	const zone_node_t *prev = NULL;
-	const zone_node_t *node = NULL;
+	// ignore if missing
+	if (zone_tree_is_empty(zone->nsec3_nodes) || !knot_is_nsec3_enabled(zone)) {
+		return KNOT_EOK;
+	}
 
-	int match = zone_contents_find_nsec3_for_name(zone, name, &node, &prev);
-	if (match < 0) {
-		// ignore if missing
+	// Repeated names are hashed only once per worker.
+	knot_dname_storage_t nsec3_name;
+	int ret = nsec_cache_nsec3_owner(qdata->extra->nsec_cache, nsec3_name,
+	                                 sizeof(nsec3_name), name, zone->apex->owner,
+	                                 &zone->nsec3_params);
+	if (ret != KNOT_EOK) {
 		return KNOT_EOK;
 	}
 
+	const zone_node_t *prev = NULL;
+	const zone_node_t *node = NULL;
+
+	int match = zone_contents_find_nsec3(zone, nsec3_name, &node, &prev);
+
 	if (match == ZONE_NAME_FOUND || prev == NULL){
 		return KNOT_ERROR;
 	}
@@ -393,16 +401,26 @@ static int put_nsec_nxdomain(const zone_contents_t *zone,
 
 	// NOTE: closest may be empty non-terminal and thus not authoritative.
 
-	size_t size = knot_dname_size(closest->owner);
-	if (size > KNOT_DNAME_MAXLEN - 2) {
-		return KNOT_EINVAL;
+	nsec_cache_t *cache = qdata->extra->nsec_cache;
+	const zone_node_t *proof = nsec_cache_wildcard_get(cache, zone, closest);
+	if (proof == NULL) {
+		size_t size = knot_dname_size(closest->owner);
+		if (size > KNOT_DNAME_MAXLEN - 2) {
+			return KNOT_EINVAL;
+		}
+		assert(size > 0);
+		uint8_t wildcard[2 + size];
+		memcpy(wildcard, "\x01""*", 2);
+		memcpy(wildcard + 2, closest->owner, size);
+
+		ret = find_covering_nsec(zone, wildcard, &proof);
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+		nsec_cache_wildcard_put(cache, zone, closest, proof);
 	}
-	assert(size > 0);
-	uint8_t wildcard[2 + size];
-	memcpy(wildcard, "\x01""*", 2);
-	memcpy(wildcard + 2, closest->owner, size);
 
-	return put_covering_nsec(zone, wildcard, qdata, resp);
+	return put_nsec_from_node(proof, qdata, resp);
 }
 
 /*!
@@ -439,10 +457,15 @@ static int put_nsec3_nxdomain(const knot_dname_t *qname,
 
 	// NSEC3 covering the (nonexistent) wildcard at the closest encloser.
 
-	const zone_node_t *nsec3_wildcard_prev, *ignored;
-	if (cpe->nsec3_wildcard_name == NULL ||
-	    zone_contents_find_nsec3(zone, cpe->nsec3_wildcard_name, &ignored, &nsec3_wildcard_prev) == ZONE_NAME_FOUND) {
-		return KNOT_ERROR;
+	nsec_cache_t *cache = qdata->extra->nsec_cache;
+	const zone_node_t *nsec3_wildcard_prev = nsec_cache_wildcard_get(cache, zone, cpe);
+	if (nsec3_wildcard_prev == NULL) {
+		const zone_node_t *ignored;
+		if (cpe->nsec3_wildcard_name == NULL ||
+		    zone_contents_find_nsec3(zone, cpe->nsec3_wildcard_name, &ignored, &nsec3_wildcard_prev) == ZONE_NAME_FOUND) {
+			return KNOT_ERROR;
+		}
+		nsec_cache_wildcard_put(cache, zone, cpe, nsec3_wildcard_prev);
 	}
 
 	return put_nsec3_from_node(nsec3_wildcard_prev, qdata, resp);
@@ -91,6 +91,8 @@ static int process_query_reset(knot_layer_t *ctx)
 	/* Remember persistent parameters. */
 	knotd_qdata_params_t *params = qdata->params;
 	knotd_qdata_extra_t *extra = qdata->extra;
+	nsec_cache_t *nsec_cache = extra->nsec_cache;
+	referral_cache_t *referral_cache = extra->referral_cache;
 
 	/* Free allocated data. */
 	knot_rrset_clear(&qdata->opt_rr, qdata->mm);
@@ -102,6 +104,8 @@ static int process_query_reset(knot_layer_t *ctx)
 
 	/* Initialize persistent data. */
 	query_data_init(ctx, params, extra);
+	extra->nsec_cache = nsec_cache;
+	extra->referral_cache = referral_cache;
 
 	/* Await packet. */
 	return KNOT_STATE_CONSUME;
@@ -230,6 +234,27 @@ static int answer_edns_reserve(knot_pkt_t *resp, knotd_qdata_t *qdata)
 	return knot_pkt_reserve(resp, knot_edns_wire_size(&qdata->opt_rr));
 }
 
+/*! \brief Initializes the response OPT RR with prebuilt server options. */
+static int answer_edns_opt_init(knot_rrset_t *opt_rr, uint16_t max_payload,
+                                const uint8_t *options, uint16_t options_len,
+                                knot_mm_t *mm)
+{
+	knot_dname_t *owner = knot_dname_copy((const uint8_t *)"", mm);
+	if (owner == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	knot_rrset_init(opt_rr, owner, KNOT_RRTYPE_OPT, max_payload, 0);
+
+	/* Single allocation, the options are copied as is. */
+	int ret = knot_rrset_add_rdata(opt_rr, options, options_len, mm);
+	if (ret == KNOT_EOK) {
+		knot_edns_set_version(opt_rr, KNOT_EDNS_VERSION);
+	}
+
+	return ret;
+}
+
 static int answer_edns_init(const knot_pkt_t *query, knot_pkt_t *resp,
                             knotd_qdata_t *qdata)
 {
@@ -249,8 +274,17 @@ static int answer_edns_init(const knot_pkt_t *query, knot_pkt_t *resp,
 	default:
 		return KNOT_ERROR;
 	}
-	int ret = knot_edns_init(&qdata->opt_rr, max_payload, 0,
-	                         KNOT_EDNS_VERSION, qdata->mm);
+
+	/* Append NSID if requested and available. */
+	const uint8_t *options = NULL;
+	uint16_t options_len = 0;
+	if (knot_pkt_edns_option(query, KNOT_EDNS_OPTION_NSID) != NULL) {
+		options = conf()->cache.srv_nsid_opt;
+		options_len = conf()->cache.srv_nsid_opt_len;
+	}
+
+	int ret = answer_edns_opt_init(&qdata->opt_rr, max_payload, options,
+	                               options_len, qdata->mm);
 	if (ret != KNOT_EOK) {
 		return ret;
 	}
@@ -265,32 +299,6 @@ static int answer_edns_init(const knot_pkt_t *query, knot_pkt_t *resp,
 		knot_edns_set_do(&qdata->opt_rr);
 	}
 
-	/* Append NSID if requested and available. */
-	if (knot_pkt_edns_option(query, KNOT_EDNS_OPTION_NSID) != NULL) {
-		conf_val_t *nsid = &conf()->cache.srv_nsid;
-		size_t nsid_len;
-		const uint8_t *nsid_data = conf_bin(nsid, &nsid_len);
-
-		if (nsid->code != KNOT_EOK) {
-			ret = knot_edns_add_option(&qdata->opt_rr,
-			                           KNOT_EDNS_OPTION_NSID,
-			                           strlen(conf()->hostname),
-			                           (uint8_t *)conf()->hostname,
-			                           qdata->mm);
-			if (ret != KNOT_EOK) {
-				return ret;
-			}
-		} else if (nsid_len > 0) {
-			ret = knot_edns_add_option(&qdata->opt_rr,
-			                           KNOT_EDNS_OPTION_NSID,
-			                           nsid_len, nsid_data,
-			                           qdata->mm);
-			if (ret != KNOT_EOK) {
-				return ret;
-			}
-		}
-	}
-
 	/* Initialize EDNS Client Subnet if configured and present in query. */
 	if (conf()->cache.srv_ecs) {
 		uint8_t *ecs_opt = knot_pkt_edns_option(query, KNOT_EDNS_OPTION_CLIENT_SUBNET);
@@ -489,22 +497,18 @@ static int process_query_err(knot_layer_t *ctx, knot_pkt_t *pkt)
 }
 
 #define PROCESS_BEGIN(plan, step, next_state, qdata) \
-	if (plan != NULL) { \
-		WALK_LIST(step, plan->stage[KNOTD_STAGE_BEGIN]) { \
-			next_state = step->process(next_state, pkt, qdata, step->ctx); \
-			if (next_state == KNOT_STATE_FAIL) { \
-				goto finish; \
-			} \
+	WALK_PLAN(step, plan, KNOTD_STAGE_BEGIN) { \
+		next_state = step->process(next_state, pkt, qdata, step->ctx); \
+		if (next_state == KNOT_STATE_FAIL) { \
+			goto finish; \
 		} \
 	}
 
 #define PROCESS_END(plan, step, next_state, qdata) \
-	if (plan != NULL) { \
-		WALK_LIST(step, plan->stage[KNOTD_STAGE_END]) { \
-			next_state = step->process(next_state, pkt, qdata, step->ctx); \
-			if (next_state == KNOT_STATE_FAIL) { \
-				next_state = process_query_err(ctx, pkt); \
-			} \
+	WALK_PLAN(step, plan, KNOTD_STAGE_END) { \
+		next_state = step->process(next_state, pkt, qdata, step->ctx); \
+		if (next_state == KNOT_STATE_FAIL) { \
+			next_state = process_query_err(ctx, pkt); \
 		} \
 	}
 
@@ -600,17 +604,182 @@ finish:
 		set_rcode_to_packet(pkt, qdata);
 	}
 
-	/* After query processing code. */
-	PROCESS_END(plan, step, next_state, qdata);
-	PROCESS_END(zone_plan, step, next_state, qdata);
+	/* After query processing code (possibly postponed to batch processing). */
+	if (qdata->params->flags & KNOTD_QUERY_FLAG_BATCH) {
+		qdata->extra->end_pending = true;
+	} else {
+		PROCESS_END(plan, step, next_state, qdata);
+		PROCESS_END(zone_plan, step, next_state, qdata);
+	}
 
 	rcu_read_unlock();
 
 	return next_state;
 }
 
-bool process_query_acl_check(conf_t *conf, acl_action_t action,
-                             knotd_qdata_t *qdata)
+/*! \brief Queries with postponed end stage processing. */
+typedef struct {
+	knot_layer_t **layers;
+	knot_pkt_t **pkts;
+	knotd_qdata_t **qdatas;
+	knotd_state_t *states;
+	unsigned count;
+} query_batch_t;
+
+static int batch_init(query_batch_t *batch, knot_mm_t *mm, unsigned count)
+{
+	batch->layers = mm_alloc(mm, count * sizeof(*batch->layers));
+	batch->pkts = mm_alloc(mm, count * sizeof(*batch->pkts));
+	batch->qdatas = mm_alloc(mm, count * sizeof(*batch->qdatas));
+	batch->states = mm_alloc(mm, count * sizeof(*batch->states));
+	batch->count = 0;
+
+	if (batch->layers == NULL || batch->pkts == NULL ||
+	    batch->qdatas == NULL || batch->states == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	return KNOT_EOK;
+}
+
+static void batch_add(query_batch_t *batch, knot_layer_t *layer,
+                      knot_pkt_t *pkt, knotd_state_t state)
+{
+	batch->layers[batch->count] = layer;
+	batch->pkts[batch->count] = pkt;
+	batch->qdatas[batch->count] = QUERY_DATA(layer);
+	batch->states[batch->count] = state;
+	batch->count++;
+}
+
+static struct query_plan *batch_zone_plan(knotd_qdata_t *qdata)
+{
+	const zone_t *zone = qdata->extra->zone;
+	return (zone != NULL) ? zone->query_plan : NULL;
+}
+
+/*! \brief Process the postponed end stage of a single query. */
+static void query_end(knot_layer_t *ctx, knot_pkt_t *pkt)
+{
+	knotd_qdata_t *qdata = QUERY_DATA(ctx);
+	struct query_step *step = NULL;
+
+	int next_state = ctx->state;
+	PROCESS_END(conf()->query_plan, step, next_state, qdata);
+	PROCESS_END(batch_zone_plan(qdata), step, next_state, qdata);
+	ctx->state = (knot_layer_state_t)next_state;
+}
+
+static void batch_process_end(struct query_plan *plan, query_batch_t *batch)
+{
+	struct query_step *step = NULL;
+	WALK_PLAN(step, plan, KNOTD_STAGE_END) {
+		if (step->batch != NULL) {
+			step->batch(batch->states, batch->pkts, batch->qdatas,
+			            batch->count, step->ctx);
+		} else {
+			for (unsigned i = 0; i < batch->count; i++) {
+				batch->states[i] = (knotd_state_t)step->process(batch->states[i],
+				                                                batch->pkts[i],
+				                                                batch->qdatas[i],
+				                                                step->ctx);
+			}
+		}
+
+		for (unsigned i = 0; i < batch->count; i++) {
+			if (batch->states[i] == KNOTD_STATE_FAIL) {
+				batch->states[i] = (knotd_state_t)process_query_err(batch->layers[i],
+				                                                    batch->pkts[i]);
+			}
+		}
+	}
+}
+
+void process_query_batch_end(knot_layer_t *layers, knot_pkt_t **pkts,
+                             unsigned count)
+{
+	if (layers == NULL || pkts == NULL || count == 0) {
+		return;
+	}
+
+	knot_mm_t *mm = layers[0].mm;
+
+	/* Collect the queries with postponed end stage. */
+	query_batch_t all, zone;
+	if (batch_init(&all, mm, count) != KNOT_EOK ||
+	    batch_init(&zone, mm, count) != KNOT_EOK) {
+		/* Fall back to processing the queries one by one. */
+		rcu_read_lock();
+		for (unsigned i = 0; i < count; i++) {
+			knotd_qdata_t *qdata = QUERY_DATA(&layers[i]);
+			if (qdata != NULL && qdata->extra->end_pending) {
+				qdata->extra->end_pending = false;
+				query_end(&layers[i], pkts[i]);
+			}
+		}
+		rcu_read_unlock();
+		return;
+	}
+	for (unsigned i = 0; i < count; i++) {
+		knotd_qdata_t *qdata = QUERY_DATA(&layers[i]);
+		if (qdata != NULL && qdata->extra->end_pending) {
+			qdata->extra->end_pending = false;
+			batch_add(&all, &layers[i], pkts[i], (knotd_state_t)layers[i].state);
+		}
+	}
+	if (all.count == 0) {
+		return;
+	}
+
+	rcu_read_lock();
+
+	/* Process the global query plan for all the queries at once. */
+	batch_process_end(conf()->query_plan, &all);
+
+	/* Process the zone query plans for queries from the same zone at once. */
+	bool done[all.count];
+	unsigned idx[all.count];
+	memset(done, 0, sizeof(done));
+	for (unsigned i = 0; i < all.count; i++) {
+		struct query_plan *plan = batch_zone_plan(all.qdatas[i]);
+		if (done[i] || plan == NULL) {
+			continue;
+		}
+
+		zone.count = 0;
+		for (unsigned j = i; j < all.count; j++) {
+			if (!done[j] && batch_zone_plan(all.qdatas[j]) == plan) {
+				done[j] = true;
+				idx[zone.count] = j;
+				batch_add(&zone, all.layers[j], all.pkts[j], all.states[j]);
+			}
+		}
+
+		batch_process_end(plan, &zone);
+
+		for (unsigned j = 0; j < zone.count; j++) {
+			all.states[idx[j]] = zone.states[j];
+		}
+	}
+
+	rcu_read_unlock();
+
+	for (unsigned i = 0; i < all.count; i++) {
+		all.layers[i]->state = (knot_layer_state_t)all.states[i];
+	}
+}
+
+void process_query_set_caches(knot_layer_t *ctx, nsec_cache_t *nsec_cache,
+                              referral_cache_t *referral_cache)
+{
+	assert(ctx && ctx->data);
+
+	knotd_qdata_extra_t *extra = QUERY_DATA(ctx)->extra;
+	extra->nsec_cache = nsec_cache;
+	extra->referral_cache = referral_cache;
+}
+
+bool process_query_acl_check(acl_action_t action, knotd_qdata_t *qdata)
 {
 	const knot_dname_t *zone_name = qdata->extra->zone->name;
 	knot_pkt_t *query = qdata->query;
@@ -628,9 +797,9 @@ bool process_query_acl_check(conf_t *conf, acl_action_t action,
 		tsig.algorithm = knot_tsig_rdata_alg(query->tsig_rr);
 	}
 
-	/* Check if authenticated. */
-	conf_val_t acl = conf_zone_get(conf, C_ACL, zone_name);
-	if (!acl_allowed(conf, &acl, action, query_source, &tsig, zone_name, query)) {
+	/* Check if authenticated (the ACL rules are cached in the zone). */
+	const zone_conf_cache_t *cache = rcu_dereference(qdata->extra->zone->conf_cache);
+	if (!acl_allowed(cache->acl, action, query_source, &tsig, zone_name, query)) {
 		char addr_str[SOCKADDR_STRLEN] = { 0 };
 		sockaddr_tostr(addr_str, sizeof(addr_str), (struct sockaddr *)query_source);
 		const knot_lookup_t *act = knot_lookup_by_id((knot_lookup_t *)acl_actions,
@@ -17,6 +17,8 @@
 #pragma once
 
 #include "knot/include/module.h"
+#include "knot/nameserver/nsec_cache.h"
+#include "knot/nameserver/referral_cache.h"
 #include "knot/query/layer.h"
 #include "knot/updates/acl.h"
 #include "knot/zone/zone.h"
@@ -24,6 +26,34 @@
 /* Query processing module implementation. */
 const knot_layer_api_t *process_query_layer(void);
 
+/*!
+ * \brief Finish query processing of a batch of queries.
+ *
+ * Processes the end stage, which is postponed for queries with
+ * KNOTD_QUERY_FLAG_BATCH, using the module batch hooks where available.
+ *
+ * \note The layers are expected to share one memory context.
+ *
+ * \param layers  Query processing layers.
+ * \param pkts    Response packets.
+ * \param count   Number of queries in the batch.
+ */
+void process_query_batch_end(knot_layer_t *layers, knot_pkt_t **pkts,
+                             unsigned count);
+
+/*!
+ * \brief Set the worker caches used for answering the queries.
+ *
+ * \note Must be called after the layer begin, the caches are kept until
+ *       the layer finish.
+ *
+ * \param ctx             Query processing layer.
+ * \param nsec_cache      Denial proof cache (optional).
+ * \param referral_cache  Referral cache (optional).
+ */
+void process_query_set_caches(knot_layer_t *ctx, nsec_cache_t *nsec_cache,
+                              referral_cache_t *referral_cache);
+
 /*! \brief Query processing intermediate data. */
 typedef struct knotd_qdata_extra {
 	const zone_t *zone;  /*!< Zone from which is answered. */
@@ -31,6 +61,12 @@ typedef struct knotd_qdata_extra {
 	list_t wildcards;    /*!< Visited wildcards. */
 	list_t rrsigs;       /*!< Section RRSIGs. */
 	uint8_t *opt_rr_pos; /*!< Place of the OPT RR in wire. */
+	bool end_pending;    /*!< End stage postponed to batch processing. */
+	bool incomplete;     /*!< Some optional additional records were omitted. */
+
+	/* Worker caches (optional), kept on processing reset. */
+	nsec_cache_t *nsec_cache;         /*!< Denial proof cache. */
+	referral_cache_t *referral_cache; /*!< Referral cache. */
 
 	/* Currently processed nodes. */
 	const zone_node_t *node, *encloser, *previous;
@@ -61,13 +97,11 @@ struct rrsig_info {
 /*!
  * \brief Check current query against ACL.
  *
- * \param conf       Configuration.
  * \param action     ACL action.
  * \param qdata      Query data.
  * \return true if accepted, false if denied.
  */
-bool process_query_acl_check(conf_t *conf, acl_action_t action,
-                             knotd_qdata_t *qdata);
+bool process_query_acl_check(acl_action_t action, knotd_qdata_t *qdata);
 
 /*!
  * \brief Verify current query transaction security and update query data.
@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <urcu.h>
 
 #include "contrib/sockaddr.h"
 #include "libknot/attribute.h"
@@ -29,6 +30,7 @@
 #include "knot/dnssec/zone-sign.h"
 #include "knot/nameserver/query_module.h"
 #include "knot/nameserver/process_query.h"
+#include "knot/zone/zone.h"
 
 #ifdef HAVE_ATOMIC
  #define ATOMIC_ADD(dst, val) __atomic_add_fetch(&(dst), (val), __ATOMIC_RELAXED)
@@ -49,16 +51,7 @@ int knotd_conf_check_ref(knotd_conf_check_args_t *args)
 
 struct query_plan *query_plan_create(void)
 {
-	struct query_plan *plan = malloc(sizeof(struct query_plan));
-	if (plan == NULL) {
-		return NULL;
-	}
-
-	for (unsigned i = 0; i < KNOTD_STAGES; ++i) {
-		init_list(&plan->stage[i]);
-	}
-
-	return plan;
+	return calloc(1, sizeof(struct query_plan));
 }
 
 void query_plan_free(struct query_plan *plan)
@@ -68,37 +61,42 @@ void query_plan_free(struct query_plan *plan)
 	}
 
 	for (unsigned i = 0; i < KNOTD_STAGES; ++i) {
-		struct query_step *step = NULL, *next = NULL;
-		WALK_LIST_DELSAFE(step, next, plan->stage[i]) {
-			free(step);
-		}
+		free(plan->stage[i]);
 	}
 
 	free(plan);
 }
 
-static struct query_step *make_step(query_step_process_f process, void *ctx)
+int query_plan_step(struct query_plan *plan, knotd_stage_t stage,
+                    query_step_process_f process, void *ctx)
 {
-	struct query_step *step = calloc(1, sizeof(struct query_step));
-	if (step == NULL) {
-		return NULL;
-	}
-
-	step->process = process;
-	step->ctx = ctx;
-
-	return step;
+	return query_plan_batch_step(plan, stage, process, NULL, ctx);
 }
 
-int query_plan_step(struct query_plan *plan, knotd_stage_t stage,
-                    query_step_process_f process, void *ctx)
+int query_plan_batch_step(struct query_plan *plan, knotd_stage_t stage,
+                          query_step_process_f process,
+                          knotd_mod_batch_hook_f batch, void *ctx)
 {
-	struct query_step *step = make_step(process, ctx);
-	if (step == NULL) {
+	if (plan == NULL || stage >= KNOTD_STAGES || process == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	/* Grow the stage array, keeping space for the terminating step. */
+	unsigned count = plan->stage_count[stage];
+	struct query_step *steps = realloc(plan->stage[stage],
+	                                   (count + 2) * sizeof(*steps));
+	if (steps == NULL) {
 		return KNOT_ENOMEM;
 	}
 
-	add_tail(&plan->stage[stage], &step->node);
+	steps[count].process = process;
+	steps[count].batch = batch;
+	steps[count].ctx = ctx;
+	memset(&steps[count + 1], 0, sizeof(*steps));
+
+	plan->stage[stage] = steps;
+	plan->stage_count[stage] = count + 1;
+	plan->stage_mask |= (1U << stage);
 
 	return KNOT_EOK;
 }
@@ -113,6 +111,17 @@ int knotd_mod_hook(knotd_mod_t *mod, knotd_stage_t stage, knotd_mod_hook_f hook)
 	return query_plan_step(mod->plan, stage, hook, mod);
 }
 
+_public_
+int knotd_mod_batch_hook(knotd_mod_t *mod, knotd_stage_t stage, knotd_mod_hook_f hook,
+                         knotd_mod_batch_hook_f batch)
+{
+	if (stage != KNOTD_STAGE_BEGIN && stage != KNOTD_STAGE_END) {
+		return KNOT_EINVAL;
+	}
+
+	return query_plan_batch_step(mod->plan, stage, hook, batch, mod);
+}
+
 _public_
 int knotd_mod_in_hook(knotd_mod_t *mod, knotd_stage_t stage, knotd_mod_in_hook_f hook)
 {
@@ -469,6 +478,26 @@ knotd_conf_t knotd_conf_mod(knotd_mod_t *mod, const yp_name_t *item_name)
 	return out;
 }
 
+static bool item_is(const yp_name_t *name, const yp_name_t *item)
+{
+	return name[0] == item[0] && memcmp(name + 1, item + 1, name[0]) == 0;
+}
+
+static bool conf_cache_get(const zone_conf_cache_t *cache,
+                           const yp_name_t *item_name, knotd_conf_t *out)
+{
+	if (item_is(item_name, C_DISABLE_ANY)) {
+		out->single.boolean = cache->disable_any;
+	} else if (item_is(item_name, C_DNSSEC_SIGNING)) {
+		out->single.boolean = cache->dnssec_signing;
+	} else {
+		return false;
+	}
+	out->count = 1;
+
+	return true;
+}
+
 _public_
 knotd_conf_t knotd_conf_zone(knotd_mod_t *mod, const yp_name_t *item_name,
                              const knot_dname_t *zone)
@@ -479,6 +508,13 @@ knotd_conf_t knotd_conf_zone(knotd_mod_t *mod, const yp_name_t *item_name,
 		return out;
 	}
 
+	/* Serve the items cached in the module zone without confdb access. */
+	if (mod->config == NULL && mod->conf_cache != NULL &&
+	    knot_dname_is_equal(zone, mod->zone) &&
+	    conf_cache_get(rcu_dereference(*mod->conf_cache), item_name, &out)) {
+		return out;
+	}
+
 	conf_t *config = (mod->config != NULL) ? mod->config : conf();
 
 	conf_val_t val = conf_zone_get(config, item_name, zone);
@@ -36,19 +36,38 @@ typedef unsigned (*query_step_process_f)
 
 /*! \brief Single processing step in query processing. */
 struct query_step {
-	node_t node;
 	void *ctx;
 	query_step_process_f process;
+	knotd_mod_batch_hook_f batch; /*!< Optional batch variant of process. */
 };
 
 /*! Query plan represents a sequence of steps needed for query processing
  *  divided into several stages, where each stage represents a current response
  *  assembly phase, for example 'before processing', 'answer section' and so on.
+ *
+ *  Steps of each stage are stored in a contiguous array terminated by a step
+ *  with NULL process callback. Stages without any step have no array and
+ *  their bit in the stage mask is cleared, so they can be skipped at once.
  */
 struct query_plan {
-	list_t stage[KNOTD_STAGES];
+	unsigned stage_mask;
+	unsigned stage_count[KNOTD_STAGES];
+	struct query_step *stage[KNOTD_STAGES];
 };
 
+/*! \brief Check if the query plan contains any step for given stage. */
+#define query_plan_has_stage(plan, stage_id) \
+	((plan) != NULL && ((plan)->stage_mask & (1U << (stage_id))))
+
+/*!
+ * \brief Iterate over the query plan steps of given stage.
+ *
+ * \note Empty stages (or NULL plan) are skipped with a single check.
+ */
+#define WALK_PLAN(step, plan, stage_id) \
+	if (!query_plan_has_stage(plan, stage_id)) {} else \
+	for ((step) = (plan)->stage[stage_id]; (step)->process != NULL; (step)++)
+
 /*! \brief Create an empty query plan. */
 struct query_plan *query_plan_create(void);
 
@@ -59,6 +78,11 @@ void query_plan_free(struct query_plan *plan);
 int query_plan_step(struct query_plan *plan, knotd_stage_t stage,
                     query_step_process_f process, void *ctx);
 
+/*! \brief Plan another step with an optional batch variant for given stage. */
+int query_plan_batch_step(struct query_plan *plan, knotd_stage_t stage,
+                          query_step_process_f process,
+                          knotd_mod_batch_hook_f batch, void *ctx);
+
 /*! \brief Open query module identified by name. */
 knotd_mod_t *query_module_open(conf_t *conf, conf_mod_id_t *mod_id,
                                struct query_plan *plan, const knot_dname_t *zone);
@@ -86,6 +110,7 @@ struct knotd_mod {
 	conf_mod_id_t *id;
 	struct query_plan *plan;
 	const knot_dname_t *zone;
+	struct zone_conf_cache **conf_cache; /*!< Cached zone items (zone modules only). */
 	const knotd_mod_api_t *api;
 	kdnssec_ctx_t *dnssec;
 	zone_keyset_t *keyset;
@@ -0,0 +1,382 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "knot/nameserver/referral_cache.h"
+#include "libknot/descriptor.h"
+#include "libknot/error.h"
+
+/*! \brief Cached RRSet of the referral. */
+typedef struct {
+	knot_rrset_t rrset;     /*!< Zone RRSet or a copy owned by the entry. */
+	bool copy;              /*!< RRSet must be copied into the response. */
+	bool additional;        /*!< RRSet belongs to the ADDITIONAL section. */
+	uint16_t pos;           /*!< Offset of the RRSet in the cached wire. */
+	uint16_t len;           /*!< Length of the RRSet wire. */
+} cached_rr_t;
+
+/*! \brief Compression pointer in the cached wire. */
+typedef struct {
+	uint16_t pos;           /*!< Offset of the pointer in the cached wire. */
+	uint16_t target;        /*!< Offset in the cached wire or distance from the QNAME end. */
+	bool qname;             /*!< Pointer into the QNAME. */
+} cached_ptr_t;
+
+/*! \brief Cached referral, allocated in one block. */
+typedef struct {
+	uint64_t generation;
+	const zone_node_t *node;
+	bool dnssec;
+	uint16_t rr_count;
+	uint16_t ptr_count;
+	uint16_t ptr_max;       /*!< Maximal pointer target in the cached wire. */
+	uint16_t wire_len;
+	cached_rr_t *rrs;
+	cached_ptr_t *ptrs;
+	uint8_t *wire;
+	uint8_t data[];
+} referral_entry_t;
+
+struct referral_cache {
+	referral_entry_t *entries[REFERRAL_CACHE_SIZE];
+};
+
+/*! \brief Compression pointers scanning context. */
+typedef struct {
+	const uint8_t *wire;    /*!< Packet wire. */
+	uint16_t base;          /*!< Beginning of the cached wire. */
+	uint16_t pos;           /*!< Current position in the packet wire. */
+	uint16_t qname_end;     /*!< End of the QNAME in the packet wire. */
+	uint16_t max_suffix;    /*!< Maximal QNAME suffix common for all names. */
+	uint16_t ptr_max;
+	uint16_t count;
+	cached_ptr_t *ptrs;     /*!< Output pointers (NULL to just count them). */
+} ptr_scan_t;
+
+referral_cache_t *referral_cache_new(void)
+{
+	return calloc(1, sizeof(referral_cache_t));
+}
+
+void referral_cache_free(referral_cache_t *cache)
+{
+	if (cache == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; i < REFERRAL_CACHE_SIZE; i++) {
+		free(cache->entries[i]);
+	}
+	free(cache);
+}
+
+static referral_entry_t **get_slot(referral_cache_t *cache, const zone_node_t *node,
+                                   bool dnssec)
+{
+	// Nodes are allocated at least 8-byte aligned.
+	uint64_t h = (((uintptr_t)node >> 3) ^ dnssec) * 0x9E3779B97F4A7C15ull;
+
+	return &cache->entries[(h >> 32) % REFERRAL_CACHE_SIZE];
+}
+
+static int scan_ptr(ptr_scan_t *scan, uint16_t target)
+{
+	cached_ptr_t ptr = {
+		.pos = scan->pos - scan->base
+	};
+
+	if (target >= scan->base && target < scan->pos) {
+		ptr.target = target - scan->base;
+		if (ptr.target > scan->ptr_max) {
+			scan->ptr_max = ptr.target;
+		}
+	} else if (target >= KNOT_WIRE_HEADER_SIZE && target < scan->qname_end &&
+	           scan->qname_end - target <= scan->max_suffix) {
+		ptr.target = scan->qname_end - target;
+		ptr.qname = true;
+	} else {
+		// Pointer into a name specific for this QNAME.
+		return KNOT_ENOTSUP;
+	}
+
+	if (scan->ptrs != NULL) {
+		scan->ptrs[scan->count] = ptr;
+	}
+	scan->count++;
+
+	return KNOT_EOK;
+}
+
+static int scan_name(ptr_scan_t *scan, uint16_t end)
+{
+	while (scan->pos < end) {
+		const uint8_t *label = scan->wire + scan->pos;
+		if (knot_wire_is_pointer(label)) {
+			if (end - scan->pos < sizeof(uint16_t)) {
+				return KNOT_EMALF;
+			}
+			int ret = scan_ptr(scan, knot_wire_get_pointer(label));
+			scan->pos += sizeof(uint16_t);
+			return ret;
+		} else if (*label == '\0') {
+			scan->pos += 1;
+			return KNOT_EOK;
+		}
+		scan->pos += *label + 1;
+	}
+
+	return KNOT_EMALF;
+}
+
+static int scan_rr(ptr_scan_t *scan, uint16_t end)
+{
+	int ret = scan_name(scan, end);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	const size_t fixed = KNOT_WIRE_RR_MIN_SIZE - 1; /* Without the owner. */
+	if (end - scan->pos < fixed) {
+		return KNOT_EMALF;
+	}
+	uint16_t type = knot_wire_read_u16(scan->wire + scan->pos);
+	uint16_t rdlen = knot_wire_read_u16(scan->wire + scan->pos + fixed - sizeof(uint16_t));
+	scan->pos += fixed;
+	if (end - scan->pos < rdlen) {
+		return KNOT_EMALF;
+	}
+	uint16_t rdend = scan->pos + rdlen;
+
+	const knot_rdata_descriptor_t *desc = knot_get_rdata_descriptor(type);
+	for (const int *block = desc->block_types; *block != KNOT_RDATA_WF_END; block++) {
+		switch (*block) {
+		case KNOT_RDATA_WF_COMPRESSIBLE_DNAME:
+		case KNOT_RDATA_WF_DECOMPRESSIBLE_DNAME:
+		case KNOT_RDATA_WF_FIXED_DNAME:
+			ret = scan_name(scan, rdend);
+			break;
+		case KNOT_RDATA_WF_REMAINDER:
+			scan->pos = rdend;
+			break;
+		case KNOT_RDATA_WF_NAPTR_HEADER:
+			ret = KNOT_ENOTSUP;
+			break;
+		default:
+			scan->pos += *block;
+			break;
+		}
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+	}
+
+	return (scan->pos == rdend) ? KNOT_EOK : KNOT_EMALF;
+}
+
+static int scan_rrsets(ptr_scan_t *scan, const knot_pkt_t *pkt, uint16_t first)
+{
+	scan->pos = scan->base;
+	scan->count = 0;
+	scan->ptr_max = 0;
+
+	for (uint16_t i = first; i < pkt->rrset_count; i++) {
+		uint16_t end = (i + 1 < pkt->rrset_count) ? pkt->rr_info[i + 1].pos : pkt->size;
+		if (pkt->rr_info[i].pos != scan->pos || end < scan->pos) {
+			return KNOT_EMALF;
+		}
+		for (uint16_t j = 0; j < pkt->rr[i].rrs.count; j++) {
+			int ret = scan_rr(scan, end);
+			if (ret != KNOT_EOK) {
+				return ret;
+			}
+		}
+		if (scan->pos != end) {
+			return KNOT_EMALF;
+		}
+	}
+
+	return KNOT_EOK;
+}
+
+static size_t align8(size_t size)
+{
+	return (size + 7) & ~(size_t)7;
+}
+
+int referral_cache_get(referral_cache_t *cache, knot_pkt_t *pkt,
+                       const zone_contents_t *zone, const zone_node_t *node,
+                       bool dnssec)
+{
+	if (cache == NULL || pkt == NULL || zone == NULL || node == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	const referral_entry_t *entry = *get_slot(cache, node, dnssec);
+	if (entry == NULL || entry->generation != zone->generation ||
+	    entry->node != node || entry->dnssec != dnssec) {
+		return KNOT_ENOENT;
+	}
+
+	uint16_t base = pkt->size;
+	if (base + entry->ptr_max >= KNOT_WIRE_PTR_MAX) {
+		return KNOT_ENOENT;
+	}
+	if (entry->wire_len > pkt->max_size - pkt->size - pkt->reserved) {
+		return KNOT_ESPACE;
+	}
+
+	for (uint16_t i = 0; i < entry->rr_count; i++) {
+		const cached_rr_t *rr = &entry->rrs[i];
+		if (rr->additional && pkt->current != KNOT_ADDITIONAL) {
+			knot_pkt_begin(pkt, KNOT_ADDITIONAL);
+		}
+
+		knot_rrset_t rrset = rr->rrset;
+		uint16_t flags = KNOT_PF_NULL;
+		if (rr->copy) {
+			// Synthesized RRSets are owned by the packet.
+			rrset.owner = knot_dname_copy(rr->rrset.owner, &pkt->mm);
+			knot_rdataset_init(&rrset.rrs);
+			int ret = knot_rdataset_copy(&rrset.rrs, &rr->rrset.rrs, &pkt->mm);
+			if (rrset.owner == NULL || ret != KNOT_EOK) {
+				knot_rrset_clear(&rrset, &pkt->mm);
+				return KNOT_ENOMEM;
+			}
+			flags |= KNOT_PF_FREE;
+		}
+
+		int ret = knot_pkt_put_wire(pkt, KNOT_COMPR_HINT_NONE, &rrset,
+		                            entry->wire + rr->pos, rr->len, flags);
+		if (ret != KNOT_EOK) {
+			if (rr->copy) {
+				knot_rrset_clear(&rrset, &pkt->mm);
+			}
+			return ret;
+		}
+	}
+
+	if (pkt->current != KNOT_ADDITIONAL) {
+		knot_pkt_begin(pkt, KNOT_ADDITIONAL);
+	}
+
+	// Redirect the compression pointers.
+	uint16_t qname_end = KNOT_WIRE_HEADER_SIZE + pkt->qname_size;
+	for (uint16_t i = 0; i < entry->ptr_count; i++) {
+		const cached_ptr_t *ptr = &entry->ptrs[i];
+		uint16_t target = ptr->qname ? qname_end - ptr->target : base + ptr->target;
+		knot_wire_put_pointer(pkt->wire + base + ptr->pos, target);
+	}
+
+	return KNOT_EOK;
+}
+
+void referral_cache_put(referral_cache_t *cache, const knot_pkt_t *pkt,
+                        const zone_contents_t *zone, const zone_node_t *node,
+                        bool dnssec)
+{
+	if (cache == NULL || pkt == NULL || zone == NULL || node == NULL) {
+		return;
+	}
+
+	uint16_t first = pkt->sections[KNOT_AUTHORITY].pos;
+	if (first >= pkt->rrset_count || knot_wire_get_tc(pkt->wire) ||
+	    knot_dname_in_bailiwick(knot_pkt_qname(pkt), node->owner) < 0) {
+		return;
+	}
+	uint16_t ar_first = (pkt->current == KNOT_ADDITIONAL) ?
+	                    pkt->sections[KNOT_ADDITIONAL].pos : pkt->rrset_count;
+
+	ptr_scan_t scan = {
+		.wire = pkt->wire,
+		.base = pkt->rr_info[first].pos,
+		.qname_end = KNOT_WIRE_HEADER_SIZE + pkt->qname_size,
+		.max_suffix = knot_dname_size(node->owner)
+	};
+
+	// Count the pointers first.
+	if (scan_rrsets(&scan, pkt, first) != KNOT_EOK) {
+		return;
+	}
+
+	uint16_t rr_count = pkt->rrset_count - first;
+	size_t rdata_size = 0, owners_size = 0;
+	for (uint16_t i = first; i < pkt->rrset_count; i++) {
+		if (pkt->rr_info[i].flags & KNOT_PF_FREE) {
+			rdata_size += pkt->rr[i].rrs.size;
+			owners_size += knot_dname_size(pkt->rr[i].owner);
+		}
+	}
+
+	// Layout: RRSets, pointers, copied RDATA (aligned), copied owners, wire.
+	size_t ptrs_off = rr_count * sizeof(cached_rr_t);
+	size_t rdata_off = align8(ptrs_off + scan.count * sizeof(cached_ptr_t));
+	size_t owners_off = rdata_off + rdata_size;
+	size_t wire_off = owners_off + owners_size;
+	uint16_t wire_len = pkt->size - scan.base;
+
+	referral_entry_t *entry = malloc(sizeof(*entry) + wire_off + wire_len);
+	if (entry == NULL) {
+		return;
+	}
+	entry->generation = zone->generation;
+	entry->node = node;
+	entry->dnssec = dnssec;
+	entry->rr_count = rr_count;
+	entry->ptr_count = scan.count;
+	entry->ptr_max = scan.ptr_max;
+	entry->wire_len = wire_len;
+	entry->rrs = (cached_rr_t *)entry->data;
+	entry->ptrs = (cached_ptr_t *)(entry->data + ptrs_off);
+	entry->wire = entry->data + wire_off;
+
+	uint8_t *rdata = entry->data + rdata_off;
+	uint8_t *owners = entry->data + owners_off;
+	for (uint16_t i = 0; i < rr_count; i++) {
+		const knot_rrset_t *rr = &pkt->rr[first + i];
+		const knot_rrinfo_t *info = &pkt->rr_info[first + i];
+		uint16_t end = (first + i + 1 < pkt->rrset_count) ?
+		               pkt->rr_info[first + i + 1].pos : pkt->size;
+
+		cached_rr_t *cached = &entry->rrs[i];
+		cached->rrset = *rr;
+		cached->copy = (info->flags & KNOT_PF_FREE);
+		cached->additional = (first + i >= ar_first);
+		cached->pos = info->pos - scan.base;
+		cached->len = end - info->pos;
+
+		if (cached->copy) {
+			// Synthesized RRSet lives in the packet memory only.
+			memcpy(rdata, rr->rrs.rdata, rr->rrs.size);
+			cached->rrset.rrs.rdata = (knot_rdata_t *)rdata;
+			rdata += rr->rrs.size;
+			size_t owner_size = knot_dname_size(rr->owner);
+			memcpy(owners, rr->owner, owner_size);
+			cached->rrset.owner = owners;
+			owners += owner_size;
+			cached->rrset.additional = NULL;
+		}
+	}
+
+	scan.ptrs = entry->ptrs;
+	(void)scan_rrsets(&scan, pkt, first);
+	memcpy(entry->wire, pkt->wire + scan.base, wire_len);
+
+	referral_entry_t **slot = get_slot(cache, node, dnssec);
+	free(*slot);
+	*slot = entry;
+}
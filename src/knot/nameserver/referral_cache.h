@@ -0,0 +1,89 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "libknot/packet/pkt.h"
+#include "knot/zone/contents.h"
+
+/*! \brief Number of cached referrals. */
+#define REFERRAL_CACHE_SIZE	1024
+
+/*!
+ * \brief Per-worker cache of rendered referral responses.
+ *
+ * Referrals from a delegation point don't depend on the QNAME below it,
+ * only the compression pointers into the QNAME do. The cache remembers
+ * the rendered AUTHORITY and ADDITIONAL sections per delegation node and
+ * zone contents generation, with pointers into the QNAME stored relative
+ * to its end, so they can be copied into responses for other names.
+ *
+ * The cache is not thread-safe, each worker owns one.
+ */
+typedef struct referral_cache referral_cache_t;
+
+/*!
+ * \brief Allocates an empty cache.
+ *
+ * \return Cache or NULL if not enough memory.
+ */
+referral_cache_t *referral_cache_new(void);
+
+/*!
+ * \brief Deallocates the cache.
+ */
+void referral_cache_free(referral_cache_t *cache);
+
+/*!
+ * \brief Appends the cached referral sections into the response.
+ *
+ * The response must have an empty ANSWER section and the AUTHORITY section
+ * must be the current one. Nothing is written unless the whole referral fits.
+ * The ADDITIONAL section is left current on success.
+ *
+ * \param cache   Cache.
+ * \param pkt     Response with the QNAME under the delegation point.
+ * \param zone    Zone contents.
+ * \param node    Delegation point.
+ * \param dnssec  DNSSEC records requested.
+ *
+ * \retval KNOT_EOK if appended.
+ * \retval KNOT_ENOENT if not cached.
+ * \retval KNOT_ESPACE if the cached referral doesn't fit.
+ * \return KNOT_E* on other errors.
+ */
+int referral_cache_get(referral_cache_t *cache, knot_pkt_t *pkt,
+                       const zone_contents_t *zone, const zone_node_t *node,
+                       bool dnssec);
+
+/*!
+ * \brief Stores the AUTHORITY and ADDITIONAL sections of the response.
+ *
+ * The response must be a complete referral from the delegation point with
+ * an empty ANSWER section. Referrals which can't be reused (e.g. pointing
+ * into the QNAME below the delegation point) are silently skipped.
+ *
+ * \param cache   Cache.
+ * \param pkt     Rendered response.
+ * \param zone    Zone contents.
+ * \param node    Delegation point.
+ * \param dnssec  DNSSEC records requested.
+ */
+void referral_cache_put(referral_cache_t *cache, const knot_pkt_t *pkt,
+                        const zone_contents_t *zone, const zone_node_t *node,
+                        bool dnssec);
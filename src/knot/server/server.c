@@ -723,6 +723,11 @@ int server_reload(server_t *server)
 	}
 	if (full || (flags & (CONF_IO_FRLD_ZONES | CONF_IO_FRLD_ZONE))) {
 		server_update_zones(conf(), server);
+	} else if (flags & (CONF_IO_FZONE | CONF_IO_FTPL | CONF_IO_FDIFF_ZONES)) {
+		if (zonedb_reconfigure(conf(), server) != KNOT_EOK) {
+			/* Reload the zones whose cache couldn't be refreshed. */
+			server_update_zones(conf(), server);
+		}
 	}
 
 	/* Free old config needed for module unload in zone reload. */
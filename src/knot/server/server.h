@@ -76,6 +76,8 @@ typedef struct server {
 
 	/*! \brief Zone database. */
 	knot_zonedb_t *zone_db;
+	/*! \brief Number of configured zones missing in the zone database. */
+	size_t zone_db_missing;
 	knot_lmdb_db_t timerdb;
 	knot_lmdb_db_t journaldb;
 	knot_lmdb_db_t kaspdb;
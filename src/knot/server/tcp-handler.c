@@ -32,6 +32,8 @@
 #include "knot/server/server.h"
 #include "knot/server/tcp-handler.h"
 #include "knot/common/log.h"
+#include "knot/nameserver/nsec_cache.h"
+#include "knot/nameserver/referral_cache.h"
 #include "knot/nameserver/process_query.h"
 #include "knot/query/layer.h"
 #include "contrib/macros.h"
@@ -54,6 +56,8 @@ typedef struct tcp_context {
 	unsigned max_clients;            /*!< Max TCP clients per worker configuration. */
 	int idle_timeout;                /*!< [s] TCP idle timeout configuration. */
 	int io_timeout;                  /*!< [ms] TCP send/recv timeout configuration. */
+	nsec_cache_t *nsec_cache;        /*!< Denial proof cache. */
+	referral_cache_t *referral_cache; /*!< Referral cache. */
 } tcp_context_t;
 
 #define TCP_SWEEP_INTERVAL 2 /*!< [secs] granularity of connection sweeping. */
@@ -168,6 +172,7 @@ static int tcp_handle(tcp_context_t *tcp, int fd, struct iovec *rx, struct iovec
 
 	/* Initialize processing layer. */
 	knot_layer_begin(&tcp->layer, &params);
+	process_query_set_caches(&tcp->layer, tcp->nsec_cache, tcp->referral_cache);
 
 	/* Create packets. */
 	knot_pkt_t *ans = knot_pkt_new(tx->iov_base, tx->iov_len, tcp->layer.mm);
@@ -295,7 +300,9 @@ int tcp_master(dthread_t *thread)
 	tcp_context_t tcp = {
 		.server = handler->server,
 		.is_throttled = false,
-		.thread_id = handler->thread_id[dt_get_id(thread)]
+		.thread_id = handler->thread_id[dt_get_id(thread)],
+		.nsec_cache = nsec_cache_new(),
+		.referral_cache = referral_cache_new()
 	};
 	knot_layer_init(&tcp.layer, &mm, process_query_layer());
 
@@ -343,6 +350,8 @@ int tcp_master(dthread_t *thread)
 finish:
 	free(tcp.iov[0].iov_base);
 	free(tcp.iov[1].iov_base);
+	nsec_cache_free(tcp.nsec_cache);
+	referral_cache_free(tcp.referral_cache);
 	mp_delete(mm.ctx);
 	fdset_clear(&tcp.set);
 
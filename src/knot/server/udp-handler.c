@@ -29,11 +29,14 @@
 #ifdef HAVE_SYS_UIO_H	// struct iovec (OpenBSD)
 #include <sys/uio.h>
 #endif /* HAVE_SYS_UIO_H */
+#include <urcu.h>
 
 #include "contrib/macros.h"
 #include "contrib/mempattern.h"
 #include "contrib/sockaddr.h"
 #include "contrib/ucw/mempool.h"
+#include "knot/nameserver/nsec_cache.h"
+#include "knot/nameserver/referral_cache.h"
 #include "knot/nameserver/process_query.h"
 #include "knot/query/layer.h"
 #include "knot/server/server.h"
@@ -51,6 +54,8 @@ typedef struct {
 	knot_layer_t layer; /*!< Query processing layer. */
 	server_t *server;   /*!< Name server structure. */
 	unsigned thread_id; /*!< Thread identifier. */
+	nsec_cache_t *nsec_cache; /*!< Denial proof cache. */
+	referral_cache_t *referral_cache; /*!< Referral cache. */
 } udp_context_t;
 
 static bool udp_state_active(int state)
@@ -58,45 +63,64 @@ static bool udp_state_active(int state)
 	return (state == KNOT_STATE_PRODUCE || state == KNOT_STATE_FAIL);
 }
 
-static void udp_handle(udp_context_t *udp, int fd, struct sockaddr_storage *ss,
-                       struct iovec *rx, struct iovec *tx)
+static knot_pkt_t *udp_handle_begin(udp_context_t *udp, knot_layer_t *layer,
+                                    knotd_qdata_params_t *params, int fd,
+                                    struct sockaddr_storage *ss,
+                                    struct iovec *rx, struct iovec *tx,
+                                    unsigned flags)
 {
 	/* Create query processing parameter. */
-	knotd_qdata_params_t params = {
+	*params = (knotd_qdata_params_t) {
 		.remote = ss,
 		.flags = KNOTD_QUERY_FLAG_NO_AXFR | KNOTD_QUERY_FLAG_NO_IXFR | /* No transfers. */
 		         KNOTD_QUERY_FLAG_LIMIT_SIZE | /* Enforce UDP packet size limit. */
-		         KNOTD_QUERY_FLAG_LIMIT_ANY,  /* Limit ANY over UDP (depends on zone as well). */
+		         KNOTD_QUERY_FLAG_LIMIT_ANY |  /* Limit ANY over UDP (depends on zone as well). */
+		         flags,
 		.socket = fd,
 		.server = udp->server,
 		.thread_id = udp->thread_id
 	};
 
 	/* Start query processing. */
-	knot_layer_begin(&udp->layer, &params);
+	knot_layer_begin(layer, params);
+	process_query_set_caches(layer, udp->nsec_cache, udp->referral_cache);
 
 	/* Create packets. */
-	knot_pkt_t *query = knot_pkt_new(rx->iov_base, rx->iov_len, udp->layer.mm);
-	knot_pkt_t *ans = knot_pkt_new(tx->iov_base, tx->iov_len, udp->layer.mm);
+	knot_pkt_t *query = knot_pkt_new(rx->iov_base, rx->iov_len, layer->mm);
+	knot_pkt_t *ans = knot_pkt_new(tx->iov_base, tx->iov_len, layer->mm);
 
 	/* Input packet. */
 	(void) knot_pkt_parse(query, 0);
-	knot_layer_consume(&udp->layer, query);
+	knot_layer_consume(layer, query);
 
 	/* Process answer. */
-	while (udp_state_active(udp->layer.state)) {
-		knot_layer_produce(&udp->layer, ans);
+	while (udp_state_active(layer->state)) {
+		knot_layer_produce(layer, ans);
 	}
 
+	return ans;
+}
+
+static void udp_handle_end(knot_layer_t *layer, knot_pkt_t *ans, struct iovec *tx)
+{
 	/* Send response only if finished successfully. */
-	if (udp->layer.state == KNOT_STATE_DONE) {
+	if (layer->state == KNOT_STATE_DONE) {
 		tx->iov_len = ans->size;
 	} else {
 		tx->iov_len = 0;
 	}
 
 	/* Reset after processing. */
-	knot_layer_finish(&udp->layer);
+	knot_layer_finish(layer);
+}
+
+static void udp_handle(udp_context_t *udp, int fd, struct sockaddr_storage *ss,
+                       struct iovec *rx, struct iovec *tx)
+{
+	knotd_qdata_params_t params;
+	knot_pkt_t *ans = udp_handle_begin(udp, &udp->layer, &params, fd, ss,
+	                                   rx, tx, 0);
+	udp_handle_end(&udp->layer, ans, tx);
 
 	/* Flush per-query memory (including query and answer packets). */
 	mp_flush(udp->layer.mm->ctx);
@@ -242,6 +266,9 @@ struct udp_recvmmsg {
 	unsigned rcvd;
 	knot_mm_t mm;
 	cmsg_pktinfo_t pktinfo[RECVMMSG_BATCHLEN];
+	knot_layer_t layers[RECVMMSG_BATCHLEN];
+	knotd_qdata_params_t params[RECVMMSG_BATCHLEN];
+	knot_pkt_t *ans[RECVMMSG_BATCHLEN];
 };
 
 static void *udp_recvmmsg_init(void)
@@ -298,7 +325,10 @@ static int udp_recvmmsg_handle(udp_context_t *ctx, void *d)
 {
 	struct udp_recvmmsg *rq = (struct udp_recvmmsg *)d;
 
-	/* Handle each received msg. */
+	/* Keep the zones referenced by the queries until the batch is finished. */
+	rcu_read_lock();
+
+	/* Handle each received msg, except for the end stage. */
 	for (unsigned i = 0; i < rq->rcvd; ++i) {
 		struct iovec *rx = rq->msgs[RX][i].msg_hdr.msg_iov;
 		struct iovec *tx = rq->msgs[TX][i].msg_hdr.msg_iov;
@@ -306,7 +336,19 @@ static int udp_recvmmsg_handle(udp_context_t *ctx, void *d)
 
 		udp_pktinfo_handle(&rq->msgs[RX][i].msg_hdr, &rq->msgs[TX][i].msg_hdr);
 
-		udp_handle(ctx, rq->fd, rq->addrs + i, rx, tx);
+		knot_layer_init(&rq->layers[i], ctx->layer.mm, ctx->layer.api);
+		rq->ans[i] = udp_handle_begin(ctx, &rq->layers[i], &rq->params[i],
+		                              rq->fd, rq->addrs + i, rx, tx,
+		                              KNOTD_QUERY_FLAG_BATCH);
+	}
+
+	/* Process the end stage for the whole batch. */
+	process_query_batch_end(rq->layers, rq->ans, rq->rcvd);
+
+	for (unsigned i = 0; i < rq->rcvd; ++i) {
+		struct iovec *tx = rq->msgs[TX][i].msg_hdr.msg_iov;
+
+		udp_handle_end(&rq->layers[i], rq->ans[i], tx);
 		rq->msgs[TX][i].msg_len = tx->iov_len;
 		rq->msgs[TX][i].msg_hdr.msg_namelen = 0;
 		if (tx->iov_len > 0) {
@@ -315,6 +357,11 @@ static int udp_recvmmsg_handle(udp_context_t *ctx, void *d)
 		}
 	}
 
+	rcu_read_unlock();
+
+	/* Flush per-batch memory (including query and answer packets). */
+	mp_flush(ctx->layer.mm->ctx);
+
 	return KNOT_EOK;
 }
 
@@ -426,7 +473,9 @@ int udp_master(dthread_t *thread)
 	/* Create UDP answering context. */
 	udp_context_t udp = {
 		.server = handler->server,
-		.thread_id = handler->thread_id[thr_id]
+		.thread_id = handler->thread_id[thr_id],
+		.nsec_cache = nsec_cache_new(),
+		.referral_cache = referral_cache_new()
 	};
 	knot_layer_init(&udp.layer, &mm, process_query_layer());
 
@@ -470,6 +519,8 @@ int udp_master(dthread_t *thread)
 
 finish:
 	_udp_deinit(rq);
+	nsec_cache_free(udp.nsec_cache);
+	referral_cache_free(udp.referral_cache);
 	free(fds);
 	mp_delete(mm.ctx);
 
@@ -14,20 +14,258 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>
+
+#include "libdnssec/error.h"
 #include "knot/updates/acl.h"
+#include "contrib/sockaddr.h"
+
+static int parse_addrs(conf_t *conf, conf_val_t *id, acl_rule_t *rule)
+{
+	conf_val_t val = conf_id_get(conf, C_ACL, C_ADDR, id);
+	size_t count = conf_val_count(&val);
+	if (count == 0) {
+		return KNOT_EOK;
+	}
+
+	rule->addrs = calloc(count, sizeof(*rule->addrs));
+	if (rule->addrs == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	while (val.code == KNOT_EOK) {
+		acl_addr_t *addr = &rule->addrs[rule->addrs_count++];
+		addr->min = conf_addr_range(&val, &addr->max, &addr->prefix);
+		conf_val_next(&val);
+	}
+
+	return KNOT_EOK;
+}
+
+static int parse_keys(conf_t *conf, conf_val_t *id, acl_rule_t *rule)
+{
+	conf_val_t val = conf_id_get(conf, C_ACL, C_KEY, id);
+	size_t count = conf_val_count(&val);
+	if (count == 0) {
+		return KNOT_EOK;
+	}
+
+	rule->keys = calloc(count, sizeof(*rule->keys));
+	if (rule->keys == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	while (val.code == KNOT_EOK) {
+		acl_key_t *key = &rule->keys[rule->keys_count++];
+
+		key->name = knot_dname_copy(conf_dname(&val), NULL);
+		if (key->name == NULL) {
+			return KNOT_ENOMEM;
+		}
+
+		conf_val_t alg_val = conf_id_get(conf, C_KEY, C_ALG, &val);
+		key->algorithm = conf_opt(&alg_val);
+
+		conf_val_t secret_val = conf_id_get(conf, C_KEY, C_SECRET, &val);
+		dnssec_binary_t secret = { 0 };
+		secret.data = (uint8_t *)conf_bin(&secret_val, &secret.size);
+		if (dnssec_binary_dup(&secret, &key->secret) != DNSSEC_EOK) {
+			return KNOT_ENOMEM;
+		}
+
+		conf_val_next(&val);
+	}
+
+	return KNOT_EOK;
+}
+
+static int parse_update(conf_t *conf, conf_val_t *id, acl_rule_t *rule)
+{
+	conf_val_t val = conf_id_get(conf, C_ACL, C_UPDATE_TYPE, id);
+	size_t count = conf_val_count(&val);
+	if (count > 0) {
+		rule->update_types = calloc(count, sizeof(*rule->update_types));
+		if (rule->update_types == NULL) {
+			return KNOT_ENOMEM;
+		}
+		while (val.code == KNOT_EOK) {
+			rule->update_types[rule->update_types_count++] =
+				knot_wire_read_u64(val.data);
+			conf_val_next(&val);
+		}
+	}
+
+	val = conf_id_get(conf, C_ACL, C_UPDATE_OWNER, id);
+	rule->update_owner = conf_opt(&val);
+	if (rule->update_owner == ACL_UPDATE_OWNER_NONE) {
+		rule->update_owner_match = ACL_UPDATE_MATCH_SUBEQ;
+		return KNOT_EOK;
+	}
+
+	val = conf_id_get(conf, C_ACL, C_UPDATE_OWNER_MATCH, id);
+	rule->update_owner_match = conf_opt(&val);
+
+	if (rule->update_owner != ACL_UPDATE_OWNER_NAME) {
+		return KNOT_EOK;
+	}
+
+	val = conf_id_get(conf, C_ACL, C_UPDATE_OWNER_NAME, id);
+	count = conf_val_count(&val);
+	if (count > 0) {
+		rule->update_names = calloc(count, sizeof(*rule->update_names));
+		if (rule->update_names == NULL) {
+			return KNOT_ENOMEM;
+		}
+		while (val.code == KNOT_EOK) {
+			knot_dname_t *name = knot_dname_copy(conf_dname(&val), NULL);
+			if (name == NULL) {
+				return KNOT_ENOMEM;
+			}
+			rule->update_names[rule->update_names_count++] = name;
+			conf_val_next(&val);
+		}
+	}
+
+	return KNOT_EOK;
+}
 
-static bool match_type(uint16_t type, conf_val_t *types)
+static int parse_rule(conf_t *conf, conf_val_t *id, acl_rule_t *rule)
 {
-	if (types == NULL) {
+	int ret = parse_addrs(conf, id, rule);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	ret = parse_keys(conf, id, rule);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	conf_val_t val = conf_id_get(conf, C_ACL, C_ACTION, id);
+	while (val.code == KNOT_EOK) {
+		rule->actions |= 1 << conf_opt(&val);
+		conf_val_next(&val);
+	}
+
+	val = conf_id_get(conf, C_ACL, C_DENY, id);
+	rule->deny = conf_bool(&val);
+
+	return parse_update(conf, id, rule);
+}
+
+static void free_rule(acl_rule_t *rule)
+{
+	for (size_t i = 0; i < rule->keys_count; i++) {
+		knot_dname_free(rule->keys[i].name, NULL);
+		dnssec_binary_free(&rule->keys[i].secret);
+	}
+	for (size_t i = 0; i < rule->update_names_count; i++) {
+		knot_dname_free(rule->update_names[i], NULL);
+	}
+
+	free(rule->addrs);
+	free(rule->keys);
+	free(rule->update_types);
+	free(rule->update_names);
+}
+
+acl_rules_t *acl_rules_new(conf_t *conf, conf_val_t *acl)
+{
+	if (conf == NULL || acl == NULL) {
+		return NULL;
+	}
+
+	acl_rules_t *rules = calloc(1, sizeof(*rules));
+	if (rules == NULL) {
+		return NULL;
+	}
+
+	size_t count = conf_val_count(acl);
+	if (count == 0) {
+		return rules;
+	}
+
+	rules->rules = calloc(count, sizeof(*rules->rules));
+	if (rules->rules == NULL) {
+		free(rules);
+		return NULL;
+	}
+
+	while (acl->code == KNOT_EOK) {
+		int ret = parse_rule(conf, acl, &rules->rules[rules->count++]);
+		if (ret != KNOT_EOK) {
+			acl_rules_free(rules);
+			return NULL;
+		}
+		conf_val_next(acl);
+	}
+
+	return rules;
+}
+
+void acl_rules_free(acl_rules_t *rules)
+{
+	if (rules == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; i < rules->count; i++) {
+		free_rule(&rules->rules[i]);
+	}
+	free(rules->rules);
+	free(rules);
+}
+
+static bool match_addr(const acl_rule_t *rule, const struct sockaddr_storage *addr)
+{
+	if (rule->addrs_count == 0) {
 		return true;
 	}
 
-	conf_val_reset(types);
-	while (types->code == KNOT_EOK) {
-		if (type == knot_wire_read_u64(types->data)) {
+	for (size_t i = 0; i < rule->addrs_count; i++) {
+		const acl_addr_t *range = &rule->addrs[i];
+		if (range->max.ss_family == AF_UNSPEC) {
+			if (sockaddr_net_match((struct sockaddr *)addr,
+			                       (struct sockaddr *)&range->min,
+			                       range->prefix)) {
+				return true;
+			}
+		} else {
+			if (sockaddr_range_match((struct sockaddr *)addr,
+			                         (struct sockaddr *)&range->min,
+			                         (struct sockaddr *)&range->max)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static const acl_key_t *match_key(const acl_rule_t *rule, const knot_tsig_key_t *tsig)
+{
+	for (size_t i = 0; i < rule->keys_count; i++) {
+		const acl_key_t *key = &rule->keys[i];
+		/* Compare key names (both in lower-case) and algorithms. */
+		if (knot_dname_is_equal(key->name, tsig->name) &&
+		    key->algorithm == tsig->algorithm) {
+			return key;
+		}
+	}
+
+	return NULL;
+}
+
+static bool match_type(uint16_t type, const acl_rule_t *rule)
+{
+	if (rule->update_types_count == 0) {
+		return true;
+	}
+
+	for (size_t i = 0; i < rule->update_types_count; i++) {
+		if (type == rule->update_types[i]) {
 			return true;
 		}
-		conf_val_next(types);
 	}
 
 	return false;
@@ -53,56 +291,36 @@ static bool match_name(const knot_dname_t *rr_owner, const knot_dname_t *name,
 	}
 }
 
-static bool match_names(const knot_dname_t *rr_owner, conf_val_t *names,
-                        acl_update_owner_match_t match)
+static bool match_names(const knot_dname_t *rr_owner, const acl_rule_t *rule)
 {
-	if (names == NULL) {
+	if (rule->update_names_count == 0) {
 		return true;
 	}
 
-	conf_val_reset(names);
-	while (names->code == KNOT_EOK) {
-		if (match_name(rr_owner, conf_dname(names), match)) {
+	for (size_t i = 0; i < rule->update_names_count; i++) {
+		if (match_name(rr_owner, rule->update_names[i],
+		               rule->update_owner_match)) {
 			return true;
 		}
-		conf_val_next(names);
 	}
 
 	return false;
 }
 
-static bool update_match(conf_t *conf, conf_val_t *acl, knot_dname_t *key_name,
+static bool update_match(const acl_rule_t *rule, knot_dname_t *key_name,
                          const knot_dname_t *zone_name, knot_pkt_t *query)
 {
 	if (query == NULL) {
 		return true;
 	}
 
-	conf_val_t val_types = conf_id_get(conf, C_ACL, C_UPDATE_TYPE, acl);
-	conf_val_t *types = (conf_val_count(&val_types) > 0) ? &val_types : NULL;
-
-	conf_val_t val = conf_id_get(conf, C_ACL, C_UPDATE_OWNER, acl);
-	acl_update_owner_t owner = conf_opt(&val);
-
 	/* Return if no specific requirements configured. */
-	if (types == NULL && owner == ACL_UPDATE_OWNER_NONE) {
+	if (rule->update_types_count == 0 &&
+	    rule->update_owner == ACL_UPDATE_OWNER_NONE) {
 		return true;
 	}
 
-	acl_update_owner_match_t match = ACL_UPDATE_MATCH_SUBEQ;
-	if (owner != ACL_UPDATE_OWNER_NONE) {
-		val = conf_id_get(conf, C_ACL, C_UPDATE_OWNER_MATCH, acl);
-		match = conf_opt(&val);
-	}
-
-	conf_val_t *names = NULL;
-	conf_val_t val_names;
-	if (owner == ACL_UPDATE_OWNER_NAME) {
-		val_names = conf_id_get(conf, C_ACL, C_UPDATE_OWNER_NAME, acl);
-		if (conf_val_count(&val_names) > 0) {
-			names = &val_names;
-		}
-	}
+	acl_update_owner_match_t match = rule->update_owner_match;
 
 	/* Updated RRs are contained in the Authority section of the query
 	 * (RFC 2136 Section 2.2)
@@ -112,13 +330,13 @@ static bool update_match(conf_t *conf, conf_val_t *acl, knot_dname_t *key_name,
 
 	for (int i = pos; i < pos + count; i++) {
 		knot_rrset_t *rr = &query->rr[i];
-		if (!match_type(rr->type, types)) {
+		if (!match_type(rr->type, rule)) {
 			return false;
 		}
 
-		switch (owner) {
+		switch (rule->update_owner) {
 		case ACL_UPDATE_OWNER_NAME:
-			if (!match_names(rr->owner, names, match)) {
+			if (!match_names(rr->owner, rule)) {
 				return false;
 			}
 			break;
@@ -140,7 +358,7 @@ static bool update_match(conf_t *conf, conf_val_t *acl, knot_dname_t *key_name,
 	return true;
 }
 
-bool acl_allowed(conf_t *conf, conf_val_t *acl, acl_action_t action,
+bool acl_allowed(const acl_rules_t *acl, acl_action_t action,
                  const struct sockaddr_storage *addr, knot_tsig_key_t *tsig,
                  const knot_dname_t *zone_name, knot_pkt_t *query)
 {
@@ -148,87 +366,53 @@ bool acl_allowed(conf_t *conf, conf_val_t *acl, acl_action_t action,
 		return false;
 	}
 
-	while (acl->code == KNOT_EOK) {
+	for (size_t i = 0; i < acl->count; i++) {
+		const acl_rule_t *rule = &acl->rules[i];
+
 		/* Check if the address matches the current acl address list. */
-		conf_val_t val = conf_id_get(conf, C_ACL, C_ADDR, acl);
-		if (val.code != KNOT_ENOENT && !conf_addr_range_match(&val, addr)) {
-			goto next_acl;
+		if (!match_addr(rule, addr)) {
+			continue;
 		}
 
-		/* Check if the key matches the current acl key list. */
-		conf_val_t key_val = conf_id_get(conf, C_ACL, C_KEY, acl);
-		while (key_val.code == KNOT_EOK) {
-			/* No key provided, but required. */
-			if (tsig->name == NULL) {
-				conf_val_next(&key_val);
-				continue;
-			}
-
-			/* Compare key names (both in lower-case). */
-			const knot_dname_t *key_name = conf_dname(&key_val);
-			if (!knot_dname_is_equal(key_name, tsig->name)) {
-				conf_val_next(&key_val);
-				continue;
-			}
-
-			/* Compare key algorithms. */
-			conf_val_t alg_val = conf_id_get(conf, C_KEY, C_ALG,
-			                                 &key_val);
-			if (conf_opt(&alg_val) != tsig->algorithm) {
-				conf_val_next(&key_val);
+		/* Check for key match or empty list without key provided. */
+		const acl_key_t *key = NULL;
+		if (tsig->name != NULL) {
+			key = match_key(rule, tsig);
+			if (key == NULL) {
 				continue;
 			}
-
-			break;
-		}
-		/* Check for key match or empty list without key provided. */
-		if (key_val.code != KNOT_EOK &&
-		    !(key_val.code == KNOT_ENOENT && tsig->name == NULL)) {
-			goto next_acl;
+		} else if (rule->keys_count > 0) {
+			continue;
 		}
 
 		/* Check if the action is allowed. */
 		if (action != ACL_ACTION_NONE) {
-			val = conf_id_get(conf, C_ACL, C_ACTION, acl);
-			while (val.code == KNOT_EOK) {
-				if (conf_opt(&val) != action) {
-					conf_val_next(&val);
-					continue;
-				}
-
-				break;
-			}
-			switch (val.code) {
-			case KNOT_EOK: /* Check for action match. */
-				break;
-			case KNOT_ENOENT: /* Empty action list allowed with deny only. */
+			if (rule->actions == 0) {
+				/* Empty action list allowed with deny only. */
 				return false;
-			default: /* No match. */
-				goto next_acl;
+			}
+			if (!(rule->actions & (1 << action))) {
+				continue;
 			}
 		}
 
 		/* If the action is update, check for update rule match. */
 		if (action == ACL_ACTION_UPDATE &&
-		    !update_match(conf, acl, tsig->name, zone_name, query)) {
-			goto next_acl;
+		    !update_match(rule, tsig->name, zone_name, query)) {
+			continue;
 		}
 
 		/* Check if denied. */
-		val = conf_id_get(conf, C_ACL, C_DENY, acl);
-		if (conf_bool(&val)) {
+		if (rule->deny) {
 			return false;
 		}
 
 		/* Fill the output with tsig secret if provided. */
-		if (tsig->name != NULL) {
-			val = conf_id_get(conf, C_KEY, C_SECRET, &key_val);
-			tsig->secret.data = (uint8_t *)conf_bin(&val, &tsig->secret.size);
+		if (key != NULL) {
+			tsig->secret = key->secret;
 		}
 
 		return true;
-next_acl:
-		conf_val_next(acl);
 	}
 
 	return false;
@@ -45,13 +45,71 @@ typedef enum {
 	ACL_UPDATE_MATCH_SUB   = 2,
 } acl_update_owner_match_t;
 
+/*! \brief ACL rule address, network or address range. */
+typedef struct {
+	struct sockaddr_storage min; /*!< Address, network or range start. */
+	struct sockaddr_storage max; /*!< Range end, AF_UNSPEC if network. */
+	int prefix;                  /*!< Network prefix length. */
+} acl_addr_t;
+
+/*! \brief ACL rule TSIG key. */
+typedef struct {
+	knot_dname_t *name;                /*!< Key name (lower-case). */
+	dnssec_tsig_algorithm_t algorithm; /*!< Key algorithm. */
+	dnssec_binary_t secret;            /*!< Key secret. */
+} acl_key_t;
+
+/*! \brief Parsed ACL rule (one item of the 'acl' section). */
+typedef struct {
+	acl_addr_t *addrs;             /*!< Matching addresses (none = any). */
+	size_t addrs_count;
+	acl_key_t *keys;               /*!< Matching keys (none = unsigned only). */
+	size_t keys_count;
+	unsigned actions;              /*!< Bitmap of allowed actions. */
+	bool deny;                     /*!< Deny if matched. */
+	uint16_t *update_types;        /*!< Allowed update types (none = any). */
+	size_t update_types_count;
+	acl_update_owner_t update_owner;
+	acl_update_owner_match_t update_owner_match;
+	knot_dname_t **update_names;   /*!< Allowed update owners (none = any). */
+	size_t update_names_count;
+} acl_rule_t;
+
+/*!
+ * \brief ACL rule list parsed from confdb.
+ *
+ * \note The structure is immutable once created, so it can be evaluated
+ *       without any confdb access.
+ */
+typedef struct {
+	acl_rule_t *rules;
+	size_t count;
+} acl_rules_t;
+
+/*!
+ * \brief Parses the ACL rules referenced by the given multivalued identifier.
+ *
+ * \param conf  Configuration.
+ * \param acl   Pointer to ACL config multivalued identifier.
+ *
+ * \return Parsed rules (possibly empty), NULL if out of memory.
+ */
+acl_rules_t *acl_rules_new(conf_t *conf, conf_val_t *acl);
+
+/*!
+ * \brief Frees the parsed ACL rules.
+ *
+ * \param rules  Rules to be freed.
+ */
+void acl_rules_free(acl_rules_t *rules);
+
 /*!
- * \brief Checks if the address and/or tsig key matches given ACL list.
+ * \brief Checks if the address and/or tsig key matches given ACL rules.
  *
- * If a proper ACL rule is found and tsig.name is not empty, tsig.secret is filled.
+ * If a proper ACL rule is found and tsig.name is not empty, tsig.secret is
+ * filled. The secret is owned by the rules.
  *
- * \param conf       Configuration.
- * \param acl        Pointer to ACL config multivalued identifier.
+ * \param acl        Parsed ACL rules.
  * \param action     ACL action.
  * \param addr       IP address.
  * \param tsig       TSIG parameters.
@@ -60,6 +118,6 @@ typedef enum {
  *
  * \retval True if authenticated.
  */
-bool acl_allowed(conf_t *conf, conf_val_t *acl, acl_action_t action,
+bool acl_allowed(const acl_rules_t *acl, acl_action_t action,
                  const struct sockaddr_storage *addr, knot_tsig_key_t *tsig,
                  const knot_dname_t *zone_name, knot_pkt_t *query);
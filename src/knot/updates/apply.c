@@ -17,6 +17,7 @@
 #include <assert.h>
 
 #include "knot/common/log.h"
+#include "knot/dnssec/rrsig-index.h"
 #include "knot/updates/apply.h"
 #include "libknot/libknot.h"
 #include "contrib/macros.h"
@@ -397,6 +398,7 @@ void update_free_zone(zone_contents_t *contents)
 	free(contents->nsec3_nodes);
 
 	dnssec_nsec3_params_free(&contents->nsec3_params);
+	rrsig_index_free(contents->rrsig_index);
 
 	free(contents);
 }
@@ -706,7 +706,7 @@ void changeset_print(const changeset_t *changeset, FILE *outfile, bool color)
 		(void)knot_rrset_txt_dump(changeset->soa_from, &buff, &buflen, &KNOT_DUMP_STYLE_DEFAULT);
 		fprintf(outfile, "%s", buff);
 	}
-	(void)zone_dump_text(changeset->remove, outfile, false);
+	(void)zone_dump_text(changeset->remove, outfile, false, 1);
 
 	if (changeset->soa_to != NULL || !zone_contents_is_empty(changeset->add)) {
 		fprintf(outfile, "%s;;Added\n", color ? GRN : "");
@@ -715,7 +715,7 @@ void changeset_print(const changeset_t *changeset, FILE *outfile, bool color)
 		(void)knot_rrset_txt_dump(changeset->soa_to, &buff, &buflen, &KNOT_DUMP_STYLE_DEFAULT);
 		fprintf(outfile, "%s", buff);
 	}
-	(void)zone_dump_text(changeset->add, outfile, false);
+	(void)zone_dump_text(changeset->add, outfile, false, 1);
 
 	if (color) {
 		printf("%s", RESET);
@@ -18,6 +18,7 @@
 
 #include "libdnssec/error.h"
 #include "contrib/macros.h"
+#include "contrib/wire_ctx.h"
 #include "knot/common/log.h"
 #include "knot/dnssec/zone-nsec.h"
 #include "knot/zone/adds_tree.h"
@@ -141,6 +142,82 @@ int adjust_cb_nsec3_pointer(zone_node_t *node, adjust_ctx_t *ctx)
 	return ret;
 }
 
+/*!
+ * \brief Pre-render glue address RRSets for direct use in responses.
+ *
+ * The wire is stored in the glue node, so it's shared by all the delegations
+ * using the glue. Each RR is rendered with a two-byte placeholder instead of
+ * the owner, to be replaced with a pointer to the corresponding name in the
+ * RDATA. Glue with RRSIGs is skipped, as the signatures are added separately.
+ */
+static int render_glue(zone_node_t *node, adjust_ctx_t *ctx)
+{
+	const uint16_t types[] = { KNOT_RRTYPE_A, KNOT_RRTYPE_AAAA };
+
+	knot_rrset_t rrsets[2];
+	size_t lens[2] = { 0 };
+	for (int k = 0; k < 2; k++) {
+		rrsets[k] = node_rrset(node, types[k]);
+		knot_rdata_t *rdata = rrsets[k].rrs.rdata;
+		for (uint16_t i = 0; i < rrsets[k].rrs.count; i++) {
+			lens[k] += sizeof(uint16_t) + KNOT_WIRE_RR_MIN_SIZE - 1 + rdata->len;
+			rdata = knot_rdataset_next(rdata);
+		}
+	}
+	size_t total = lens[0] + lens[1];
+
+	glue_wire_t *glue_wire = NULL;
+	if (total > 0 && total <= KNOT_WIRE_MAX_PKTSIZE &&
+	    !node_rrtype_exists(node, KNOT_RRTYPE_RRSIG)) {
+		glue_wire = malloc(sizeof(*glue_wire) + total);
+		if (glue_wire == NULL) {
+			return KNOT_ENOMEM;
+		}
+		glue_wire->len[0] = lens[0];
+		glue_wire->len[1] = lens[1];
+
+		wire_ctx_t wire = wire_ctx_init(glue_wire->data, total);
+		for (int k = 0; k < 2; k++) {
+			knot_rdata_t *rdata = rrsets[k].rrs.rdata;
+			for (uint16_t i = 0; i < rrsets[k].rrs.count; i++) {
+				wire_ctx_write_u16(&wire, 0);
+				wire_ctx_write_u16(&wire, rrsets[k].type);
+				wire_ctx_write_u16(&wire, rrsets[k].rclass);
+				wire_ctx_write_u32(&wire, rrsets[k].ttl);
+				wire_ctx_write_u16(&wire, rdata->len);
+				wire_ctx_write(&wire, rdata->data, rdata->len);
+				rdata = knot_rdataset_next(rdata);
+			}
+		}
+		assert(wire.error == KNOT_EOK && wire_ctx_available(&wire) == 0);
+	}
+
+	// Keep the current wire if still valid, e.g. used by another delegation.
+	glue_wire_t *current = node->glue_wire;
+	if (glue_wire == NULL || current == NULL) {
+		if (glue_wire == current) {
+			return KNOT_EOK;
+		}
+	} else if (glue_wire->len[0] == current->len[0] &&
+	           glue_wire->len[1] == current->len[1] &&
+	           memcmp(glue_wire->data, current->data, total) == 0) {
+		free(glue_wire);
+		return KNOT_EOK;
+	}
+
+	zone_node_t *counter = binode_counterpart(node);
+	if (counter == NULL || counter->glue_wire != current) {
+		free(current);
+	}
+	node->glue_wire = glue_wire;
+
+	if (ctx->changed_nodes != NULL) {
+		return zone_tree_insert(ctx->changed_nodes, &node);
+	}
+
+	return KNOT_EOK;
+}
+
 /*! \brief Link pointers to additional nodes for this RRSet. */
 static int discover_additionals(zone_node_t *adjn, uint16_t rr_at,
                                 adjust_ctx_t *ctx)
@@ -180,6 +257,11 @@ static int discover_additionals(zone_node_t *adjn, uint16_t rr_at,
 		glue->node = node;
 		glue->ns_pos = i;
 		rdata = knot_rdataset_next(rdata);
+
+		int ret = render_glue((zone_node_t *)node, ctx);
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
 	}
 
 	/* Store sorted additionals by the type, mandatory first. */
@@ -15,12 +15,14 @@
  */
 
 #include <assert.h>
+#include <pthread.h>
 
 #include "libdnssec/error.h"
 #include "knot/zone/adds_tree.h"
 #include "knot/zone/adjust.h"
 #include "knot/zone/contents.h"
 #include "knot/common/log.h"
+#include "knot/dnssec/rrsig-index.h"
 #include "knot/dnssec/zone-nsec.h"
 #include "libknot/libknot.h"
 #include "contrib/qp-trie/trie.h"
@@ -182,6 +184,23 @@ static int recreate_nsec3_tree(const zone_contents_t *z, zone_contents_t *out)
 
 // Public API
 
+/*!
+ * \brief Returns a new unique contents generation.
+ */
+static uint64_t new_generation(void)
+{
+	static uint64_t last = 0;
+#ifdef HAVE_ATOMIC
+	return __atomic_add_fetch(&last, 1, __ATOMIC_RELAXED);
+#else
+	static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	pthread_mutex_lock(&lock);
+	uint64_t generation = ++last;
+	pthread_mutex_unlock(&lock);
+	return generation;
+#endif
+}
+
 zone_contents_t *zone_contents_new(const knot_dname_t *apex_name, bool use_binodes)
 {
 	if (apex_name == NULL) {
@@ -207,6 +226,7 @@ zone_contents_t *zone_contents_new(const knot_dname_t *apex_name, bool use_binod
 		goto cleanup;
 	}
 	contents->apex->flags |= NODE_FLAGS_APEX;
+	contents->generation = new_generation();
 
 	return contents;
 
@@ -498,6 +518,7 @@ int zone_contents_shallow_copy(const zone_contents_t *from, zone_contents_t **to
 	}
 	contents->adds_tree = from->adds_tree;
 	contents->size = from->size;
+	contents->generation = new_generation();
 
 	*to = contents;
 	return KNOT_EOK;
@@ -515,6 +536,7 @@ void zone_contents_free(zone_contents_t *contents)
 
 	dnssec_nsec3_params_free(&contents->nsec3_params);
 	additionals_tree_free(contents->adds_tree);
+	rrsig_index_free(contents->rrsig_index);
 
 	free(contents);
 }
@@ -35,6 +35,8 @@ typedef struct zone_contents {
 	trie_t *adds_tree; // "additionals tree" for reverse lookup of nodes affected by additionals
 
 	dnssec_nsec3_params_t nsec3_params;
+	struct rrsig_index *rrsig_index; /*!< Index of RRSIG expirations, not inherited by copies. */
+	uint64_t generation;     /*!< Unique identifier of this contents instance. */
 	size_t size;
 	uint32_t max_ttl;
 	bool dnssec;
@@ -165,6 +165,9 @@ void binode_unify(zone_node_t *node, bool free_deleted, knot_mm_t *mm)
 		if (counter->nsec3_wildcard_name != node->nsec3_wildcard_name) {
 			free(counter->nsec3_wildcard_name);
 		}
+		if (counter->glue_wire != node->glue_wire) {
+			free(counter->glue_wire);
+		}
 		if (!(counter->flags & NODE_FLAGS_NSEC3_NODE) && node->nsec3_hash != counter->nsec3_hash) {
 			free(counter->nsec3_hash);
 		}
@@ -284,8 +287,11 @@ void node_free(zone_node_t *node, knot_mm_t *mm)
 	assert((node->flags & NODE_FLAGS_BINODE) || !(node->flags & NODE_FLAGS_SECOND));
 	assert(binode_counterpart(node) == NULL ||
 	       binode_counterpart(node)->nsec3_wildcard_name == node->nsec3_wildcard_name);
+	assert(binode_counterpart(node) == NULL ||
+	       binode_counterpart(node)->glue_wire == node->glue_wire);
 
 	free(node->nsec3_wildcard_name);
+	free(node->glue_wire);
 	if (!(node->flags & NODE_FLAGS_NSEC3_NODE)) {
 		free(node->nsec3_hash);
 	}
@@ -25,6 +25,12 @@
 
 struct rr_data;
 
+/*!< \brief Pre-rendered glue address RRSets. */
+typedef struct {
+	uint16_t len[2]; /*!< Lengths of the A and AAAA RRSets. */
+	uint8_t data[];  /*!< The RRSets with owner placeholders (see knot_pkt_put_wire). */
+} glue_wire_t;
+
 /*!
  * \brief Structure representing one node in a domain name tree, i.e. one domain
  *        name in a zone.
@@ -46,6 +52,7 @@ typedef struct zone_node {
 		struct zone_node *nsec3_node; /*! NSEC3 node corresponding to this node. */
 	};
 	knot_dname_t *nsec3_wildcard_name; /*! Name of NSEC3 node proving wildcard nonexistence. */
+	glue_wire_t *glue_wire; /*!< Pre-rendered A and AAAA RRSets if the node is a glue. */
 	uint32_t children; /*!< Count of children nodes in DNS hierarchy. */
 	uint16_t rrset_count; /*!< Number of RRSets stored in the node. */
 	uint16_t flags; /*!< \ref node_flags enum. */
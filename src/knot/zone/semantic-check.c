@@ -14,6 +14,7 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <pthread.h>
 #include <stdio.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -22,6 +23,7 @@
 
 #include "libdnssec/error.h"
 #include "contrib/base32hex.h"
+#include "contrib/macros.h"
 #include "contrib/string.h"
 #include "libknot/libknot.h"
 #include "knot/zone/semantic-check.h"
@@ -146,16 +148,56 @@ typedef enum {
 	OPTIONAL =  1 << 1,
 	NSEC =      1 << 2,
 	NSEC3 =     1 << 3,
+	VERIFY =    1 << 4,
 } check_level_t;
 
+/*! \brief Apex DNSKEY prepared for RRSIG verification. */
+typedef struct {
+	dnssec_key_t *key;
+	dnssec_sign_ctx_t *sign_ctx;
+	uint16_t keytag;
+	uint8_t algorithm;
+} sem_key_t;
+
+/*! \brief Verification keys, loaded on first use by each checking thread. */
+typedef struct {
+	sem_key_t *keys;
+	size_t count;
+	bool loaded;
+} sem_keyset_t;
+
 typedef struct {
 	zone_contents_t *zone;
 	sem_handler_t *handler;
 	const zone_node_t *next_nsec;
 	check_level_t level;
 	time_t time;
+	bool partition;               // Checking a part of the zone in parallel.
+	const zone_node_t *first_nsec; // First NSEC node checked in the part.
+	size_t first_nsec_pos;         // Number of errors preceding its chain check.
+	sem_keyset_t keyset;           // Keys for RRSIG verification (with VERIFY).
 } semchecks_data_t;
 
+/*! \brief Semantic error recorded during parallel checks. */
+typedef struct {
+	const zone_node_t *node;
+	sem_error_t error;
+	char *data;
+} sem_record_t;
+
+/*! \brief Zone part checked by one thread. */
+typedef struct {
+	sem_handler_t handler;    // Recording handler, must be the first item.
+	sem_record_t *records;
+	size_t records_count;
+	size_t records_max;
+	semchecks_data_t data;
+	zone_node_t **nodes;
+	size_t nodes_count;
+	pthread_t thread;
+	int ret;
+} sem_part_t;
+
 static int check_cname(const zone_node_t *node, semchecks_data_t *data);
 static int check_dname(const zone_node_t *node, semchecks_data_t *data);
 static int check_delegation(const zone_node_t *node, semchecks_data_t *data);
@@ -181,8 +223,8 @@ static const struct check_function CHECK_FUNCTIONS[] = {
 	{ check_delegation,     MANDATORY }, // mandatory for apex, optional for others
 	{ check_submission,     OPTIONAL },
 	{ check_ds,             OPTIONAL },
-	{ check_rrsig,          NSEC | NSEC3 },
-	{ check_rrsig_signed,   NSEC | NSEC3 },
+	{ check_rrsig,          NSEC | NSEC3 | VERIFY },
+	{ check_rrsig_signed,   NSEC | NSEC3 | VERIFY },
 	{ check_nsec_bitmap,    NSEC | NSEC3 },
 	{ check_nsec,           NSEC },
 	{ check_nsec3,          NSEC3 },
@@ -227,43 +269,82 @@ static int dnssec_key_from_rdata(dnssec_key_t **key, const knot_dname_t *owner,
 	return KNOT_EOK;
 }
 
-static int check_signature(const knot_rdata_t *rrsig, const dnssec_key_t *key,
-                           const knot_rrset_t *covered)
+static void keyset_free(sem_keyset_t *keyset)
 {
-	if (!rrsig || !key || !dnssec_key_can_verify(key)) {
-		return KNOT_EINVAL;
+	for (size_t i = 0; i < keyset->count; i++) {
+		dnssec_sign_free(keyset->keys[i].sign_ctx);
+		dnssec_key_free(keyset->keys[i].key);
 	}
+	free(keyset->keys);
+	memset(keyset, 0, sizeof(*keyset));
+}
 
-	int ret = KNOT_EOK;
-	dnssec_sign_ctx_t *sign_ctx = NULL;
+/*!
+ * \brief Prepare the zone signing keys from the apex DNSKEY for verification.
+ *
+ * The signing contexts aren't thread-safe, so each thread has its own keyset.
+ */
+static int keyset_load(sem_keyset_t *keyset, const zone_contents_t *zone)
+{
+	keyset->loaded = true;
+
+	const knot_rdataset_t *dnskeys = node_rdataset(zone->apex, KNOT_RRTYPE_DNSKEY);
+	if (dnskeys == NULL) {
+		return KNOT_EOK;
+	}
 
+	keyset->keys = calloc(dnskeys->count, sizeof(*keyset->keys));
+	if (keyset->keys == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	knot_rdata_t *dnskey = dnskeys->rdata;
+	for (int i = 0; i < dnskeys->count; i++, dnskey = knot_rdataset_next(dnskey)) {
+		/* RFC 4034 2.1.1 & 2.1.2 */
+		if (!(knot_dnskey_flags(dnskey) & DNSKEY_FLAGS_ZSK) ||
+		    knot_dnskey_proto(dnskey) != 3) {
+			continue;
+		}
+
+		sem_key_t *key = &keyset->keys[keyset->count];
+		if (dnssec_key_from_rdata(&key->key, zone->apex->owner,
+		                          dnskey->data, dnskey->len) != KNOT_EOK) {
+			continue;
+		}
+		if (!dnssec_key_can_verify(key->key) ||
+		    dnssec_sign_new(&key->sign_ctx, key->key) != DNSSEC_EOK) {
+			dnssec_key_free(key->key);
+			continue;
+		}
+		key->keytag = dnssec_key_get_keytag(key->key);
+		key->algorithm = dnssec_key_get_algorithm(key->key);
+		keyset->count++;
+	}
+
+	return KNOT_EOK;
+}
+
+static int check_signature(const knot_rdata_t *rrsig, sem_key_t *key,
+                           const knot_rrset_t *covered)
+{
 	dnssec_binary_t signature = {
 		.size = knot_rrsig_signature_len(rrsig),
 		.data = (uint8_t *)knot_rrsig_signature(rrsig)
 	};
 	if (!signature.data || !signature.size) {
-		ret = KNOT_EINVAL;
-		goto fail;
-	}
-
-	if (dnssec_sign_new(&sign_ctx, key) != KNOT_EOK) {
-		ret = KNOT_ENOMEM;
-		goto fail;
+		return KNOT_EINVAL;
 	}
 
-	if (knot_sign_ctx_add_data(sign_ctx, rrsig->data, covered) != KNOT_EOK) {
-		ret = KNOT_ENOMEM;
-		goto fail;
+	if (dnssec_sign_init(key->sign_ctx) != DNSSEC_EOK ||
+	    knot_sign_ctx_add_data(key->sign_ctx, rrsig->data, covered) != KNOT_EOK) {
+		return KNOT_ENOMEM;
 	}
 
-	if (dnssec_sign_verify(sign_ctx, &signature) != KNOT_EOK) {
-		ret = KNOT_EINVAL;
-		goto fail;
+	if (dnssec_sign_verify(key->sign_ctx, &signature) != DNSSEC_EOK) {
+		return KNOT_EINVAL;
 	}
 
-fail:
-	dnssec_sign_free(sign_ctx);
-	return ret;
+	return KNOT_EOK;
 }
 
 /*!
@@ -275,7 +356,7 @@ fail:
  * \param rrsig      RRSIG rdata.
  * \param rrset      RRSet signed by the RRSIG.
  * \param context    The time stamp we check the rrsig validity according to.
- * \param level      Level of the check.
+ * \param keyset     Keys to verify the RRSIG with, NULL to skip verification.
  * \param verified   Out: the RRSIG has been verified to be signed by existing DNSKEY.
  *
  * \retval KNOT_EOK on success.
@@ -287,7 +368,7 @@ static int check_rrsig_rdata(sem_handler_t *handler,
                              const knot_rdata_t *rrsig,
                              const knot_rrset_t *rrset,
                              time_t context,
-                             check_level_t level,
+                             const sem_keyset_t *keyset,
                              bool *verified)
 {
 	/* Prepare additional info string. */
@@ -346,32 +427,17 @@ static int check_rrsig_rdata(sem_handler_t *handler,
 	}
 
 	/* Verify with public key - only one RRSIG of covered record needed */
-	if (level & OPTIONAL && !*verified) {
-		const knot_rdataset_t *dnskeys = node_rdataset(zone->apex, KNOT_RRTYPE_DNSKEY);
-		if (dnskeys == NULL) {
-			return KNOT_EOK;
-		}
-
-		for (int i = 0; i < dnskeys->count; i++) {
-			knot_rdata_t *dnskey = knot_rdataset_at(dnskeys, i);
-			uint16_t flags = knot_dnskey_flags(dnskey);
-			uint8_t proto = knot_dnskey_proto(dnskey);
-			/* RFC 4034 2.1.1 & 2.1.2 */
-			if (flags & DNSKEY_FLAGS_ZSK && proto == 3) {
-				dnssec_key_t *key;
-
-				ret = dnssec_key_from_rdata(&key, zone->apex->owner,
-				                            dnskey->data, dnskey->len);
-				if (ret != KNOT_EOK) {
-					continue;
-				}
-
-				ret = check_signature(rrsig, key, rrset);
-				dnssec_key_free(key);
-				if (ret == KNOT_EOK) {
-					*verified = true;
-					break;
-				}
+	if (keyset != NULL && !*verified) {
+		uint16_t keytag = knot_rrsig_key_tag(rrsig);
+		uint8_t algorithm = knot_rrsig_alg(rrsig);
+		for (size_t i = 0; i < keyset->count; i++) {
+			sem_key_t *key = &keyset->keys[i];
+			if (key->keytag != keytag || key->algorithm != algorithm) {
+				continue;
+			}
+			if (check_signature(rrsig, key, rrset) == KNOT_EOK) {
+				*verified = true;
+				break;
 			}
 		}
 	}
@@ -397,7 +463,7 @@ static int check_rrsig_signed(const zone_node_t *node, semchecks_data_t *data)
  * \param node       The node in the zone contents.
  * \param rrset      RRSet signed by the RRSIG.
  * \param context    The time stamp we check the rrsig validity according to.
- * \param level      Level of the check.
+ * \param keyset     Keys to verify the RRSIGs with, NULL to skip verification.
  *
  * \retval KNOT_EOK on success.
  * \return Appropriate error code if error was found.
@@ -407,7 +473,7 @@ static int check_rrsig_in_rrset(sem_handler_t *handler,
                                 const zone_node_t *node,
                                 const knot_rrset_t *rrset,
                                 time_t context,
-                                check_level_t level)
+                                const sem_keyset_t *keyset)
 {
 	if (handler == NULL || node == NULL || rrset == NULL) {
 		return KNOT_EINVAL;
@@ -438,7 +504,7 @@ static int check_rrsig_in_rrset(sem_handler_t *handler,
 	knot_rdata_t *rrsig = rrsigs.rdata;
 	for (uint16_t i = 0; ret == KNOT_EOK && i < rrsigs.count; ++i) {
 		ret = check_rrsig_rdata(handler, zone, node, rrsig, rrset,
-		                        context, level, &verified);
+		                        context, keyset, &verified);
 		rrsig = knot_rdataset_next(rrsig);
 	}
 	/* Only one rrsig of covered record needs to be verified by DNSKEY. */
@@ -688,6 +754,10 @@ static int check_rrsig(const zone_node_t *node, semchecks_data_t *data)
 	bool deleg = node->flags & NODE_FLAGS_DELEG;
 
 	int ret = KNOT_EOK;
+	if ((data->level & VERIFY) && !data->keyset.loaded) {
+		ret = keyset_load(&data->keyset, data->zone);
+	}
+	const sem_keyset_t *keyset = (data->level & VERIFY) ? &data->keyset : NULL;
 
 	int rrset_count = node->rrset_count;
 	for (int i = 0; ret == KNOT_EOK && i < rrset_count; i++) {
@@ -701,7 +771,7 @@ static int check_rrsig(const zone_node_t *node, semchecks_data_t *data)
 		}
 
 		ret = check_rrsig_in_rrset(data->handler, data->zone, node, &rrset,
-		                           data->time, data->level);
+		                           data->time, keyset);
 	}
 	return ret;
 }
@@ -840,7 +910,11 @@ static int check_nsec(const zone_node_t *node, semchecks_data_t *data)
 		                  SEM_ERR_NSEC_RDATA_MULTIPLE, NULL);
 	}
 
-	if (data->next_nsec != node) {
+	if (data->partition && data->first_nsec == NULL) {
+		// The link from the previous part is checked after all parts.
+		data->first_nsec = node;
+		data->first_nsec_pos = ((sem_part_t *)data->handler)->records_count;
+	} else if (data->next_nsec != node) {
 		data->handler->cb(data->handler, data->zone, node,
 		                  SEM_ERR_NSEC_RDATA_CHAIN, NULL);
 	}
@@ -1226,8 +1300,182 @@ static void check_dnskey(zone_contents_t *zone, sem_handler_t *handler)
 	}
 }
 
+static void record_error(sem_handler_t *handler, const zone_contents_t *zone,
+                         const zone_node_t *node, sem_error_t error, const char *data)
+{
+	sem_part_t *part = (sem_part_t *)handler;
+	if (part->ret != KNOT_EOK) {
+		return;
+	}
+
+	if (part->records_count == part->records_max) {
+		size_t new_max = MAX(2 * part->records_max, 16);
+		sem_record_t *new_records = realloc(part->records,
+		                                    new_max * sizeof(*new_records));
+		if (new_records == NULL) {
+			part->ret = KNOT_ENOMEM;
+			return;
+		}
+		part->records = new_records;
+		part->records_max = new_max;
+	}
+
+	char *copy = NULL;
+	if (data != NULL) {
+		copy = strdup(data);
+		if (copy == NULL) {
+			part->ret = KNOT_ENOMEM;
+			return;
+		}
+	}
+
+	part->records[part->records_count++] = (sem_record_t) {
+		.node = node,
+		.error = error,
+		.data = copy
+	};
+}
+
+static void replay_errors(sem_part_t *part, size_t from, size_t to,
+                          sem_handler_t *handler, zone_contents_t *zone)
+{
+	for (size_t i = from; i < to; i++) {
+		sem_record_t *record = &part->records[i];
+		handler->cb(handler, zone, record->node, record->error, record->data);
+	}
+}
+
+static void *check_part(void *arg)
+{
+	sem_part_t *part = arg;
+
+	// Stop also if an error couldn't be recorded.
+	for (size_t i = 0; i < part->nodes_count && part->ret == KNOT_EOK; i++) {
+		int ret = do_checks_in_tree(part->nodes[i], &part->data);
+		if (ret != KNOT_EOK) {
+			part->ret = ret;
+		}
+	}
+
+	return NULL;
+}
+
+static int collect_node(zone_node_t *node, void *data)
+{
+	zone_node_t ***next = data;
+	*(*next)++ = node;
+	return KNOT_EOK;
+}
+
+static int do_checks_sequential(semchecks_data_t *data, zone_tree_t *nodes,
+                                zone_tree_t *nsec3_nodes)
+{
+	int ret = zone_tree_apply(nodes, do_checks_in_tree, data);
+	if (ret == KNOT_EOK) {
+		ret = zone_tree_apply(nsec3_nodes, do_checks_in_tree, data);
+	}
+	keyset_free(&data->keyset);
+
+	return ret;
+}
+
+static int do_checks_parallel(semchecks_data_t *data, unsigned threads,
+                              zone_tree_t *nodes_tree, zone_tree_t *nsec3_tree)
+{
+	size_t count = zone_tree_count(nodes_tree) + zone_tree_count(nsec3_tree);
+	if (threads > count) {
+		threads = count;
+	}
+	if (threads <= 1) {
+		return do_checks_sequential(data, nodes_tree, nsec3_tree);
+	}
+
+	zone_node_t **nodes = malloc(count * sizeof(*nodes));
+	sem_part_t *parts = calloc(threads, sizeof(*parts));
+	if (nodes == NULL || parts == NULL) {
+		free(nodes);
+		free(parts);
+		return KNOT_ENOMEM;
+	}
+
+	// Split the nodes in the canonical order into contiguous parts.
+	zone_node_t **next = nodes;
+	int ret = zone_tree_apply(nodes_tree, collect_node, &next);
+	if (ret == KNOT_EOK) {
+		ret = zone_tree_apply(nsec3_tree, collect_node, &next);
+	}
+	assert(ret == KNOT_EOK && next == nodes + count);
+
+	unsigned started = 0;
+	for (unsigned i = 0; i < threads; i++) {
+		sem_part_t *part = &parts[i];
+		size_t first = count * i / threads;
+		part->handler.cb = record_error;
+		part->nodes = nodes + first;
+		part->nodes_count = count * (i + 1) / threads - first;
+		part->data = *data;
+		part->data.handler = &part->handler;
+		part->data.partition = true;
+
+		ret = pthread_create(&part->thread, NULL, check_part, part);
+		if (ret != 0) {
+			ret = knot_map_errno_code(ret);
+			break;
+		}
+		started++;
+	}
+
+	for (unsigned i = 0; i < started; i++) {
+		pthread_join(parts[i].thread, NULL);
+	}
+
+	// Report the errors in the order of a sequential check.
+	for (unsigned i = 0; i < started && ret == KNOT_EOK; i++) {
+		sem_part_t *part = &parts[i];
+		size_t records = part->records_count;
+		if (part->ret == KNOT_ENOMEM) {
+			ret = KNOT_ENOMEM;
+			break;
+		}
+
+		if (part->data.first_nsec != NULL) {
+			replay_errors(part, 0, part->data.first_nsec_pos, data->handler,
+			              data->zone);
+			if (data->next_nsec != part->data.first_nsec) {
+				data->handler->cb(data->handler, data->zone,
+				                  part->data.first_nsec,
+				                  SEM_ERR_NSEC_RDATA_CHAIN, NULL);
+			}
+			data->next_nsec = part->data.next_nsec;
+			replay_errors(part, part->data.first_nsec_pos, records,
+			              data->handler, data->zone);
+		} else {
+			replay_errors(part, 0, records, data->handler, data->zone);
+		}
+
+		data->handler->fatal_error |= part->handler.fatal_error;
+		data->handler->warning |= part->handler.warning;
+
+		if (part->ret != KNOT_EOK) {
+			ret = part->ret;
+		}
+	}
+
+	for (unsigned i = 0; i < threads; i++) {
+		for (size_t j = 0; j < parts[i].records_count; j++) {
+			free(parts[i].records[j].data);
+		}
+		free(parts[i].records);
+		keyset_free(&parts[i].data.keyset);
+	}
+	free(parts);
+	free(nodes);
+
+	return ret;
+}
+
 int sem_checks_process(zone_contents_t *zone, bool optional, sem_handler_t *handler,
-                       time_t time)
+                       time_t time, unsigned threads)
 {
 	if (zone == NULL || handler == NULL) {
 		return KNOT_EINVAL;
@@ -1252,11 +1500,12 @@ int sem_checks_process(zone_contents_t *zone, bool optional, sem_handler_t *hand
 			} else {
 				data.level |= NSEC;
 			}
+			data.level |= VERIFY;
 			check_dnskey(zone, handler);
 		}
 	}
 
-	int ret = zone_contents_apply(zone, do_checks_in_tree, &data);
+	int ret = do_checks_parallel(&data, threads, zone->nodes, NULL);
 	if (ret != KNOT_EOK) {
 		return ret;
 	}
@@ -1274,3 +1523,32 @@ int sem_checks_process(zone_contents_t *zone, bool optional, sem_handler_t *hand
 
 	return KNOT_EOK;
 }
+
+int sem_checks_dnssec(zone_contents_t *zone, zone_tree_t *nodes, zone_tree_t *nsec3_nodes,
+                      sem_handler_t *handler, time_t time, unsigned threads)
+{
+	if (zone == NULL || handler == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	semchecks_data_t data = {
+		.handler = handler,
+		.zone = zone,
+		.level = VERIFY,
+		.time = time,
+	};
+
+	check_dnskey(zone, handler);
+
+	if (nodes == NULL && nsec3_nodes == NULL) {
+		nodes = zone->nodes;
+		nsec3_nodes = zone->nsec3_nodes;
+	}
+
+	int ret = do_checks_parallel(&data, threads, nodes, nsec3_nodes);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	return (handler->fatal_error || handler->warning) ? KNOT_ESEMCHECK : KNOT_EOK;
+}
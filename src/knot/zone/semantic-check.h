@@ -117,10 +117,33 @@ struct sem_handler {
  * \param optional  To do also optional check.
  * \param handler   Semantic error handler.
  * \param time      Check zone at given time (rrsig expiration).
+ * \param threads   Number of threads checking disjoint parts of the zone.
+ *                  The errors are reported in the same order regardless.
  *
  * \retval KNOT_EOK no error found
  * \retval KNOT_ESEMCHECK found semantic error
  * \retval KNOT_EINVAL or other error
  */
 int sem_checks_process(zone_contents_t *zone, bool optional, sem_handler_t *handler,
-                       time_t time);
+                       time_t time, unsigned threads);
+
+/*!
+ * \brief Verify the RRSIGs in the zone using the DNSKEYs at the zone apex.
+ *
+ * Every authoritative RRSet must be covered by a valid signature made by one
+ * of the zone signing keys.
+ *
+ * \param zone         Zone contents.
+ * \param nodes        Nodes to be verified, NULL for all nodes.
+ * \param nsec3_nodes  NSEC3 nodes to be verified, NULL for all NSEC3 nodes
+ *                     (only if nodes is NULL too).
+ * \param handler      Semantic error handler.
+ * \param time         Verify the signatures at given time.
+ * \param threads      Number of threads verifying disjoint parts of the nodes.
+ *
+ * \retval KNOT_EOK all signatures are valid
+ * \retval KNOT_ESEMCHECK some error was reported to the handler
+ * \retval KNOT_EINVAL or other error
+ */
+int sem_checks_dnssec(zone_contents_t *zone, zone_tree_t *nodes, zone_tree_t *nsec3_nodes,
+                      sem_handler_t *handler, time_t time, unsigned threads);
@@ -15,19 +15,30 @@
  */
 
 #include <inttypes.h>
+#include <pthread.h>
 
 #include "knot/dnssec/zone-nsec.h"
 #include "knot/zone/zone-dump.h"
 #include "libknot/libknot.h"
+#include "contrib/macros.h"
 
 /*! \brief Size of auxiliary buffer. */
 #define DUMP_BUF_LEN (70 * 1024)
 
+/*! \brief Output size written to the file at once. */
+#define DUMP_WRITE_LEN (1024 * 1024)
+
+/*! \brief Number of nodes dumped by one thread in a round. */
+#define DUMP_PART_NODES 16384
+
 /*! \brief Dump parameters. */
 typedef struct {
 	FILE     *file;
 	char     *buf;
 	size_t   buflen;
+	char     *out;
+	size_t   out_len;
+	size_t   out_max;
 	uint64_t rr_count;
 	bool     dump_rrsig;
 	bool     dump_nsec;
@@ -36,6 +47,52 @@ typedef struct {
 	const char *first_comment;
 } dump_params_t;
 
+static int flush_out(dump_params_t *params)
+{
+	if (params->out_len > 0 &&
+	    fwrite(params->out, 1, params->out_len, params->file) != params->out_len) {
+		return KNOT_EFILE;
+	}
+	params->out_len = 0;
+
+	return KNOT_EOK;
+}
+
+static int append_out(dump_params_t *params, const char *data, size_t len)
+{
+	if (params->out_len + len > params->out_max) {
+		size_t new_max = MAX(2 * params->out_max, params->out_len + len);
+		char *new_out = realloc(params->out, new_max);
+		if (new_out == NULL) {
+			return KNOT_ENOMEM;
+		}
+		params->out = new_out;
+		params->out_max = new_max;
+	}
+
+	memcpy(params->out + params->out_len, data, len);
+	params->out_len += len;
+
+	// Sequential dump writes the output in large blocks.
+	if (params->file != NULL && params->out_len >= DUMP_WRITE_LEN) {
+		return flush_out(params);
+	}
+
+	return KNOT_EOK;
+}
+
+static int rrset_dump_text(const knot_rrset_t *rrset, dump_params_t *params,
+                           const knot_dump_style_t *style)
+{
+	int ret = knot_rrset_txt_dump(rrset, &params->buf, &params->buflen, style);
+	if (ret < 0) {
+		return ret;
+	}
+	params->rr_count += rrset->rrs.count;
+
+	return append_out(params, params->buf, ret);
+}
+
 static int apex_node_dump_text(zone_node_t *node, dump_params_t *params)
 {
 	knot_rrset_t soa = node_rrset(node, KNOT_RRTYPE_SOA);
@@ -43,14 +100,10 @@ static int apex_node_dump_text(zone_node_t *node, dump_params_t *params)
 
 	// Dump SOA record as a first.
 	if (!params->dump_nsec) {
-		int ret = knot_rrset_txt_dump(&soa, &params->buf, &params->buflen,
-		                              &soa_style);
-		if (ret < 0) {
+		int ret = rrset_dump_text(&soa, params, &soa_style);
+		if (ret != KNOT_EOK) {
 			return ret;
 		}
-		params->rr_count += soa.rrs.count;
-		fprintf(params->file, "%s", params->buf);
-		params->buf[0] = '\0';
 	}
 
 	// Dump other records.
@@ -67,14 +120,10 @@ static int apex_node_dump_text(zone_node_t *node, dump_params_t *params)
 			break;
 		}
 
-		int ret = knot_rrset_txt_dump(&rrset, &params->buf, &params->buflen,
-		                              params->style);
-		if (ret < 0) {
+		int ret = rrset_dump_text(&rrset, params, params->style);
+		if (ret != KNOT_EOK) {
 			return ret;
 		}
-		params->rr_count +=  rrset.rrs.count;
-		fprintf(params->file, "%s", params->buf);
-		params->buf[0] = '\0';
 	}
 
 	return KNOT_EOK;
@@ -119,32 +168,299 @@ static int node_dump_text(zone_node_t *node, void *data)
 
 		// Dump block comment if available.
 		if (params->first_comment != NULL) {
-			fprintf(params->file, "%s", params->first_comment);
+			int ret = append_out(params, params->first_comment,
+			                     strlen(params->first_comment));
+			if (ret != KNOT_EOK) {
+				return ret;
+			}
 			params->first_comment = NULL;
 		}
 
-		int ret = knot_rrset_txt_dump(&rrset, &params->buf, &params->buflen,
-		                              params->style);
-		if (ret < 0) {
+		int ret = rrset_dump_text(&rrset, params, params->style);
+		if (ret != KNOT_EOK) {
 			return ret;
 		}
-		params->rr_count += rrset.rrs.count;
-		fprintf(params->file, "%s", params->buf);
-		params->buf[0] = '\0';
 	}
 
 	return KNOT_EOK;
 }
 
-int zone_dump_text(zone_contents_t *zone, FILE *file, bool comments)
+/*! \brief Synchronization of the dump rounds between the threads. */
+typedef struct {
+	pthread_mutex_t mx;
+	pthread_cond_t start; /*!< Signaled when a round starts or the dump ends. */
+	pthread_cond_t done;  /*!< Signaled when the workers finish a round. */
+	unsigned round;       /*!< Number of the current round. */
+	unsigned pending;     /*!< Number of workers busy in the current round. */
+	bool exit;            /*!< No more rounds indicator. */
+} dump_sync_t;
+
+/*! \brief Nodes dumped by one thread into its own output buffer. */
+typedef struct {
+	dump_params_t params;
+	zone_node_t **nodes;
+	size_t nodes_count;
+	dump_sync_t *sync;
+	pthread_t thread;
+	int ret;
+} dump_part_t;
+
+static void dump_part(dump_part_t *part)
+{
+	for (size_t i = 0; i < part->nodes_count && part->ret == KNOT_EOK; i++) {
+		part->ret = node_dump_text(part->nodes[i], &part->params);
+	}
+}
+
+static void *dump_worker(void *arg)
+{
+	dump_part_t *part = arg;
+	dump_sync_t *sync = part->sync;
+	unsigned round = 0;
+
+	pthread_mutex_lock(&sync->mx);
+	while (true) {
+		while (!sync->exit && sync->round == round) {
+			pthread_cond_wait(&sync->start, &sync->mx);
+		}
+		if (sync->exit) {
+			break;
+		}
+		round = sync->round;
+		pthread_mutex_unlock(&sync->mx);
+
+		dump_part(part);
+
+		pthread_mutex_lock(&sync->mx);
+		if (--sync->pending == 0) {
+			pthread_cond_signal(&sync->done);
+		}
+	}
+	pthread_mutex_unlock(&sync->mx);
+
+	return NULL;
+}
+
+/*!
+ * \brief Starts the worker threads dumping the parts but the first one.
+ *
+ * \return Number of threads dumping the zone, including the calling one.
+ */
+static unsigned dump_workers_start(dump_sync_t *sync, dump_part_t *parts,
+                                   unsigned threads)
+{
+	unsigned started = 1;
+	for (; started < threads; started++) {
+		parts[started].sync = sync;
+		if (pthread_create(&parts[started].thread, NULL, dump_worker,
+		                   &parts[started]) != 0) {
+			break;
+		}
+	}
+
+	return started;
+}
+
+static void dump_workers_stop(dump_sync_t *sync, dump_part_t *parts,
+                              unsigned threads)
+{
+	pthread_mutex_lock(&sync->mx);
+	sync->exit = true;
+	pthread_cond_broadcast(&sync->start);
+	pthread_mutex_unlock(&sync->mx);
+
+	for (unsigned i = 1; i < threads; i++) {
+		pthread_join(parts[i].thread, NULL);
+	}
+}
+
+/*!
+ * \brief Dumps the nodes in parallel.
+ *
+ * The nodes are processed in rounds, each thread formats a contiguous part
+ * of the nodes into memory and the outputs are written in the node order.
+ */
+static int dump_nodes_parallel(zone_node_t **nodes, size_t count,
+                               dump_params_t *params, dump_part_t *parts,
+                               dump_sync_t *sync, unsigned threads)
+{
+	int ret = KNOT_EOK;
+
+	for (size_t round = 0; round < count && ret == KNOT_EOK;
+	     round += threads * DUMP_PART_NODES) {
+		for (unsigned i = 0; i < threads; i++) {
+			dump_part_t *part = &parts[i];
+			size_t first = round + i * DUMP_PART_NODES;
+			part->nodes = nodes + MIN(first, count);
+			part->nodes_count = (first < count) ? MIN(DUMP_PART_NODES, count - first) : 0;
+			part->params.dump_rrsig = params->dump_rrsig;
+			part->params.dump_nsec = params->dump_nsec;
+			part->ret = KNOT_EOK;
+		}
+
+		// The first part is dumped by the calling thread.
+		pthread_mutex_lock(&sync->mx);
+		sync->round++;
+		sync->pending = threads - 1;
+		pthread_cond_broadcast(&sync->start);
+		pthread_mutex_unlock(&sync->mx);
+
+		dump_part(&parts[0]);
+
+		pthread_mutex_lock(&sync->mx);
+		while (sync->pending > 0) {
+			pthread_cond_wait(&sync->done, &sync->mx);
+		}
+		pthread_mutex_unlock(&sync->mx);
+
+		for (unsigned i = 0; i < threads; i++) {
+			if (parts[i].ret != KNOT_EOK && ret == KNOT_EOK) {
+				ret = parts[i].ret;
+			}
+		}
+
+		// Write the outputs in the canonical order.
+		for (unsigned i = 0; i < threads; i++) {
+			dump_part_t *part = &parts[i];
+			if (ret == KNOT_EOK && part->params.out_len > 0) {
+				if (params->first_comment != NULL) {
+					fputs(params->first_comment, params->file);
+					params->first_comment = NULL;
+				}
+				part->params.file = params->file;
+				ret = flush_out(&part->params);
+				part->params.file = NULL;
+			}
+			part->params.out_len = 0;
+			params->rr_count += part->params.rr_count;
+			part->params.rr_count = 0;
+		}
+	}
+
+	return ret;
+}
+
+static int collect_node(zone_node_t *node, void *data)
+{
+	zone_node_t ***next = data;
+	*(*next)++ = node;
+	return KNOT_EOK;
+}
+
+static int collect_nodes(zone_contents_t *zone, bool nsec3, zone_node_t ***nodes,
+                         size_t *count)
+{
+	*count = zone_tree_count(nsec3 ? zone->nsec3_nodes : zone->nodes);
+	*nodes = malloc(MAX(*count, 1) * sizeof(**nodes));
+	if (*nodes == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	zone_node_t **next = *nodes;
+	if (nsec3) {
+		return zone_contents_nsec3_apply(zone, collect_node, &next);
+	} else {
+		return zone_contents_apply(zone, collect_node, &next);
+	}
+}
+
+/*! \brief Dumps one pass over the zone tree. */
+static int dump_pass(zone_contents_t *zone, bool nsec3, dump_params_t *params,
+                     zone_node_t **nodes, size_t count, dump_part_t *parts,
+                     dump_sync_t *sync, unsigned threads)
+{
+	if (threads > 1) {
+		return dump_nodes_parallel(nodes, count, params, parts, sync, threads);
+	} else if (nsec3) {
+		return zone_contents_nsec3_apply(zone, node_dump_text, params);
+	} else {
+		return zone_contents_apply(zone, node_dump_text, params);
+	}
+}
+
+static int dump_zone(zone_contents_t *zone, dump_params_t *params, bool comments,
+                     dump_part_t *parts, dump_sync_t *sync, unsigned threads)
+{
+	zone_node_t **nodes = NULL, **nsec3_nodes = NULL;
+	size_t count = 0, nsec3_count = 0;
+	if (threads > 1) {
+		int ret = collect_nodes(zone, false, &nodes, &count);
+		if (ret == KNOT_EOK) {
+			ret = collect_nodes(zone, true, &nsec3_nodes, &nsec3_count);
+		}
+		if (ret != KNOT_EOK) {
+			free(nodes);
+			free(nsec3_nodes);
+			return ret;
+		}
+	}
+
+	// Dump standard zone records without RRSIGS.
+	int ret = dump_pass(zone, false, params, nodes, count, parts, sync, threads);
+	if (ret != KNOT_EOK) {
+		goto finish;
+	}
+
+	// Dump RRSIG records if available.
+	params->dump_rrsig = true;
+	params->dump_nsec = false;
+	params->first_comment = comments ? ";; DNSSEC signatures\n" : NULL;
+	ret = dump_pass(zone, false, params, nodes, count, parts, sync, threads);
+	if (ret != KNOT_EOK) {
+		goto finish;
+	}
+
+	// Dump NSEC chain if available.
+	params->dump_rrsig = false;
+	params->dump_nsec = true;
+	params->first_comment = comments ? ";; DNSSEC NSEC chain\n" : NULL;
+	ret = dump_pass(zone, false, params, nodes, count, parts, sync, threads);
+	if (ret != KNOT_EOK) {
+		goto finish;
+	}
+
+	// Dump NSEC3 chain if available.
+	params->dump_rrsig = false;
+	params->dump_nsec = true;
+	params->first_comment = comments ? ";; DNSSEC NSEC3 chain\n" : NULL;
+	ret = dump_pass(zone, true, params, nsec3_nodes, nsec3_count, parts, sync, threads);
+	if (ret != KNOT_EOK) {
+		goto finish;
+	}
+
+	params->dump_rrsig = true;
+	params->dump_nsec = false;
+	params->first_comment = comments ? ";; DNSSEC NSEC3 signatures\n" : NULL;
+	ret = dump_pass(zone, true, params, nsec3_nodes, nsec3_count, parts, sync, threads);
+finish:
+	free(nodes);
+	free(nsec3_nodes);
+
+	return ret;
+}
+
+int zone_dump_text(zone_contents_t *zone, FILE *file, bool comments,
+                   unsigned threads)
 {
 	if (zone == NULL || file == NULL) {
 		return KNOT_EINVAL;
 	}
 
-	// Allocate auxiliary buffer for dumping operations.
+	// Don't use more threads than the parts of a round.
+	size_t count = MAX(zone_tree_count(zone->nodes), zone_tree_count(zone->nsec3_nodes));
+	threads = MIN(threads, (count + DUMP_PART_NODES - 1) / DUMP_PART_NODES);
+	if (threads == 0) {
+		threads = 1;
+	}
+
+	// Allocate auxiliary buffers for dumping operations.
 	char *buf = malloc(DUMP_BUF_LEN);
-	if (buf == NULL) {
+	char *out = malloc(DUMP_WRITE_LEN);
+	dump_part_t *parts = calloc(threads, sizeof(*parts));
+	if (buf == NULL || out == NULL || parts == NULL) {
+		free(buf);
+		free(out);
+		free(parts);
 		return KNOT_ENOMEM;
 	}
 
@@ -158,6 +474,8 @@ int zone_dump_text(zone_contents_t *zone, FILE *file, bool comments)
 		.file = file,
 		.buf = buf,
 		.buflen = DUMP_BUF_LEN,
+		.out = out,
+		.out_max = DUMP_WRITE_LEN,
 		.rr_count = 0,
 		.origin = apex->owner,
 		.style = &KNOT_DUMP_STYLE_DEFAULT,
@@ -165,48 +483,44 @@ int zone_dump_text(zone_contents_t *zone, FILE *file, bool comments)
 		.dump_nsec = false
 	};
 
-	// Dump standard zone records without RRSIGS.
-	int ret = zone_contents_apply(zone, node_dump_text, &params);
-	if (ret != KNOT_EOK) {
-		return ret;
+	int ret = KNOT_EOK;
+	for (unsigned i = 0; i < threads && threads > 1; i++) {
+		parts[i].params = params;
+		parts[i].params.file = NULL;
+		parts[i].params.buf = malloc(DUMP_BUF_LEN);
+		parts[i].params.out = NULL;
+		parts[i].params.out_max = 0;
+		if (parts[i].params.buf == NULL) {
+			ret = KNOT_ENOMEM;
+		}
 	}
 
-	// Dump RRSIG records if available.
-	params.dump_rrsig = true;
-	params.dump_nsec = false;
-	params.first_comment = comments ? ";; DNSSEC signatures\n" : NULL;
-	ret = zone_contents_apply(zone, node_dump_text, &params);
-	if (ret != KNOT_EOK) {
-		return ret;
+	// Start the workers once for all the passes over the zone.
+	dump_sync_t sync = { .round = 0 };
+	unsigned running = 1;
+	bool parallel = (ret == KNOT_EOK && threads > 1);
+	if (parallel) {
+		pthread_mutex_init(&sync.mx, NULL);
+		pthread_cond_init(&sync.start, NULL);
+		pthread_cond_init(&sync.done, NULL);
+		running = dump_workers_start(&sync, parts, threads);
 	}
 
-	// Dump NSEC chain if available.
-	params.dump_rrsig = false;
-	params.dump_nsec = true;
-	params.first_comment = comments ? ";; DNSSEC NSEC chain\n" : NULL;
-	ret = zone_contents_apply(zone, node_dump_text, &params);
-	if (ret != KNOT_EOK) {
-		return ret;
+	if (ret == KNOT_EOK) {
+		ret = dump_zone(zone, &params, comments, parts, &sync, running);
 	}
 
-	// Dump NSEC3 chain if available.
-	params.dump_rrsig = false;
-	params.dump_nsec = true;
-	params.first_comment = comments ? ";; DNSSEC NSEC3 chain\n" : NULL;
-	ret = zone_contents_nsec3_apply(zone, node_dump_text, &params);
-	if (ret != KNOT_EOK) {
-		return ret;
+	if (parallel) {
+		dump_workers_stop(&sync, parts, running);
+		pthread_cond_destroy(&sync.done);
+		pthread_cond_destroy(&sync.start);
+		pthread_mutex_destroy(&sync.mx);
 	}
-
-	params.dump_rrsig = true;
-	params.dump_nsec = false;
-	params.first_comment = comments ? ";; DNSSEC NSEC3 signatures\n" : NULL;
-	ret = zone_contents_nsec3_apply(zone, node_dump_text, &params);
-	if (ret != KNOT_EOK) {
-		return ret;
+	if (ret == KNOT_EOK) {
+		ret = flush_out(&params);
 	}
 
-	if (comments) {
+	if (comments && ret == KNOT_EOK) {
 		// Create formatted date-time string.
 		time_t now = time(NULL);
 		struct tm tm;
@@ -220,7 +534,13 @@ int zone_dump_text(zone_contents_t *zone, FILE *file, bool comments)
 	        	params.rr_count, date);
 	}
 
+	for (unsigned i = 0; i < threads && threads > 1; i++) {
+		free(parts[i].params.buf); // may be reallocated by knot_rrset_txt_dump()
+		free(parts[i].params.out);
+	}
+	free(parts);
+	free(params.out);
 	free(params.buf); // params.buf may be != buf because of knot_rrset_txt_dump_dynamic()
 
-	return KNOT_EOK;
+	return ret;
 }
@@ -98,7 +98,7 @@ static int flush_journal(conf_t *conf, zone_t *zone, bool allow_empty_zone)
 	char *zonefile = conf_zonefile(conf, zone->name);
 
 	/* Synchronize journal. */
-	ret = zonefile_write(zonefile, contents);
+	ret = zonefile_write(zonefile, contents, conf_bg_threads(conf));
 	if (ret != KNOT_EOK) {
 		log_zone_warning(zone->name, "failed to update zone file (%s)",
 		                 knot_strerror(ret));
@@ -226,6 +226,8 @@ void zone_free(zone_t **zone_ptr)
 
 	conf_deactivate_modules(&zone->query_modules, &zone->query_plan);
 
+	zone_conf_cache_free(zone->conf_cache);
+
 	free(zone);
 	*zone_ptr = NULL;
 }
@@ -300,6 +302,53 @@ zone_contents_t *zone_switch_contents(zone_t *zone, zone_contents_t *new_content
 	return old_contents;
 }
 
+zone_conf_cache_t *zone_conf_cache_new(conf_t *conf, const knot_dname_t *zone_name)
+{
+	if (conf == NULL || zone_name == NULL) {
+		return NULL;
+	}
+
+	zone_conf_cache_t *cache = malloc(sizeof(*cache));
+	if (cache == NULL) {
+		return NULL;
+	}
+
+	conf_val_t val = conf_zone_get(conf, C_DISABLE_ANY, zone_name);
+	cache->disable_any = conf_bool(&val);
+
+	val = conf_zone_get(conf, C_DNSSEC_SIGNING, zone_name);
+	cache->dnssec_signing = conf_bool(&val);
+
+	val = conf_zone_get(conf, C_ACL, zone_name);
+	cache->acl = acl_rules_new(conf, &val);
+	if (cache->acl == NULL) {
+		free(cache);
+		return NULL;
+	}
+
+	return cache;
+}
+
+void zone_conf_cache_free(zone_conf_cache_t *cache)
+{
+	if (cache == NULL) {
+		return;
+	}
+
+	acl_rules_free(cache->acl);
+	free(cache);
+}
+
+zone_conf_cache_t *zone_switch_conf_cache(zone_t *zone, zone_conf_cache_t *new_cache)
+{
+	if (zone == NULL) {
+		return NULL;
+	}
+
+	zone_conf_cache_t **current_cache = &zone->conf_cache;
+	return rcu_xchg_pointer(current_cache, new_cache);
+}
+
 bool zone_is_slave(conf_t *conf, const zone_t *zone)
 {
 	if (conf == NULL || zone == NULL) {
@@ -489,7 +538,7 @@ int zone_dump_to_dir(conf_t *conf, zone_t *zone, const char *dir)
 	}
 	free(zonefile);
 
-	return zonefile_write(target, zone->contents);
+	return zonefile_write(target, zone->contents, conf_bg_threads(conf));
 }
 
 int zone_set_master_serial(zone_t *zone, uint32_t serial)
@@ -20,6 +20,7 @@
 #include "knot/conf/conf.h"
 #include "knot/conf/confio.h"
 #include "knot/journal/journal_basic.h"
+#include "knot/updates/acl.h"
 #include "knot/events/events.h"
 #include "knot/updates/changesets.h"
 #include "knot/zone/contents.h"
@@ -40,6 +41,20 @@ typedef enum zone_flag_t {
 	ZONE_FORCE_ZSK_ROLL = 1 << 4, /*!< Force ZSK rollover. */
 } zone_flag_t;
 
+/*!
+ * \brief Cached critical confdb zone items.
+ *
+ * The cache is compiled when the zone is created and rebuilt whenever a zone
+ * database update or a configuration commit changes the zone configuration.
+ *
+ * \note The structure is immutable, it's replaced as a whole under RCU.
+ */
+typedef struct zone_conf_cache {
+	bool disable_any;    /*!< Disable ANY query processing. */
+	bool dnssec_signing; /*!< Automatic DNSSEC signing enabled. */
+	acl_rules_t *acl;    /*!< Parsed zone ACL rules. */
+} zone_conf_cache_t;
+
 /*!
  * \brief Structure for holding DNS zone.
  */
@@ -52,6 +67,9 @@ typedef struct zone
 	/*! \brief Dynamic configuration zone change type. */
 	conf_io_type_t change_type;
 
+	/*! \brief Cached critical confdb items. */
+	zone_conf_cache_t *conf_cache;
+
 	/*! \brief Zonefile parameters. */
 	struct {
 		struct timespec mtime;
@@ -135,6 +153,28 @@ int zone_flush_journal(conf_t *conf, zone_t *zone);
  */
 zone_contents_t *zone_switch_contents(zone_t *zone, zone_contents_t *new_contents);
 
+/*!
+ * \brief Compiles cached critical confdb items of the zone.
+ *
+ * \param conf       Configuration.
+ * \param zone_name  Zone name.
+ *
+ * \return New cache or NULL if an error occurred.
+ */
+zone_conf_cache_t *zone_conf_cache_new(conf_t *conf, const knot_dname_t *zone_name);
+
+/*!
+ * \brief Frees cached confdb items of the zone.
+ *
+ * \param cache  Cache to be freed.
+ */
+void zone_conf_cache_free(zone_conf_cache_t *cache);
+
+/*!
+ * \brief Atomically switch the cached confdb items of the zone.
+ */
+zone_conf_cache_t *zone_switch_conf_cache(zone_t *zone, zone_conf_cache_t *new_cache);
+
 /*! \brief Checks if the zone is slave. */
 bool zone_is_slave(conf_t *conf, const zone_t *zone);
 
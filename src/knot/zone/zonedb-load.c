@@ -20,6 +20,7 @@
 #include "knot/common/log.h"
 #include "knot/conf/module.h"
 #include "knot/events/replan.h"
+#include "knot/nameserver/query_module.h"
 #include "knot/zone/timers.h"
 #include "knot/zone/zone-load.h"
 #include "knot/zone/zone.h"
@@ -27,6 +28,8 @@
 #include "knot/zone/zonedb.h"
 #include "knot/zone/zonefile.h"
 #include "libknot/libknot.h"
+#include "contrib/macros.h"
+#include "contrib/time.h"
 
 static bool zone_file_updated(conf_t *conf, const zone_t *old_zone,
                               const knot_dname_t *zone_name)
@@ -210,59 +213,244 @@ static void mark_changed_zones(knot_zonedb_t *zonedb, trie_t *changed)
 }
 
 /*!
- * \brief Create new zone database.
- *
- * Zones that should be retained are just added from the old database to the
- * new. New zones are loaded.
+ * \brief Check if cached confdb items of all zones must be refreshed.
+ */
+static bool all_zones_changed(conf_t *conf)
+{
+	return !(conf->io.flags & CONF_IO_FACTIVE) ||
+	       (conf->io.flags & (CONF_IO_FDIFF_ZONES | CONF_IO_FCHECK_ZONES));
+}
+
+/*!
+ * \brief Refresh cached confdb items of a reused zone.
  *
- * \param conf    New server configuration.
- * \param server  Server instance.
+ * \param conf        New server configuration.
+ * \param zone        Reused zone.
+ * \param old_caches  List of replaced caches to be freed after RCU sync.
  *
- * \return New zone database.
+ * \return KNOT_E* (the zone keeps the old cache if failed).
  */
-static knot_zonedb_t *create_zonedb(conf_t *conf, server_t *server)
+static int refresh_conf_cache(conf_t *conf, zone_t *zone, list_t *old_caches)
 {
-	assert(conf);
-	assert(server);
+	if (!(zone->change_type & CONF_IO_TCHANGE) && !all_zones_changed(conf)) {
+		return KNOT_EOK;
+	}
 
-	knot_zonedb_t *db_old = server->zone_db;
-	knot_zonedb_t *db_new = knot_zonedb_new();
-	if (!db_new) {
-		return NULL;
+	zone_conf_cache_t *cache = zone_conf_cache_new(conf, zone->name);
+	if (cache == NULL) {
+		log_zone_error(zone->name, "failed to refresh configuration cache");
+		return KNOT_ENOMEM;
 	}
 
-	bool full = !(conf->io.flags & CONF_IO_FACTIVE) ||
-	            (conf->io.flags & CONF_IO_FRLD_ZONES);
+	zone_conf_cache_t *old = zone_switch_conf_cache(zone, cache);
+	ptrlist_add(old_caches, old, NULL);
 
-	/* Mark changed zones. */
-	if (!full) {
-		mark_changed_zones(server->zone_db, conf->io.zones);
+	return KNOT_EOK;
+}
+
+/*!
+ * \brief Free the replaced zone confdb caches.
+ */
+static void free_old_caches(list_t *old_caches)
+{
+	ptrnode_t *n;
+	WALK_LIST(n, *old_caches) {
+		zone_conf_cache_free(n->d);
+	}
+	ptrlist_free(old_caches, NULL);
+}
+
+/*!
+ * \brief Create a zone and insert it into the new zone database.
+ */
+static void insert_new_zone(conf_t *conf, const knot_dname_t *name,
+                            server_t *server, zone_t *old_zone,
+                            knot_zonedb_t *db_new)
+{
+	zone_t *zone = create_zone(conf, name, server, old_zone);
+	if (zone == NULL) {
+		log_zone_error(name, "zone cannot be created");
+		return;
+	}
+
+	zone->conf_cache = zone_conf_cache_new(conf, zone->name);
+	if (zone->conf_cache == NULL) {
+		log_zone_error(name, "zone cannot be created");
+		zone_free(&zone);
+		return;
+	}
+
+	conf_activate_modules(conf, zone->name, &zone->query_modules,
+	                      &zone->query_plan);
+
+	knotd_mod_t *mod;
+	WALK_LIST(mod, zone->query_modules) {
+		mod->conf_cache = &zone->conf_cache;
 	}
 
+	knot_zonedb_insert(db_new, zone);
+}
+
+/*!
+ * \brief Create new zone database from all configured zones.
+ */
+static void create_zonedb_full(conf_t *conf, server_t *server,
+                               knot_zonedb_t *db_new)
+{
+	knot_zonedb_t *db_old = server->zone_db;
+	size_t configured = 0;
+
 	for (conf_iter_t iter = conf_iter(conf, C_ZONE); iter.code == KNOT_EOK;
 	     conf_iter_next(conf, &iter)) {
 		conf_val_t id = conf_iter_id(conf, &iter);
 		const knot_dname_t *name = conf_dname(&id);
 
 		zone_t *old_zone = knot_zonedb_find(db_old, name);
-		if (old_zone != NULL && !full) {
-			/* Reuse unchanged zone. */
-			if (!(old_zone->change_type & CONF_IO_TRELOAD)) {
-				knot_zonedb_insert(db_new, old_zone);
-				continue;
-			}
+
+		insert_new_zone(conf, name, server, old_zone, db_new);
+		configured++;
+	}
+
+	server->zone_db_missing = configured - knot_zonedb_size(db_new);
+}
+
+/*!
+ * \brief Create the zones added or reloaded by the configuration transaction.
+ *
+ * \return Number of configured zones added minus the number of zones removed.
+ */
+static ssize_t create_changed_zones(conf_t *conf, server_t *server,
+                                    knot_zonedb_t *db_new)
+{
+	knot_zonedb_t *db_old = server->zone_db;
+	ssize_t delta = 0;
+
+	trie_it_t *zit = trie_it_begin(conf->io.zones);
+	for (; !trie_it_finished(zit); trie_it_next(zit)) {
+		size_t name_len;
+		const knot_dname_t *name =
+			(const knot_dname_t *)trie_it_key(zit, &name_len);
+		zone_t *old_zone = knot_zonedb_find(db_old, name);
+		bool configured = conf_rawid_exists(conf, C_ZONE, name, name_len);
+		if (configured && old_zone == NULL) {
+			delta++;
+		} else if (!configured && old_zone != NULL) {
+			delta--;
 		}
 
-		zone_t *zone = create_zone(conf, name, server, old_zone);
-		if (zone == NULL) {
-			log_zone_error(name, "zone cannot be created");
+		conf_io_type_t type = (conf_io_type_t)(*trie_it_val(zit));
+		if ((type & CONF_IO_TUNSET) || !configured) {
 			continue;
 		}
 
-		conf_activate_modules(conf, zone->name, &zone->query_modules,
-		                      &zone->query_plan);
+		if (old_zone != NULL && !(old_zone->change_type & CONF_IO_TRELOAD)) {
+			continue;
+		}
+
+		/* Already recreated due to a failed cache refresh. */
+		if (knot_zonedb_find(db_new, name) != NULL) {
+			continue;
+		}
+
+		insert_new_zone(conf, name, server, old_zone, db_new);
+	}
+	trie_it_free(zit);
+
+	return delta;
+}
+
+/*!
+ * \brief Create new zone database from the old one and the changed zones.
+ *
+ * Only zones affected by the configuration transaction are created, so the
+ * update doesn't depend on the number of configured zones in confdb. The
+ * expected number of zones is derived from the old database, the zones which
+ * were missing in it, and the change set. Just if some configured zone is
+ * still missing (e.g. it failed to be created before), the zone section is
+ * walked to create it.
+ */
+static void create_zonedb_incremental(conf_t *conf, server_t *server,
+                                      knot_zonedb_t *db_new, list_t *old_caches)
+{
+	knot_zonedb_t *db_old = server->zone_db;
+
+	/* Mark changed zones. */
+	mark_changed_zones(db_old, conf->io.zones);
+
+	/* Reuse unchanged zones. */
+	knot_zonedb_iter_t *it = knot_zonedb_iter_begin(db_old);
+	while (!knot_zonedb_iter_finished(it)) {
+		zone_t *zone = knot_zonedb_iter_val(it);
+		if (!(zone->change_type & (CONF_IO_TRELOAD | CONF_IO_TUNSET))) {
+			if (refresh_conf_cache(conf, zone, old_caches) == KNOT_EOK) {
+				knot_zonedb_insert(db_new, zone);
+			} else {
+				/* Don't serve a stale cache, reload the zone instead. */
+				zone->change_type |= CONF_IO_TRELOAD;
+				insert_new_zone(conf, zone->name, server, zone, db_new);
+			}
+		}
+		knot_zonedb_iter_next(it);
+	}
+	knot_zonedb_iter_free(it);
+
+	/* Create added or reloaded zones. */
+	ssize_t expected = knot_zonedb_size(db_old) + server->zone_db_missing;
+	if (conf->io.zones != NULL) {
+		expected += create_changed_zones(conf, server, db_new);
+	}
+
+	/* Retry configured zones missing in the database (e.g. failed before). */
+	if ((ssize_t)knot_zonedb_size(db_new) < expected) {
+		size_t configured = 0;
+		for (conf_iter_t iter = conf_iter(conf, C_ZONE); iter.code == KNOT_EOK;
+		     conf_iter_next(conf, &iter)) {
+			conf_val_t id = conf_iter_id(conf, &iter);
+			const knot_dname_t *name = conf_dname(&id);
+			if (knot_zonedb_find(db_new, name) == NULL) {
+				zone_t *old_zone = knot_zonedb_find(db_old, name);
+				insert_new_zone(conf, name, server, old_zone, db_new);
+			}
+			configured++;
+		}
+		expected = configured;
+	}
+
+	expected -= knot_zonedb_size(db_new);
+	server->zone_db_missing = MAX(expected, 0);
+}
+
+/*!
+ * \brief Create new zone database.
+ *
+ * Zones that should be retained are just added from the old database to the
+ * new. New zones are loaded.
+ *
+ * \param conf        New server configuration.
+ * \param server      Server instance.
+ * \param old_caches  List of replaced zone confdb caches.
+ *
+ * \return New zone database.
+ */
+static knot_zonedb_t *create_zonedb(conf_t *conf, server_t *server,
+                                    list_t *old_caches)
+{
+	assert(conf);
+	assert(server);
+
+	knot_zonedb_t *db_new = knot_zonedb_new();
+	if (!db_new) {
+		return NULL;
+	}
+
+	bool full = !(conf->io.flags & CONF_IO_FACTIVE) ||
+	            (conf->io.flags & CONF_IO_FRLD_ZONES) ||
+	            server->zone_db == NULL;
 
-		knot_zonedb_insert(db_new, zone);
+	if (full) {
+		create_zonedb_full(conf, server, db_new);
+	} else {
+		create_zonedb_incremental(conf, server, db_new, old_caches);
 	}
 
 	return db_new;
@@ -307,8 +495,10 @@ static void remove_old_zonedb(conf_t *conf, knot_zonedb_t *db_old,
 			/* Check if removed (drop also contents). */
 			} else if (zone->change_type & CONF_IO_TUNSET) {
 				zone_free(&zone);
-			}
 			/* Completely reused zone. */
+			} else {
+				zone->change_type = CONF_IO_TNONE;
+			}
 		}
 
 		knot_zonedb_iter_next(it);
@@ -329,10 +519,17 @@ void zonedb_reload(conf_t *conf, server_t *server)
 		return;
 	}
 
+	struct timespec t_begin = time_now();
+
+	list_t old_caches;
+	init_list(&old_caches);
+
 	/* Insert all required zones to the new zone DB. */
-	knot_zonedb_t *db_new = create_zonedb(conf, server);
+	knot_zonedb_t *db_new = create_zonedb(conf, server, &old_caches);
 	if (db_new == NULL) {
 		log_error("failed to create new zone database");
+		synchronize_rcu();
+		free_old_caches(&old_caches);
 		return;
 	}
 
@@ -343,6 +540,61 @@ void zonedb_reload(conf_t *conf, server_t *server)
 	/* Wait for readers to finish reading old zone database. */
 	synchronize_rcu();
 
+	/* Remove replaced zone configuration caches. */
+	free_old_caches(&old_caches);
+
 	/* Remove old zone DB. */
 	remove_old_zonedb(conf, db_old, db_new);
+
+	struct timespec t_end = time_now();
+	log_debug("zone database updated, %zu zones, %.02f seconds",
+	          knot_zonedb_size(db_new), time_diff_ms(&t_begin, &t_end) / 1000.0);
+}
+
+int zonedb_reconfigure(conf_t *conf, server_t *server)
+{
+	if (conf == NULL || server == NULL || server->zone_db == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	list_t old_caches;
+	init_list(&old_caches);
+
+	int ret = KNOT_EOK;
+	if (all_zones_changed(conf)) {
+		knot_zonedb_iter_t *it = knot_zonedb_iter_begin(server->zone_db);
+		while (!knot_zonedb_iter_finished(it)) {
+			zone_t *zone = knot_zonedb_iter_val(it);
+			if (refresh_conf_cache(conf, zone, &old_caches) != KNOT_EOK) {
+				ret = KNOT_ENOMEM;
+			}
+			knot_zonedb_iter_next(it);
+		}
+		knot_zonedb_iter_free(it);
+	} else if (conf->io.zones != NULL) {
+		mark_changed_zones(server->zone_db, conf->io.zones);
+
+		trie_it_t *it = trie_it_begin(conf->io.zones);
+		for (; !trie_it_finished(it); trie_it_next(it)) {
+			const knot_dname_t *name =
+				(const knot_dname_t *)trie_it_key(it, NULL);
+			zone_t *zone = knot_zonedb_find(server->zone_db, name);
+			if (zone == NULL) {
+				continue;
+			}
+			if (refresh_conf_cache(conf, zone, &old_caches) != KNOT_EOK) {
+				ret = KNOT_ENOMEM;
+			} else {
+				zone->change_type = CONF_IO_TNONE;
+			}
+		}
+		trie_it_free(it);
+	}
+
+	/* Wait for readers to finish reading old caches. */
+	synchronize_rcu();
+
+	free_old_caches(&old_caches);
+
+	return ret;
 }
@@ -26,3 +26,16 @@
  * \param[in] server Server instance.
  */
 void zonedb_reload(conf_t *conf, server_t *server);
+
+/*!
+ * \brief Refresh cached configuration of zones without zone database reload.
+ *
+ * If a zone cache can't be refreshed, the zone keeps the old one and the
+ * zone database must be reloaded to reflect the configuration change.
+ *
+ * \param[in] conf Configuration.
+ * \param[in] server Server instance.
+ *
+ * \return KNOT_E*
+ */
+int zonedb_reconfigure(conf_t *conf, server_t *server);
@@ -27,6 +27,7 @@
 
 #include "libknot/libknot.h"
 #include "contrib/files.h"
+#include "contrib/macros.h"
 #include "knot/common/log.h"
 #include "knot/dnssec/zone-nsec.h"
 #include "knot/zone/semantic-check.h"
@@ -186,6 +187,7 @@ int zonefile_open(zloader_t *loader, const char *source,
 	loader->creator = zc;
 	loader->semantic_checks = semantic_checks;
 	loader->time = time;
+	loader->threads = 1;
 
 	return KNOT_EOK;
 }
@@ -234,7 +236,8 @@ zone_contents_t *zonefile_load(zloader_t *loader)
 	}
 
 	ret = sem_checks_process(zc->z, loader->semantic_checks,
-	                         loader->err_handler, loader->time);
+	                         loader->err_handler, loader->time,
+	                         loader->threads);
 
 	if (ret != KNOT_EOK) {
 		ERROR(zname, "failed to load zone, file '%s' (%s)",
@@ -276,7 +279,18 @@ int zonefile_exists(const char *path, struct timespec *mtime)
 	return KNOT_EOK;
 }
 
-int zonefile_write(const char *path, zone_contents_t *zone)
+#ifdef HAVE_ATOMIC
+ #define ATOMIC_ADD(dst, val) __atomic_add_fetch(&(dst), (val), __ATOMIC_RELAXED)
+ #define ATOMIC_SUB(dst, val) __atomic_sub_fetch(&(dst), (val), __ATOMIC_RELAXED)
+#else
+ #define ATOMIC_ADD(dst, val) ((dst) += (val))
+ #define ATOMIC_SUB(dst, val) ((dst) -= (val))
+#endif
+
+/*! \brief Number of zone files being written concurrently. */
+static unsigned writes_running = 0;
+
+int zonefile_write(const char *path, zone_contents_t *zone, unsigned threads)
 {
 	if (!zone || !path) {
 		return KNOT_EINVAL;
@@ -294,7 +308,13 @@ int zonefile_write(const char *path, zone_contents_t *zone)
 		return ret;
 	}
 
-	ret = zone_dump_text(zone, file, true);
+	// Share the threads among the concurrent writes (inaccurate without atomics).
+	unsigned running = ATOMIC_ADD(writes_running, 1);
+	running = MAX(running, 1);
+	threads = MAX(threads / running, 1);
+
+	ret = zone_dump_text(zone, file, true, threads);
+	ATOMIC_SUB(writes_running, 1);
 	fclose(file);
 	if (ret != KNOT_EOK) {
 		unlink(tmp_name);
@@ -41,6 +41,7 @@ typedef struct {
 	zcreator_t *creator;         /*!< Loader context. */
 	zs_scanner_t scanner;        /*!< Zone scanner. */
 	time_t time;                 /*!< time for zone check. */
+	unsigned threads;            /*!< Number of threads for zone check. */
 } zloader_t;
 
 void err_handler_logger(sem_handler_t *handler, const zone_contents_t *zone,
@@ -83,8 +84,16 @@ int zonefile_exists(const char *path, struct timespec *mtime);
 
 /*!
  * \brief Write zone contents to zone file.
+ *
+ * The threads are shared among the concurrently written zone files.
+ *
+ * \param path     Zone file path.
+ * \param zone     Zone contents.
+ * \param threads  Number of threads formatting the zone.
+ *
+ * \return KNOT_E*
  */
-int zonefile_write(const char *path, zone_contents_t *zone);
+int zonefile_write(const char *path, zone_contents_t *zone, unsigned threads);
 
 /*!
  * \brief Close zone file loader.
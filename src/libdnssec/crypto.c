@@ -18,6 +18,7 @@
 #include <gnutls/pkcs11.h>
 
 #include "libdnssec/crypto.h"
+#include "libdnssec/keystore/internal.h"
 #include "libdnssec/p11/p11.h"
 #include "libdnssec/shared/shared.h"
 
@@ -31,6 +32,7 @@ void dnssec_crypto_init(void)
 _public_
 void dnssec_crypto_cleanup(void)
 {
+	pkcs8_cache_cleanup();
 	gnutls_global_deinit();
 	p11_cleanup();
 }
@@ -47,3 +47,8 @@ struct dnssec_keystore {
 
 int keystore_create(dnssec_keystore_t **store_ptr,
 		    const keystore_functions_t *functions);
+
+/*!
+ * Free the process-wide cache of decoded PKCS #8 private keys.
+ */
+void pkcs8_cache_cleanup(void);
@@ -16,6 +16,7 @@
 
 #include <assert.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -23,6 +24,8 @@
 #include <sys/types.h>
 
 #include "contrib/files.h"
+#include "contrib/qp-trie/trie.h"
+#include "contrib/time.h"
 #include "libdnssec/binary.h"
 #include "libdnssec/error.h"
 #include "libdnssec/keystore.h"
@@ -218,6 +221,159 @@ static int pem_generate(gnutls_pk_algorithm_t algorithm, unsigned bits,
 	return DNSSEC_EOK;
 }
 
+/* -- decoded key cache ---------------------------------------------------- */
+
+/*!
+ * Decoded private key shared by all PKCS #8 keystores in the process.
+ *
+ * The entry is valid as long as the key file is the same, which is checked
+ * with the file metadata on each access.
+ */
+typedef struct {
+	gnutls_x509_privkey_t key;
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+} cached_key_t;
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static trie_t *cache = NULL;
+
+static bool cached_key_valid(const cached_key_t *entry, const struct stat *st)
+{
+	return entry->dev == st->st_dev && entry->ino == st->st_ino &&
+	       entry->size == st->st_size &&
+	       entry->mtime.tv_sec == st->st_mtim.tv_sec &&
+	       entry->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+static void cached_key_free(cached_key_t *entry)
+{
+	if (entry) {
+		gnutls_x509_privkey_deinit(entry->key);
+		free(entry);
+	}
+}
+
+static int cached_key_free_cb(trie_val_t *val, void *ctx)
+{
+	cached_key_free(*val);
+	return 0;
+}
+
+/*!
+ * Create a private key from a copy of the cached decoded key.
+ */
+static int privkey_from_x509(gnutls_x509_privkey_t x509, gnutls_privkey_t *key_ptr)
+{
+	_cleanup_x509_privkey_ gnutls_x509_privkey_t copy = NULL;
+	if (gnutls_x509_privkey_init(&copy) != GNUTLS_E_SUCCESS) {
+		return DNSSEC_ENOMEM;
+	}
+	if (gnutls_x509_privkey_cpy(copy, x509) != GNUTLS_E_SUCCESS) {
+		return DNSSEC_ENOMEM;
+	}
+
+	gnutls_privkey_t key = NULL;
+	if (gnutls_privkey_init(&key) != GNUTLS_E_SUCCESS) {
+		return DNSSEC_ENOMEM;
+	}
+
+	int flags = GNUTLS_PRIVKEY_IMPORT_AUTO_RELEASE;
+	if (gnutls_privkey_import_x509(key, copy, flags) != GNUTLS_E_SUCCESS) {
+		gnutls_privkey_deinit(key);
+		return DNSSEC_ENOMEM;
+	}
+	copy = NULL; // owned by the private key
+
+	*key_ptr = key;
+
+	return DNSSEC_EOK;
+}
+
+/*!
+ * Get the private key from the cache if the key file didn't change.
+ */
+static int cache_get(const char *path, const struct stat *st, gnutls_privkey_t *key_ptr)
+{
+	int r = DNSSEC_ENOENT;
+
+	pthread_mutex_lock(&cache_lock);
+	trie_val_t *val = (cache != NULL) ?
+	                  trie_get_try(cache, (uint8_t *)path, strlen(path)) : NULL;
+	if (val != NULL && cached_key_valid(*val, st)) {
+		cached_key_t *entry = *val;
+		r = privkey_from_x509(entry->key, key_ptr);
+	}
+	pthread_mutex_unlock(&cache_lock);
+
+	return r;
+}
+
+/*!
+ * Store the decoded key in the cache, replacing an outdated entry.
+ */
+static void cache_put(const char *path, const struct stat *st, gnutls_x509_privkey_t x509)
+{
+	cached_key_t *entry = calloc(1, sizeof(*entry));
+	if (entry == NULL) {
+		return;
+	}
+	if (gnutls_x509_privkey_init(&entry->key) != GNUTLS_E_SUCCESS) {
+		free(entry);
+		return;
+	}
+	if (gnutls_x509_privkey_cpy(entry->key, x509) != GNUTLS_E_SUCCESS) {
+		cached_key_free(entry);
+		return;
+	}
+	entry->dev = st->st_dev;
+	entry->ino = st->st_ino;
+	entry->size = st->st_size;
+	entry->mtime = st->st_mtim;
+
+	pthread_mutex_lock(&cache_lock);
+	if (cache == NULL) {
+		cache = trie_create(NULL);
+	}
+	trie_val_t *val = (cache != NULL) ?
+	                  trie_get_ins(cache, (uint8_t *)path, strlen(path)) : NULL;
+	if (val != NULL) {
+		cached_key_free(*val);
+		*val = entry;
+	} else {
+		cached_key_free(entry);
+	}
+	pthread_mutex_unlock(&cache_lock);
+}
+
+/*!
+ * Drop the cached key of a removed key file.
+ */
+static void cache_del(const char *path)
+{
+	pthread_mutex_lock(&cache_lock);
+	trie_val_t *val = (cache != NULL) ?
+	                  trie_get_try(cache, (uint8_t *)path, strlen(path)) : NULL;
+	if (val != NULL) {
+		cached_key_free(*val);
+		trie_del(cache, (uint8_t *)path, strlen(path), NULL);
+	}
+	pthread_mutex_unlock(&cache_lock);
+}
+
+void pkcs8_cache_cleanup(void)
+{
+	pthread_mutex_lock(&cache_lock);
+	if (cache != NULL) {
+		trie_apply(cache, cached_key_free_cb, NULL);
+		trie_free(cache);
+		cache = NULL;
+	}
+	pthread_mutex_unlock(&cache_lock);
+}
+
 /* -- internal API --------------------------------------------------------- */
 
 static int pkcs8_ctx_new(void **ctx_ptr)
@@ -395,6 +551,8 @@ static int pkcs8_remove_key(void *ctx, const char *id)
 		return dnssec_errno_to_error(errno);
 	}
 
+	cache_del(filename);
+
 	return DNSSEC_EOK;
 }
 
@@ -406,53 +564,63 @@ static int pkcs8_get_private(void *ctx, const char *id, gnutls_privkey_t *key_pt
 
 	pkcs8_dir_handle_t *handle = ctx;
 
-	// load private key data
+	_cleanup_free_ char *filename = key_path(handle->dir_name, id);
+	if (!filename) {
+		return DNSSEC_ENOMEM;
+	}
+
+	// open the key file, its metadata validate the cached key
 
-	_cleanup_close_ int file = 0;
-	int r = key_open_read(handle->dir_name, id, &file);
-	if (r != DNSSEC_EOK) {
-		return r;
+	_cleanup_close_ int file = open(filename, O_RDONLY);
+	if (file == -1) {
+		int error = errno;
+		if (error == ENOENT) {
+			// don't keep the private key of a removed file in memory
+			cache_del(filename);
+		}
+		return dnssec_errno_to_error(error);
 	}
 
-	size_t size = 0;
-	r = file_size(file, &size);
-	if (r != DNSSEC_EOK) {
+	struct stat st = { 0 };
+	if (fstat(file, &st) == -1) {
+		return dnssec_errno_to_error(errno);
+	}
+
+	int r = cache_get(filename, &st, key_ptr);
+	if (r != DNSSEC_ENOENT) {
 		return r;
 	}
 
-	if (size == 0) {
+	if (st.st_size == 0) {
 		return DNSSEC_MALFORMED_DATA;
 	}
 
 	// read the stored data
 
 	_cleanup_binary_ dnssec_binary_t pem = { 0 };
-	r = dnssec_binary_alloc(&pem, size);
+	r = dnssec_binary_alloc(&pem, st.st_size);
 	if (r != DNSSEC_EOK) {
 		return r;
 	}
 
 	ssize_t read_count = read(file, pem.data, pem.size);
 	if (read_count == -1) {
-		dnssec_binary_free(&pem);
 		return dnssec_errno_to_error(errno);
+	} else if (read_count != pem.size) {
+		return DNSSEC_MALFORMED_DATA;
 	}
 
-	assert(read_count == pem.size);
-
-	// construct the key
+	// decode the key and keep it for the next use
 
-	gnutls_privkey_t key = NULL;
-	r = dnssec_pem_to_privkey(&pem, &key);
+	_cleanup_x509_privkey_ gnutls_x509_privkey_t x509 = NULL;
+	r = dnssec_pem_to_x509(&pem, &x509);
 	if (r != DNSSEC_EOK) {
 		return r;
 	}
 
-	// finish
+	cache_put(filename, &st, x509);
 
-	*key_ptr = key;
-
-	return DNSSEC_EOK;
+	return privkey_from_x509(x509, key_ptr);
 }
 
 /* -- public API ----------------------------------------------------------- */
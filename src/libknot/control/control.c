@@ -39,6 +39,9 @@
 /*! Default socket operations timeout in milliseconds. */
 #define DEFAULT_TIMEOUT		(5 * 1000)
 
+/*! Maximum number of pending connections on the bound socket. */
+#define LISTEN_BACKLOG		16
+
 /*! The first data item code. */
 #define DATA_CODE_OFFSET	16
 
@@ -55,6 +58,8 @@ struct knot_ctl {
 
 	/*! The latter read data. */
 	knot_ctl_data_t data;
+	/*! The latter read data lengths. */
+	uint16_t data_len[KNOT_CTL_IDX__COUNT];
 
 	/*! Write wire context. */
 	wire_ctx_t wire_out;
@@ -129,6 +134,7 @@ static void clean_data(knot_ctl_t *ctx)
 {
 	mp_flush(ctx->mm.ctx);
 	memzero(ctx->data, sizeof(ctx->data));
+	memzero(ctx->data_len, sizeof(ctx->data_len));
 }
 
 static void close_sock(int *sock)
@@ -208,7 +214,7 @@ int knot_ctl_bind(knot_ctl_t *ctx, const char *path)
 	}
 
 	// Start listening.
-	if (listen(ctx->listen_sock, 1) != 0) {
+	if (listen(ctx->listen_sock, LISTEN_BACKLOG) != 0) {
 		close_sock(&ctx->listen_sock);
 		return knot_map_errno();
 	}
@@ -240,11 +246,17 @@ void knot_ctl_unbind(knot_ctl_t *ctx)
 _public_
 int knot_ctl_accept(knot_ctl_t *ctx)
 {
-	if (ctx == NULL) {
+	return knot_ctl_accept_to(ctx, ctx);
+}
+
+_public_
+int knot_ctl_accept_to(knot_ctl_t *ctx, knot_ctl_t *client_ctx)
+{
+	if (ctx == NULL || client_ctx == NULL) {
 		return KNOT_EINVAL;
 	}
 
-	knot_ctl_close(ctx);
+	knot_ctl_close(client_ctx);
 
 	// Control interface.
 	struct pollfd pfd = { .fd = ctx->listen_sock, .events = POLLIN };
@@ -258,9 +270,9 @@ int knot_ctl_accept(knot_ctl_t *ctx)
 		return client;
 	}
 
-	ctx->sock = client;
+	client_ctx->sock = client;
 
-	reset_buffers(ctx);
+	reset_buffers(client_ctx);
 
 	return KNOT_EOK;
 }
@@ -322,7 +334,8 @@ static int ensure_output(knot_ctl_t *ctx, uint16_t len)
 	return KNOT_EOK;
 }
 
-static int send_item(knot_ctl_t *ctx, uint8_t code, const char *data, bool flush)
+static int send_item(knot_ctl_t *ctx, uint8_t code, const char *data,
+                     size_t data_len, bool flush)
 {
 	wire_ctx_t *w = &ctx->wire_out;
 
@@ -338,8 +351,7 @@ static int send_item(knot_ctl_t *ctx, uint8_t code, const char *data, bool flush
 
 	// Control block data is optional.
 	if (data != NULL) {
-		// Get the data length.
-		size_t data_len = strlen(data);
+		// Check the data length.
 		if (data_len > UINT16_MAX) {
 			return KNOT_ERANGE;
 		}
@@ -379,13 +391,9 @@ static int send_item(knot_ctl_t *ctx, uint8_t code, const char *data, bool flush
 	return KNOT_EOK;
 }
 
-_public_
-int knot_ctl_send(knot_ctl_t *ctx, knot_ctl_type_t type, knot_ctl_data_t *data)
+static int send_unit(knot_ctl_t *ctx, knot_ctl_type_t type, knot_ctl_data_t *data,
+                     knot_ctl_idx_t bin_idx, size_t bin_len)
 {
-	if (ctx == NULL) {
-		return KNOT_EINVAL;
-	}
-
 	// Get the type code.
 	int code = type_to_code(type);
 	if (code == -1) {
@@ -393,7 +401,7 @@ int knot_ctl_send(knot_ctl_t *ctx, knot_ctl_type_t type, knot_ctl_data_t *data)
 	}
 
 	// Send unit type.
-	int ret = send_item(ctx, code, NULL, !is_data_type(type));
+	int ret = send_item(ctx, code, NULL, 0, !is_data_type(type));
 	if (ret != KNOT_EOK) {
 		return ret;
 	}
@@ -407,7 +415,8 @@ int knot_ctl_send(knot_ctl_t *ctx, knot_ctl_type_t type, knot_ctl_data_t *data)
 				continue;
 			}
 
-			ret = send_item(ctx, idx_to_code(i), value, false);
+			size_t value_len = (i == bin_idx) ? bin_len : strlen(value);
+			ret = send_item(ctx, idx_to_code(i), value, value_len, false);
 			if (ret != KNOT_EOK) {
 				return ret;
 			}
@@ -417,6 +426,29 @@ int knot_ctl_send(knot_ctl_t *ctx, knot_ctl_type_t type, knot_ctl_data_t *data)
 	return KNOT_EOK;
 }
 
+_public_
+int knot_ctl_send(knot_ctl_t *ctx, knot_ctl_type_t type, knot_ctl_data_t *data)
+{
+	if (ctx == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	return send_unit(ctx, type, data, KNOT_CTL_IDX__COUNT, 0);
+}
+
+_public_
+int knot_ctl_send_binary(knot_ctl_t *ctx, knot_ctl_type_t type,
+                         knot_ctl_data_t *data, knot_ctl_idx_t bin_idx,
+                         size_t bin_len)
+{
+	if (ctx == NULL || !is_data_type(type) || data == NULL ||
+	    bin_idx >= KNOT_CTL_IDX__COUNT || (*data)[bin_idx] == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	return send_unit(ctx, type, data, bin_idx, bin_len);
+}
+
 static int ensure_input(knot_ctl_t *ctx, uint16_t len)
 {
 	wire_ctx_t *w = &ctx->wire_in;
@@ -464,7 +496,7 @@ static int receive_item_code(knot_ctl_t *ctx, uint8_t *code)
 	return KNOT_EOK;
 }
 
-static int receive_item_value(knot_ctl_t *ctx, char **value)
+static int receive_item_value(knot_ctl_t *ctx, char **value, uint16_t *value_len)
 {
 	wire_ctx_t *w = &ctx->wire_in;
 
@@ -492,6 +524,7 @@ static int receive_item_value(knot_ctl_t *ctx, char **value)
 		return w->error;
 	}
 	(*value)[data_len] = '\0';
+	*value_len = data_len;
 
 	return KNOT_EOK;
 }
@@ -546,7 +579,8 @@ int knot_ctl_receive(knot_ctl_t *ctx, knot_ctl_type_t *type, knot_ctl_data_t *da
 		}
 
 		// Store the item data value.
-		ret = receive_item_value(ctx, (char **)&ctx->data[idx]);
+		ret = receive_item_value(ctx, (char **)&ctx->data[idx],
+		                         &ctx->data_len[idx]);
 		if (ret != KNOT_EOK) {
 			return ret;
 		}
@@ -559,3 +593,13 @@ int knot_ctl_receive(knot_ctl_t *ctx, knot_ctl_type_t *type, knot_ctl_data_t *da
 
 	return KNOT_EOK;
 }
+
+_public_
+size_t knot_ctl_data_len(knot_ctl_t *ctx, knot_ctl_idx_t idx)
+{
+	if (ctx == NULL || idx >= KNOT_CTL_IDX__COUNT) {
+		return 0;
+	}
+
+	return ctx->data_len[idx];
+}
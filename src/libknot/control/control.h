@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include <stddef.h>
+
 /*! Control data item indexes. */
 typedef enum {
 	KNOT_CTL_IDX_CMD = 0, /*!< Control command name. */
@@ -125,6 +127,21 @@ int knot_ctl_connect(knot_ctl_t *ctx, const char *path);
  */
 int knot_ctl_accept(knot_ctl_t *ctx);
 
+/*!
+ * Waits for an incoming connection and assigns it to another context.
+ *
+ * This allows the connections to be processed in parallel, each with its
+ * own context.
+ *
+ * \note Server operation.
+ *
+ * \param[in] ctx         Control context with the bound socket.
+ * \param[in] client_ctx  Control context for the accepted connection.
+ *
+ * \return Error code, KNOT_EOK if successful.
+ */
+int knot_ctl_accept_to(knot_ctl_t *ctx, knot_ctl_t *client_ctx);
+
 /*!
  * Closes the remote connections.
  *
@@ -145,6 +162,24 @@ void knot_ctl_close(knot_ctl_t *ctx);
  */
 int knot_ctl_send(knot_ctl_t *ctx, knot_ctl_type_t type, knot_ctl_data_t *data);
 
+/*!
+ * Sends one control data unit with one binary data item.
+ *
+ * The binary item value is sent with the specified length, so it can contain
+ * any bytes. Other data items are sent as with knot_ctl_send().
+ *
+ * \param[in] ctx      Control context.
+ * \param[in] type     Data unit type to send.
+ * \param[in] data     Data unit to send.
+ * \param[in] bin_idx  Index of the binary data item.
+ * \param[in] bin_len  Length of the binary data item value (up to 65535).
+ *
+ * \return Error code, KNOT_EOK if successful.
+ */
+int knot_ctl_send_binary(knot_ctl_t *ctx, knot_ctl_type_t type,
+                         knot_ctl_data_t *data, knot_ctl_idx_t bin_idx,
+                         size_t bin_len);
+
 /*!
  * Receives one control unit.
  *
@@ -156,4 +191,17 @@ int knot_ctl_send(knot_ctl_t *ctx, knot_ctl_type_t type, knot_ctl_data_t *data);
  */
 int knot_ctl_receive(knot_ctl_t *ctx, knot_ctl_type_t *type, knot_ctl_data_t *data);
 
+/*!
+ * Returns the value length of a data item from the last received unit.
+ *
+ * The received values are always zero terminated, but a binary value
+ * can also contain zero bytes.
+ *
+ * \param[in] ctx  Control context.
+ * \param[in] idx  Data item index.
+ *
+ * \return Value length, 0 if the item is not present.
+ */
+size_t knot_ctl_data_len(knot_ctl_t *ctx, knot_ctl_idx_t idx);
+
 /*! @} */
@@ -28,6 +28,7 @@
 #include "libknot/packet/wire.h"
 #include "libknot/packet/rrset-wire.h"
 #include "libknot/wire.h"
+#include "contrib/macros.h"
 #include "contrib/mempattern.h"
 #include "contrib/wire_ctx.h"
 
@@ -112,6 +113,30 @@ static uint16_t pkt_remaining(knot_pkt_t *pkt)
 	return pkt->max_size - pkt->size - pkt->reserved;
 }
 
+/*!
+ * \brief Returns the lowest possible wire size of the RRSet.
+ *
+ * Each owner can be compressed to a pointer, as well as compressible names
+ * in the RDATA. Other RDATA is written as is, so the rdataset size bounds it
+ * without walking the RRs (each RR has a length and possibly a padding byte).
+ */
+static size_t rrset_wire_min_size(const knot_rrset_t *rr)
+{
+	const size_t count = rr->rrs.count;
+	const size_t owner = MIN(knot_dname_size(rr->owner), sizeof(uint16_t));
+	size_t size = count * (owner + KNOT_WIRE_RR_MIN_SIZE - 1);
+
+	const knot_rdata_descriptor_t *desc = knot_get_rdata_descriptor(rr->type);
+	for (const int *type = desc->block_types; *type != KNOT_RDATA_WF_END; type++) {
+		if (*type == KNOT_RDATA_WF_COMPRESSIBLE_DNAME) {
+			return size;
+		}
+	}
+
+	const size_t overhead = count * (sizeof(uint16_t) + 1);
+	return size + (rr->rrs.size > overhead ? rr->rrs.size - overhead : 0);
+}
+
 /*! \brief Return RR count for given section (from wire xxCOUNT in header). */
 static uint16_t pkt_rr_wirecount(knot_pkt_t *pkt, knot_section_t section_id)
 {
@@ -504,6 +529,15 @@ int knot_pkt_put_rotate(knot_pkt_t *pkt, uint16_t compr_hint, const knot_rrset_t
 		return KNOT_EOK;
 	}
 
+	/* Skip rendering of an RRSet which can't fit. */
+	if (rr->rrs.count > 0 && rrset_wire_min_size(rr) > pkt_remaining(pkt)) {
+		/* Truncate packet if required. */
+		if (!(flags & KNOT_PF_NOTRUNC)) {
+			knot_wire_set_tc(pkt->wire);
+		}
+		return KNOT_ESPACE;
+	}
+
 	knot_rrinfo_t *rrinfo = &pkt->rr_info[pkt->rrset_count];
 	memset(rrinfo, 0, sizeof(knot_rrinfo_t));
 	rrinfo->pos = pkt->size;
@@ -557,6 +591,95 @@ int knot_pkt_put_rotate(knot_pkt_t *pkt, uint16_t compr_hint, const knot_rrset_t
 	return KNOT_EOK;
 }
 
+/*! \brief Returns the length of the first RRs of a pre-rendered RRSet wire. */
+static int wire_rr_offset(const uint8_t *wire, uint16_t wire_len, uint16_t count)
+{
+	const size_t fixed = KNOT_WIRE_RR_MIN_SIZE + 1; /* Pointer, not root label. */
+	size_t offset = 0;
+	for (uint16_t i = 0; i < count; i++) {
+		if (offset + fixed > wire_len) {
+			return KNOT_EMALF;
+		}
+		offset += fixed + knot_wire_read_u16(wire + offset + fixed - sizeof(uint16_t));
+	}
+	if (offset > wire_len) {
+		return KNOT_EMALF;
+	}
+
+	return offset;
+}
+
+_public_
+int knot_pkt_put_wire_rotate(knot_pkt_t *pkt, uint16_t compr_hint, const knot_rrset_t *rr,
+                             const uint8_t *wire, uint16_t wire_len, uint16_t rotate,
+                             uint16_t flags)
+{
+	if (pkt == NULL || rr == NULL || wire == NULL || compr_hint >= KNOT_WIRE_PTR_MAX ||
+	    (compr_hint != KNOT_COMPR_HINT_NONE && compr_hint < KNOT_WIRE_HEADER_SIZE) ||
+	    (compr_hint == KNOT_COMPR_HINT_NONE && rotate != 0)) {
+		return KNOT_EINVAL;
+	}
+
+	/* Reserve memory for RR descriptors. */
+	int ret = pkt_rr_array_alloc(pkt, pkt->rrset_count + 1);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	if (wire_len > pkt_remaining(pkt)) {
+		/* Truncate packet if required. */
+		if (!(flags & KNOT_PF_NOTRUNC)) {
+			knot_wire_set_tc(pkt->wire);
+		}
+		return KNOT_ESPACE;
+	}
+
+	/* Copy the wire, rotated by swapping the leading RRs with the rest. */
+	uint8_t *pos = pkt->wire + pkt->size;
+	if (rotate != 0 && rr->rrs.count > 1) {
+		int split = wire_rr_offset(wire, wire_len, rotate % rr->rrs.count);
+		if (split < 0) {
+			return split;
+		}
+		memcpy(pos, wire + split, wire_len - split);
+		memcpy(pos + wire_len - split, wire, split);
+	} else {
+		memcpy(pos, wire, wire_len);
+	}
+
+	/* Point the owners to the hint. */
+	if (compr_hint != KNOT_COMPR_HINT_NONE) {
+		const size_t fixed = KNOT_WIRE_RR_MIN_SIZE + 1; /* Pointer, not root label. */
+		size_t offset = 0;
+		for (uint16_t i = 0; i < rr->rrs.count; i++) {
+			if (offset + fixed > wire_len) {
+				return KNOT_EMALF;
+			}
+			knot_wire_put_pointer(pos + offset, compr_hint);
+			offset += fixed + knot_wire_read_u16(pos + offset + fixed - sizeof(uint16_t));
+		}
+		if (offset != wire_len) {
+			return KNOT_EMALF;
+		}
+	}
+
+	knot_rrinfo_t *rrinfo = &pkt->rr_info[pkt->rrset_count];
+	memset(rrinfo, 0, sizeof(knot_rrinfo_t));
+	rrinfo->pos = pkt->size;
+	rrinfo->flags = flags;
+	rrinfo->compress_ptr[KNOT_COMPR_HINT_OWNER] = compr_hint;
+	memcpy(pkt->rr + pkt->rrset_count, rr, sizeof(knot_rrset_t));
+
+	if (rr->rrs.count > 0) {
+		pkt->rrset_count += 1;
+		pkt->sections[pkt->current].count += 1;
+		pkt->size += wire_len;
+		pkt_rr_wirecount_add(pkt, pkt->current, rr->rrs.count);
+	}
+
+	return KNOT_EOK;
+}
+
 _public_
 int knot_pkt_parse_question(knot_pkt_t *pkt)
 {
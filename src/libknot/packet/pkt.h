@@ -253,6 +253,44 @@ int knot_pkt_put_question(knot_pkt_t *pkt, const knot_dname_t *qname,
 int knot_pkt_put_rotate(knot_pkt_t *pkt, uint16_t compr_hint, const knot_rrset_t *rr,
                         uint16_t rotate, uint16_t flags);
 
+/*!
+ * \brief Put RRSet into packet using its pre-rendered wire format.
+ *
+ * The wire must contain all RRs of the RRSet without compression, each
+ * starting with a two-byte owner placeholder, which is replaced with
+ * a compression pointer to the position given by the compression hint.
+ *
+ * With KNOT_COMPR_HINT_NONE, the wire is copied as is, including the owners.
+ * The caller is responsible for its validity at the current packet position.
+ *
+ * The RR order can be rotated only if the compression hint is set, as the RRs
+ * mustn't contain compression pointers to each other then.
+ *
+ * \note Available flags: KNOT_PF_NOTRUNC, KNOT_PF_FREE
+ *
+ * \param pkt
+ * \param compr_hint  Absolute position of the owner name in the packet,
+ *                    or KNOT_COMPR_HINT_NONE.
+ * \param rr          RRSet the wire was rendered from.
+ * \param wire        Pre-rendered RRSet wire.
+ * \param wire_len    Length of the pre-rendered wire.
+ * \param rotate      Rotate the RRSet order by this count.
+ * \param flags       RRSet flags.
+ *
+ * \return KNOT_EOK, KNOT_ESPACE, various errors
+ */
+int knot_pkt_put_wire_rotate(knot_pkt_t *pkt, uint16_t compr_hint, const knot_rrset_t *rr,
+                             const uint8_t *wire, uint16_t wire_len, uint16_t rotate,
+                             uint16_t flags);
+
+/*! \brief Same as knot_pkt_put_wire_rotate but without rrset rotation. */
+static inline int knot_pkt_put_wire(knot_pkt_t *pkt, uint16_t compr_hint,
+                                    const knot_rrset_t *rr, const uint8_t *wire,
+                                    uint16_t wire_len, uint16_t flags)
+{
+	return knot_pkt_put_wire_rotate(pkt, compr_hint, rr, wire, wire_len, 0, flags);
+}
+
 /*! \brief Same as knot_pkt_put_rotate but without rrset rotation. */
 static inline int knot_pkt_put(knot_pkt_t *pkt, uint16_t compr_hint,
                                const knot_rrset_t *rr, uint16_t flags)
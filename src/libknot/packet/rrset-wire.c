@@ -631,6 +631,50 @@ static bool allow_zero_rdata(const knot_rrset_t *rr,
 	       desc->type_name == NULL;        // Unknown RR type
 }
 
+/*!
+ * \brief Checks if the RDATA contains no domain names so that it can be copied
+ *        from the wire as is.
+ *
+ * \retval KNOT_EOK      RDATA is plain and the block sizes fit the length.
+ * \retval KNOT_EMALF    RDATA is plain but the block sizes don't fit the length.
+ * \retval KNOT_ENOTSUP  RDATA must be traversed.
+ */
+static int plain_rdata_check(const knot_rdata_descriptor_t *desc, uint16_t rdlength)
+{
+	size_t fixed = 0;
+	for (const int *type = desc->block_types; *type != KNOT_RDATA_WF_END; type++) {
+		if (*type == KNOT_RDATA_WF_REMAINDER) {
+			return (fixed <= rdlength) ? KNOT_EOK : KNOT_EMALF;
+		} else if (*type < 0) {
+			return KNOT_ENOTSUP;
+		}
+		fixed += *type;
+	}
+
+	return (fixed == rdlength) ? KNOT_EOK : KNOT_EMALF;
+}
+
+static int parse_rdata_plain(const uint8_t *pkt_wire, size_t *pos, knot_mm_t *mm,
+                             uint16_t rdlength, knot_rrset_t *rrset)
+{
+	assert(rrset->rrs.count == 0);
+
+	// Copy the RDATA directly into the rdataset, without an intermediate buffer.
+	size_t size = knot_rdata_size(rdlength);
+	rrset->rrs.rdata = mm_alloc(mm, size);
+	if (rrset->rrs.rdata == NULL) {
+		return KNOT_ENOMEM;
+	}
+	knot_rdata_init(rrset->rrs.rdata, rdlength, pkt_wire + *pos);
+	rrset->rrs.count = 1;
+	rrset->rrs.size = size;
+
+	// Update position pointer.
+	*pos += rdlength;
+
+	return KNOT_EOK;
+}
+
 static int parse_rdata(const uint8_t *pkt_wire, size_t *pos, size_t pkt_size,
                        knot_mm_t *mm, uint16_t rdlength, knot_rrset_t *rrset)
 {
@@ -653,6 +697,14 @@ static int parse_rdata(const uint8_t *pkt_wire, size_t *pos, size_t pkt_size,
 		return KNOT_EMALF;
 	}
 
+	// RDATA without domain names doesn't need the traversal.
+	int ret = plain_rdata_check(desc, rdlength);
+	if (ret == KNOT_EOK) {
+		return parse_rdata_plain(pkt_wire, pos, mm, rdlength, rrset);
+	} else if (ret != KNOT_ENOTSUP) {
+		return KNOT_EMALF;
+	}
+
 	// Buffer for parsed rdata (decompression extends rdata length).
 	const size_t max_rdata_len = UINT16_MAX;
 	uint8_t buf[knot_rdata_size(max_rdata_len)];
@@ -664,7 +716,7 @@ static int parse_rdata(const uint8_t *pkt_wire, size_t *pos, size_t pkt_size,
 	size_t dst_avail = max_rdata_len;
 
 	// Parse RDATA.
-	int ret = rdata_traverse_parse(&src, &src_avail, &dst, &dst_avail, desc, pkt_wire);
+	ret = rdata_traverse_parse(&src, &src_avail, &dst, &dst_avail, desc, pkt_wire);
 	if (ret != KNOT_EOK) {
 		return KNOT_EMALF;
 	}
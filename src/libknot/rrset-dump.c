@@ -39,6 +39,7 @@
 #include "contrib/base32hex.h"
 #include "contrib/base64.h"
 #include "contrib/ctype.h"
+#include "contrib/macros.h"
 #include "contrib/wire_ctx.h"
 
 #define RRSET_DUMP_LIMIT (2 * 1024 * 1024)
@@ -81,6 +82,161 @@ const knot_dump_style_t KNOT_DUMP_STYLE_DEFAULT = {
 	.ascii_to_idn = NULL
 };
 
+/*! \brief Writes a decimal number without printf, returns the length or -1. */
+static int num_to_str(char *out, size_t out_max, uint64_t num)
+{
+	char tmp[20];
+	int len = 0;
+	do {
+		tmp[len++] = '0' + num % 10;
+		num /= 10;
+	} while (num > 0);
+
+	// Check output size (+ 1 termination).
+	if ((size_t)len >= out_max) {
+		return -1;
+	}
+
+	for (int i = 0; i < len; i++) {
+		out[i] = tmp[len - 1 - i];
+	}
+	out[len] = '\0';
+
+	return len;
+}
+
+/*! \brief Writes an IPv4 address in the dotted-decimal notation. */
+static int ipv4_to_str(char *out, size_t out_max, const uint8_t *in)
+{
+	char tmp[INET_ADDRSTRLEN];
+	int len = 0;
+	for (int i = 0; i < 4; i++) {
+		if (i > 0) {
+			tmp[len++] = '.';
+		}
+		len += num_to_str(tmp + len, sizeof(tmp) - len, in[i]);
+	}
+
+	if ((size_t)len >= out_max) {
+		return -1;
+	}
+	memcpy(out, tmp, len + 1);
+
+	return len;
+}
+
+/*! \brief Writes an IPv6 address, the same notation as inet_ntop(). */
+static int ipv6_to_str(char *out, size_t out_max, const uint8_t *in)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	uint16_t words[8];
+	for (int i = 0; i < 8; i++) {
+		words[i] = (in[2 * i] << 8) | in[2 * i + 1];
+	}
+
+	// Find the longest run of zero words (the first one if more).
+	int best_base = -1, best_len = 0, cur_base = -1, cur_len = 0;
+	for (int i = 0; i < 8; i++) {
+		if (words[i] == 0) {
+			if (cur_base == -1) {
+				cur_base = i;
+				cur_len = 1;
+			} else {
+				cur_len++;
+			}
+		} else if (cur_base != -1) {
+			if (best_base == -1 || cur_len > best_len) {
+				best_base = cur_base;
+				best_len = cur_len;
+			}
+			cur_base = -1;
+		}
+	}
+	if (cur_base != -1 && (best_base == -1 || cur_len > best_len)) {
+		best_base = cur_base;
+		best_len = cur_len;
+	}
+	if (best_base != -1 && best_len < 2) {
+		best_base = -1;
+	}
+
+	char tmp[INET6_ADDRSTRLEN];
+	int len = 0;
+	for (int i = 0; i < 8; i++) {
+		// Compress the zero run.
+		if (best_base != -1 && i >= best_base && i < best_base + best_len) {
+			if (i == best_base) {
+				tmp[len++] = ':';
+			}
+			continue;
+		}
+		if (i != 0) {
+			tmp[len++] = ':';
+		}
+		// Embedded IPv4 address (compatible or mapped).
+		if (i == 6 && best_base == 0 && (best_len == 6 ||
+		    (best_len == 7 && words[7] != 0x0001) ||
+		    (best_len == 5 && words[5] == 0xffff))) {
+			len += ipv4_to_str(tmp + len, sizeof(tmp) - len, in + 12);
+			break;
+		}
+		bool lead = true;
+		for (int shift = 12; shift >= 0; shift -= 4) {
+			uint8_t nibble = (words[i] >> shift) & 0x0f;
+			if (lead && nibble == 0 && shift > 0) {
+				continue;
+			}
+			lead = false;
+			tmp[len++] = hex[nibble];
+		}
+	}
+	if (best_base != -1 && best_base + best_len == 8) {
+		tmp[len++] = ':';
+	}
+	tmp[len] = '\0';
+
+	if ((size_t)len >= out_max) {
+		return -1;
+	}
+	memcpy(out, tmp, len + 1);
+
+	return len;
+}
+
+/*! \brief Writes a timestamp in the YYYYMMDDhhmmss format without strftime. */
+static int timestamp_to_str(char *out, size_t out_max, uint32_t timestamp)
+{
+	if (out_max <= 14) {
+		return -1;
+	}
+
+	// Civil date from the number of days since 1970-01-01.
+	uint32_t days = timestamp / 86400, secs = timestamp % 86400;
+	uint32_t z = days + 719468;
+	uint32_t era = z / 146097;
+	uint32_t doe = z - era * 146097;
+	uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	uint32_t mp = (5 * doy + 2) / 153;
+	uint32_t day = doy - (153 * mp + 2) / 5 + 1;
+	uint32_t month = mp < 10 ? mp + 3 : mp - 9;
+	uint32_t year = yoe + era * 400 + (month <= 2);
+
+	uint32_t fields[] = { month, day, secs / 3600, secs / 60 % 60, secs % 60 };
+	out[0] = '0' + year / 1000;
+	out[1] = '0' + year / 100 % 10;
+	out[2] = '0' + year / 10 % 10;
+	out[3] = '0' + year % 10;
+	for (int i = 0; i < 5; i++) {
+		out[4 + 2 * i] = '0' + fields[i] / 10;
+		out[5 + 2 * i] = '0' + fields[i] % 10;
+	}
+	out[14] = '\0';
+
+	return 14;
+}
+
 static void dump_string(rrset_dump_params_t *p, const char *str)
 {
 	CHECK_PRET
@@ -116,7 +272,7 @@ static void wire_num8_to_str(rrset_dump_params_t *p)
 	CHECK_INMAX(in_len)
 
 	// Write number.
-	int ret = snprintf(p->out, p->out_max, "%u", data);
+	int ret = num_to_str(p->out, p->out_max, data);
 	CHECK_RET_OUTMAX_SNPRINTF
 	out_len = ret;
 
@@ -142,7 +298,7 @@ static void wire_num16_to_str(rrset_dump_params_t *p)
 	data = knot_wire_read_u16(p->in);
 
 	// Write number.
-	int ret = snprintf(p->out, p->out_max, "%u", data);
+	int ret = num_to_str(p->out, p->out_max, data);
 	CHECK_RET_OUTMAX_SNPRINTF
 	out_len = ret;
 
@@ -168,7 +324,7 @@ static void wire_num32_to_str(rrset_dump_params_t *p)
 	data = knot_wire_read_u32(p->in);
 
 	// Write number.
-	int ret = snprintf(p->out, p->out_max, "%u", data);
+	int ret = num_to_str(p->out, p->out_max, data);
 	CHECK_RET_OUTMAX_SNPRINTF
 	out_len = ret;
 
@@ -194,7 +350,7 @@ static void wire_num48_to_str(rrset_dump_params_t *p)
 	data = knot_wire_read_u48(p->in);
 
 	// Write number.
-	int ret = snprintf(p->out, p->out_max, "%"PRIu64"", data);
+	int ret = num_to_str(p->out, p->out_max, data);
 	CHECK_RET_OUTMAX_SNPRINTF
 	out_len = ret;
 
@@ -219,11 +375,9 @@ static void wire_ipv4_to_str(rrset_dump_params_t *p)
 	FILL_IN_INPUT(addr4.s_addr)
 
 	// Write address.
-	if (inet_ntop(AF_INET, &addr4, p->out, p->out_max) == NULL) {
-		p->ret = -1;
-		return;
-	}
-	out_len = strlen(p->out);
+	int ret = ipv4_to_str(p->out, p->out_max, (const uint8_t *)&addr4.s_addr);
+	CHECK_RET_POSITIVE
+	out_len = ret;
 
 	// Fill in output.
 	p->in += in_len;
@@ -246,11 +400,9 @@ static void wire_ipv6_to_str(rrset_dump_params_t *p)
 	FILL_IN_INPUT(addr6.s6_addr)
 
 	// Write address.
-	if (inet_ntop(AF_INET6, &addr6, p->out, p->out_max) == NULL) {
-		p->ret = -1;
-		return;
-	}
-	out_len = strlen(p->out);
+	int ret = ipv6_to_str(p->out, p->out_max, addr6.s6_addr);
+	CHECK_RET_POSITIVE
+	out_len = ret;
 
 	// Fill in output.
 	p->in += in_len;
@@ -337,7 +489,7 @@ static int num48_encode(const uint8_t  *in,
 
 	uint64_t data = knot_wire_read_u48(in);
 
-	int ret = snprintf((char *)out, out_len, "%"PRIu64"", data);
+	int ret = num_to_str((char *)out, out_len, data);
 	if (ret <= 0 || (size_t)ret >= out_len) {
 		return -1;
 	}
@@ -666,17 +818,13 @@ static void wire_timestamp_to_str(rrset_dump_params_t *p)
 
 	FILL_IN_INPUT(data)
 
-	time_t timestamp = ntohl(data);
-
 	if (p->style->human_tmstamp) {
-		struct tm result;
 		// Write timestamp in YYYYMMDDhhmmss format.
-		ret = strftime(p->out, p->out_max, "%Y%m%d%H%M%S",
-		               gmtime_r(&timestamp, &result));
+		ret = timestamp_to_str(p->out, p->out_max, ntohl(data));
 		CHECK_RET_POSITIVE
 	} else {
 		// Write timestamp only.
-		ret = snprintf(p->out, p->out_max, "%u", ntohl(data));
+		ret = num_to_str(p->out, p->out_max, ntohl(data));
 		CHECK_RET_OUTMAX_SNPRINTF
 	}
 	out_len = ret;
@@ -738,7 +886,7 @@ static void wire_ttl_to_str(rrset_dump_params_t *p)
 		CHECK_RET_POSITIVE
 	} else {
 		// Write timestamp only.
-		ret = snprintf(p->out, p->out_max, "%u", ntohl(data));
+		ret = num_to_str(p->out, p->out_max, ntohl(data));
 		CHECK_RET_OUTMAX_SNPRINTF
 	}
 	out_len = ret;
@@ -1905,18 +2053,36 @@ int knot_rrset_txt_dump_header(const knot_rrset_t      *rrset,
 	int    ret;
 
 	// Dump rrset owner.
-	char *name = knot_dname_to_str_alloc(rrset->owner);
-	if (style->ascii_to_idn != NULL) {
+	knot_dname_txt_storage_t name_buf;
+	char *name;
+	if (style->ascii_to_idn == NULL) {
+		name = knot_dname_to_str(name_buf, rrset->owner, sizeof(name_buf));
+	} else {
+		name = knot_dname_to_str_alloc(rrset->owner);
 		style->ascii_to_idn(&name);
 	}
-	char sep = strlen(name) < 4 * TAB_WIDTH ? '\t' : ' ';
-	ret = snprintf(dst + len, maxlen - len, "%-20s%c", name, sep);
-	free(name);
-	SNPRINTF_CHECK(ret, maxlen - len);
-	len += ret;
+	if (name == NULL) {
+		return KNOT_EINVAL;
+	}
+	size_t name_len = strlen(name);
+	size_t name_width = MAX(name_len, 20);
+	if (name_width + 1 >= maxlen - len) {
+		if (name != name_buf) {
+			free(name);
+		}
+		return KNOT_ESPACE;
+	}
+	memcpy(dst + len, name, name_len);
+	memset(dst + len + name_len, ' ', name_width - name_len);
+	len += name_width;
+	dst[len++] = name_len < 4 * TAB_WIDTH ? '\t' : ' ';
+	dst[len] = '\0';
+	if (name != name_buf) {
+		free(name);
+	}
 
 	// Set white space separation character.
-	sep = style->wrap ? ' ' : '\t';
+	char sep = style->wrap ? ' ' : '\t';
 
 	// Dump rrset ttl.
 	if (style->show_ttl) {
@@ -1930,7 +2096,11 @@ int knot_rrset_txt_dump_header(const knot_rrset_t      *rrset,
 			ret = snprintf(dst + len, maxlen - len, "%s%c",
 			               buf, sep);
 		} else {
-			ret = snprintf(dst + len, maxlen - len, "%u%c", ttl, sep);
+			ret = num_to_str(dst + len, maxlen - len - 1, ttl);
+			if (ret >= 0) {
+				dst[len + ret++] = sep;
+				dst[len + ret] = '\0';
+			}
 		}
 		SNPRINTF_CHECK(ret, maxlen - len);
 		len += ret;
@@ -1130,6 +1130,229 @@ static int process_xfr(const query_t *query)
 	return ret;
 }
 
+#define BENCH_HIST_SIZE	16	/*!< Number of latency histogram buckets. */
+#define BENCH_HIST_BASE	16	/*!< Upper bound of the first bucket in microseconds. */
+#define BENCH_STREAM_MAX	64	/*!< Maximum of queries in flight over TCP or TLS. */
+#define BENCH_EXPIRE_IVAL	100	/*!< Interval of lost queries checks in milliseconds. */
+
+typedef struct {
+	bool            used;
+	struct timespec sent;
+} bench_slot_t;
+
+typedef struct {
+	size_t sent;
+	size_t received;
+	size_t lost;
+	double min;
+	double max;
+	double sum;
+	size_t hist[BENCH_HIST_SIZE];
+} bench_stats_t;
+
+static void bench_account(bench_stats_t *stats, double usec)
+{
+	stats->received++;
+	stats->sum += usec;
+	if (stats->received == 1 || usec < stats->min) {
+		stats->min = usec;
+	}
+	if (usec > stats->max) {
+		stats->max = usec;
+	}
+
+	size_t bucket = 0;
+	double bound = BENCH_HIST_BASE;
+	while (usec >= bound && bucket < BENCH_HIST_SIZE - 1) {
+		bound *= 2;
+		bucket++;
+	}
+	stats->hist[bucket]++;
+}
+
+static void bench_expire(bench_slot_t *slots, size_t window, size_t *inflight,
+                         bench_stats_t *stats, const struct timespec *now,
+                         int wait)
+{
+	for (size_t i = 0; i < window; i++) {
+		if (slots[i].used && time_diff_ms(&slots[i].sent, now) >= 1000.0 * wait) {
+			slots[i].used = false;
+			(*inflight)--;
+			stats->lost++;
+		}
+	}
+}
+
+static void bench_print(const bench_stats_t *stats, const struct timespec *begin,
+                        const struct timespec *end)
+{
+	double elapsed = time_diff_ms(begin, end) / 1000;
+
+	printf(";; Benchmark: sent %zu, received %zu, lost %zu in %.3f s",
+	       stats->sent, stats->received, stats->lost, elapsed);
+	if (elapsed > 0) {
+		printf(" (%.0f qps)", stats->received / elapsed);
+	}
+	printf("\n");
+
+	if (stats->received == 0) {
+		return;
+	}
+
+	printf(";; Latency: min %.0f us, avg %.0f us, max %.0f us\n",
+	       stats->min, stats->sum / stats->received, stats->max);
+
+	double bound = BENCH_HIST_BASE;
+	for (size_t i = 0; i < BENCH_HIST_SIZE; i++, bound *= 2) {
+		if (stats->hist[i] == 0) {
+			continue;
+		}
+		if (i < BENCH_HIST_SIZE - 1) {
+			printf(";;   < %8.0f us: %zu\n", bound, stats->hist[i]);
+		} else {
+			printf(";;  >= %8.0f us: %zu\n", bound / 2, stats->hist[i]);
+		}
+	}
+}
+
+static int process_bench(const list_t *queries)
+{
+	const query_t *query = (query_t *)HEAD(*queries);
+	if (EMPTY_LIST(query->servers)) {
+		ERR("no server to benchmark\n");
+		return -1;
+	}
+	const srv_info_t *remote = (srv_info_t *)HEAD(query->servers);
+
+	if (query->tsig_key.name != NULL) {
+		WARN("TSIG is not supported in the benchmark mode\n");
+	}
+
+	// Get connection parameters from the first query.
+	int iptype = get_iptype(query->ip);
+	int socktype = get_socktype(query->protocol, query->type_num);
+	int flags = query->fastopen ? NET_FLAGS_FASTOPEN : NET_FLAGS_NONE;
+
+	net_t net;
+	int ret = net_init(query->local, remote, iptype, socktype, query->wait,
+	                   flags, &query->tls, &net);
+	if (ret != KNOT_EOK) {
+		ERR("failed to query server %s@%s(%s)\n",
+		    remote->name, remote->service, get_sockname(socktype));
+		return -1;
+	}
+
+	// All queries share one connection, so that TCP and TLS are pipelined.
+	ret = net_connect(&net);
+	if (ret != KNOT_EOK) {
+		net_clean(&net);
+		return -1;
+	}
+
+	// The blocking writes can't be interleaved with reads, so over a stream
+	// all queries in flight must fit into the socket buffers. Otherwise both
+	// sides could block on writing while the other one isn't reading.
+	size_t window = query->bench;
+	if (socktype == SOCK_STREAM && window > BENCH_STREAM_MAX) {
+		WARN("limiting queries in flight to %u over TCP\n", BENCH_STREAM_MAX);
+		window = BENCH_STREAM_MAX;
+	}
+
+	// Query ID is the index of its slot.
+	bench_slot_t *slots = calloc(window, sizeof(*slots));
+	uint8_t *in = malloc(MAX_PACKET_SIZE);
+	if (slots == NULL || in == NULL) {
+		free(slots);
+		free(in);
+		net_clean(&net);
+		return -1;
+	}
+
+	bench_stats_t stats = { 0 };
+	size_t inflight = 0, next_slot = 0;
+	node_t *n = HEAD(*queries);
+
+	struct timespec begin = time_now();
+	struct timespec last_expire = begin;
+
+	while (n->next != NULL || inflight > 0) {
+		// Fill up the window.
+		while (n->next != NULL && inflight < window) {
+			const query_t *q = (query_t *)n;
+			n = n->next;
+
+			knot_pkt_t *pkt = create_query_packet(q);
+			if (pkt == NULL) {
+				ERR("can't create query packet\n");
+				continue;
+			}
+
+			while (slots[next_slot].used) {
+				next_slot = (next_slot + 1) % window;
+			}
+			knot_wire_set_id(pkt->wire, next_slot);
+
+			slots[next_slot].sent = time_now();
+			ret = net_send(&net, pkt->wire, pkt->size);
+			knot_pkt_free(pkt);
+			if (ret != KNOT_EOK) {
+				goto finish;
+			}
+
+			slots[next_slot].used = true;
+			inflight++;
+			stats.sent++;
+		}
+
+		if (inflight == 0) {
+			break;
+		}
+
+		// Collect one reply.
+		ret = net_receive(&net, in, MAX_PACKET_SIZE);
+		struct timespec now = time_now();
+
+		// Consider lost only the queries waiting longer than the timeout.
+		if (query->wait > 0 && (ret == KNOT_NET_ETIMEOUT ||
+		    time_diff_ms(&last_expire, &now) >= BENCH_EXPIRE_IVAL)) {
+			bench_expire(slots, window, &inflight, &stats, &now, query->wait);
+			last_expire = now;
+		}
+
+		if (ret == KNOT_NET_ETIMEOUT) {
+			continue;
+		} else if (ret < 0) {
+			goto finish;
+		} else if (ret < KNOT_WIRE_HEADER_SIZE) {
+			continue;
+		}
+
+		uint16_t id = knot_wire_get_id(in);
+		if (id >= window || !slots[id].used) {
+			DBG("unexpected reply ID %u\n", id);
+			continue;
+		}
+		slots[id].used = false;
+		inflight--;
+
+		bench_account(&stats, time_diff_ms(&slots[id].sent, &now) * 1000);
+	}
+
+	ret = KNOT_EOK;
+finish:
+	stats.lost += inflight;
+	struct timespec end = time_now();
+
+	bench_print(&stats, &begin, &end);
+
+	free(slots);
+	free(in);
+	net_close(&net);
+	net_clean(&net);
+
+	return (ret == KNOT_EOK) ? 0 : -1;
+}
+
 int kdig_exec(const kdig_params_t *params)
 {
 	node_t *n = NULL;
@@ -1139,6 +1362,12 @@ int kdig_exec(const kdig_params_t *params)
 		return KNOT_EINVAL;
 	}
 
+	// Benchmark mode processes the whole query list at once.
+	const query_t *first = (query_t *)HEAD(params->queries);
+	if (!EMPTY_LIST(params->queries) && first->bench > 0) {
+		return process_bench(&params->queries) == 0 ? KNOT_EOK : KNOT_ERROR;
+	}
+
 	bool success = true;
 
 	// Loop over query list.
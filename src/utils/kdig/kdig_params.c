@@ -29,6 +29,7 @@
 #include "libknot/descriptor.h"
 #include "libknot/libknot.h"
 #include "contrib/base64.h"
+#include "contrib/getline.h"
 #include "contrib/sockaddr.h"
 #include "contrib/string.h"
 #include "contrib/strtonum.h"
@@ -41,6 +42,7 @@
 #define DEFAULT_RETRIES_DIG	2
 #define DEFAULT_TIMEOUT_DIG	5
 #define DEFAULT_ALIGNMENT_SIZE	128
+#define DEFAULT_BENCH_INFLIGHT	10
 
 static const flags_t DEFAULT_FLAGS_DIG = {
 	.aa_flag = false,
@@ -1094,6 +1096,29 @@ static int opt_noretry(const char *arg, void *query)
 	return KNOT_EOK;
 }
 
+static int opt_bench(const char *arg, void *query)
+{
+	query_t *q = query;
+
+	if (arg == NULL) {
+		q->bench = DEFAULT_BENCH_INFLIGHT;
+	} else if (str_to_u16(arg, &q->bench) != KNOT_EOK || q->bench == 0) {
+		ERR("invalid +bench=%s\n", arg);
+		return KNOT_EINVAL;
+	}
+
+	return KNOT_EOK;
+}
+
+static int opt_nobench(const char *arg, void *query)
+{
+	query_t *q = query;
+
+	q->bench = 0;
+
+	return KNOT_EOK;
+}
+
 static int parse_ednsopt(const char *arg, ednsopt_t **opt_ptr)
 {
 	errno = 0;
@@ -1297,6 +1322,9 @@ static const param_t kdig_opts2[] = {
 	{ "edns",           ARG_OPTIONAL, opt_edns },
 	{ "noedns",         ARG_NONE,     opt_noedns },
 
+	{ "bench",          ARG_OPTIONAL, opt_bench },
+	{ "nobench",        ARG_NONE,     opt_nobench },
+
 	{ "timeout",        ARG_REQUIRED, opt_timeout },
 	{ "notimeout",      ARG_NONE,     opt_notimeout },
 
@@ -1339,6 +1367,7 @@ query_t *query_create(const char *owner, const query_t *conf)
 		query->port = strdup("");
 		query->udp_size = -1;
 		query->retries = DEFAULT_RETRIES_DIG;
+		query->bench = 0;
 		query->wait = DEFAULT_TIMEOUT_DIG;
 		query->ignore_tc = false;
 		query->class_num = -1;
@@ -1587,6 +1616,8 @@ void kdig_clean(kdig_params_t *params)
 	// Clean up config.
 	query_free(params->config);
 
+	free(params->batch_file);
+
 	// Clean up the structure.
 	memset(params, 0, sizeof(*params));
 }
@@ -1941,6 +1972,7 @@ static void print_help(void)
 	printf("Usage: %s [-4] [-6] [-d] [-b address] [-c class] [-p port]\n"
 	       "            [-q name] [-t type] [-x address] [-k keyfile]\n"
 	       "            [-y [algo:]keyname:key] [-E tapfile] [-G tapfile]\n"
+	       "            [-f batchfile]\n"
 	       "            name [type] [class] [@server]\n"
 	       "\n"
 	       "       +[no]multiline            Wrap long records to more lines.\n"
@@ -1985,6 +2017,7 @@ static void print_help(void)
 	       "       +[no]alignment[=N]        Pad with EDNS(0) to blocksize (%u or specify size).\n"
 	       "       +[no]subnet=SUBN          Set EDNS(0) client subnet addr/prefix.\n"
 	       "       +[no]edns[=N]             Use EDNS(=version).\n"
+	       "       +[no]bench[=N]            Benchmark with N queries in flight (default %u).\n"
 	       "       +[no]timeout=T            Set wait for reply interval in seconds.\n"
 	       "       +[no]retry=N              Set number of retries.\n"
 	       "       +[no]cookie=HEX           Attach EDNS(0) cookie to the query.\n"
@@ -1994,7 +2027,7 @@ static void print_help(void)
 	       "\n"
 	       "       -h, --help                Print the program help.\n"
 	       "       -V, --version             Print the program version.\n",
-	       PROGRAM_NAME, DEFAULT_ALIGNMENT_SIZE);
+	       PROGRAM_NAME, DEFAULT_ALIGNMENT_SIZE, DEFAULT_BENCH_INFLIGHT);
 }
 
 static int parse_opt1(const char *opt, const char *value, kdig_params_t *params,
@@ -2050,6 +2083,19 @@ static int parse_opt1(const char *opt, const char *value, kdig_params_t *params,
 	case 'd':
 		msg_enable_debug(1);
 		break;
+	case 'f':
+		if (val == NULL) {
+			ERR("missing filename\n");
+			return KNOT_EINVAL;
+		}
+
+		free(params->batch_file);
+		params->batch_file = strdup(val);
+		if (params->batch_file == NULL) {
+			return KNOT_ENOMEM;
+		}
+		*index += add;
+		break;
 	case 'h':
 		if (len > 1) {
 			ERR("invalid option -%s\n", opt);
@@ -2276,6 +2322,48 @@ static int parse_opt2(const char *value, kdig_params_t *params)
 	return kdig_opts2[ret].handler(arg, query);
 }
 
+static int parse_token(const char *value, kdig_params_t *params);
+
+static int parse_batch(const char *file_name, kdig_params_t *params)
+{
+	FILE *file = fopen(file_name, "r");
+	if (file == NULL) {
+		ERR("can't open batch file %s\n", file_name);
+		return KNOT_EFILE;
+	}
+
+	int ret = KNOT_EOK;
+	char *line = NULL;
+	size_t line_len = 0;
+	size_t line_num = 0;
+
+	// Each line contains a query name with an optional type and class.
+	while (ret == KNOT_EOK && knot_getline(&line, &line_len, file) != -1) {
+		line_num++;
+
+		char *save = NULL;
+		char *token = strtok_r(line, " \t\r\n", &save);
+		if (token == NULL || token[0] == ';') {
+			continue;
+		}
+
+		ret = parse_name(token, &params->queries, params->config);
+		while (ret == KNOT_EOK &&
+		       (token = strtok_r(NULL, " \t\r\n", &save)) != NULL) {
+			ret = parse_token(token, params);
+		}
+		if (ret != KNOT_EOK) {
+			ERR("invalid query on line %zu in batch file %s\n",
+			    line_num, file_name);
+		}
+	}
+
+	free(line);
+	fclose(file);
+
+	return ret;
+}
+
 static int parse_token(const char *value, kdig_params_t *params)
 {
 	query_t *query;
@@ -2358,6 +2446,14 @@ int kdig_parse(kdig_params_t *params, int argc, char *argv[])
 		}
 	}
 
+	// Append the queries from the batch file.
+	if (params->batch_file != NULL) {
+		int ret = parse_batch(params->batch_file, params);
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+	}
+
 	// Complete missing data in queries based on defaults.
 	complete_queries(&params->queries, params->config);
 
@@ -86,6 +86,8 @@ struct query {
 	int32_t		udp_size;
 	/*!< Number of UDP retries. */
 	uint32_t	retries;
+	/*!< Number of queries in flight in the benchmark mode (0 ~ disabled). */
+	uint16_t	bench;
 	/*!< Wait for network response in seconds (-1 means forever). */
 	int32_t		wait;
 	/*!< Ignore truncated response. */
@@ -154,6 +156,8 @@ typedef struct {
 	list_t	queries;
 	/*!< Default settings for queries. */
 	query_t	*config;
+	/*!< File with additional queries, one per line. */
+	char	*batch_file;
 } kdig_params_t;
 
 query_t *query_create(const char *owner, const query_t *config);
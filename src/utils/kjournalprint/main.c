@@ -16,6 +16,7 @@
 
 #include <stdlib.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <sys/stat.h>
 
 #include "libknot/libknot.h"
@@ -42,9 +43,16 @@ static void print_help(void)
 	       "\n"
 	       "Parameters:\n"
 	       " -l, --limit <num>  Read only <num> newest changes.\n"
+	       " -S, --serial <from>[:<to>]\n"
+	       "                    Read only changes starting at serial <from>\n"
+	       "                    and optionally ending at serial <to>.\n"
 	       " -n, --no-color     Get output without terminal coloring.\n"
 	       " -z, --zone-list    Instead of reading jurnal, display the list\n"
 	       "                    of zones in the DB (<zone_name> not needed).\n"
+	       " -s, --stats        Instead of reading journal, display its summary\n"
+	       "                    statistics (all zones if <zone_name> not given).\n"
+	       " -j, --jobs <num>   Number of zones processed in parallel in the\n"
+	       "                    statistics mode.\n"
 	       " -c, --check        Additional journal semantic checks.\n"
 	       " -d, --debug        Debug mode output.\n"
 	       " -h, --help         Print the program help.\n"
@@ -58,6 +66,10 @@ typedef struct {
 	bool check;
 	int limit;
 	int counter;
+	bool from_valid;
+	uint32_t from;
+	bool to_valid;
+	uint32_t to;
 } print_params_t;
 
 static void print_changeset(const changeset_t *chs, print_params_t *params)
@@ -161,6 +173,30 @@ static int print_changeset_cb(bool special, const changeset_t *ch, void *ctx)
 	return KNOT_EOK;
 }
 
+static int print_serial_range(zone_journal_t j, print_params_t *params)
+{
+	journal_read_t *read = NULL;
+	int ret = journal_read_begin(j, false, params->from, &read);
+	if (ret != KNOT_EOK) {
+		fprintf(stderr, "Changeset with serial %u not found\n", params->from);
+		return ret;
+	}
+
+	changeset_t ch;
+	while (journal_read_changeset(read, &ch)) {
+		uint32_t serial_to = changeset_to(&ch);
+		(void)print_changeset_cb(false, &ch, params);
+		journal_read_clear_changeset(&ch);
+		if (params->to_valid && serial_to == params->to) {
+			break;
+		}
+	}
+	ret = journal_read_get_error(read, KNOT_EOK);
+	journal_read_end(read);
+
+	return ret;
+}
+
 int print_journal(char *path, knot_dname_t *name, print_params_t *params)
 {
 	knot_lmdb_db_t jdb = { 0 };
@@ -191,17 +227,23 @@ int print_journal(char *path, knot_dname_t *name, print_params_t *params)
 		}
 	}
 
-	if (params->limit >= 0 && ret == KNOT_EOK) {
-		ret = journal_walk(j, count_changeset_cb, params);
-	}
-	if (ret == KNOT_EOK) {
-		if (params->limit < 0 || params->counter <= params->limit) {
-			params->limit = 0;
-		} else {
-			params->limit = params->counter - params->limit;
-		}
+	if (params->from_valid && ret == KNOT_EOK) {
+		params->limit = 0;
 		params->counter = 0;
-		ret = journal_walk(j, print_changeset_cb, params);
+		ret = print_serial_range(j, params);
+	} else {
+		if (params->limit >= 0 && ret == KNOT_EOK) {
+			ret = journal_walk(j, count_changeset_cb, params);
+		}
+		if (ret == KNOT_EOK) {
+			if (params->limit < 0 || params->counter <= params->limit) {
+				params->limit = 0;
+			} else {
+				params->limit = params->counter - params->limit;
+			}
+			params->counter = 0;
+			ret = journal_walk(j, print_changeset_cb, params);
+		}
 	}
 
 	if (params->debug && ret == KNOT_EOK) {
@@ -213,6 +255,275 @@ int print_journal(char *path, knot_dname_t *name, print_params_t *params)
 	return ret;
 }
 
+typedef struct {
+	uint16_t type;
+	size_t removed;
+	size_t added;
+} type_stats_t;
+
+dynarray_declare(type_stats, type_stats_t, DYNARRAY_VISIBILITY_STATIC, 32)
+dynarray_define(type_stats, type_stats_t, DYNARRAY_VISIBILITY_STATIC)
+
+typedef struct {
+	knot_dname_t *zone;
+	type_stats_dynarray_t types;
+	size_t removed;
+	size_t added;
+	char *out;
+	size_t out_len;
+	int ret;
+} zone_stats_t;
+
+static int skim_type_cb(bool in_remove_section, uint16_t type, uint16_t rr_count, void *ctx)
+{
+	zone_stats_t *stats = ctx;
+
+	type_stats_t *found = NULL;
+	dynarray_foreach(type_stats, type_stats_t, i, stats->types) {
+		if (i->type == type) {
+			found = i;
+			break;
+		}
+	}
+	if (found == NULL) {
+		type_stats_t add = { .type = type };
+		ssize_t size = stats->types.size;
+		type_stats_dynarray_add(&stats->types, &add);
+		if (stats->types.size == size) {
+			return KNOT_ENOMEM;
+		}
+		found = stats->types.arr(&stats->types) + size;
+	}
+
+	if (in_remove_section) {
+		found->removed += rr_count;
+		stats->removed += rr_count;
+	} else {
+		found->added += rr_count;
+		stats->added += rr_count;
+	}
+
+	return KNOT_EOK;
+}
+
+static int skim_special(zone_journal_t j, bool zij, uint32_t serial,
+                        zone_stats_t *stats, FILE *out)
+{
+	journal_read_t *read = NULL;
+	int ret = journal_read_begin(j, zij, serial, &read);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	journal_skim_t skim;
+	if (journal_read_skim(read, skim_type_cb, stats, &skim)) {
+		if (zij) {
+			fprintf(out, "Zone-in-journal:   serial %u, %zu records, %zu bytes\n",
+			        skim.serial_to, skim.add_count, skim.size);
+		} else {
+			fprintf(out, "Merged changeset:  %u -> %u, -%zu +%zu records, %zu bytes\n",
+			        skim.serial_from, skim.serial_to, skim.remove_count,
+			        skim.add_count, skim.size);
+		}
+	}
+	ret = journal_read_get_error(read, KNOT_EOK);
+	journal_read_end(read);
+
+	return ret;
+}
+
+static int skim_changesets(zone_journal_t j, uint32_t first_serial,
+                           zone_stats_t *stats, FILE *out)
+{
+	journal_read_t *read = NULL;
+	int ret = journal_read_begin(j, false, first_serial, &read);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	size_t count = 0, size = 0, max_size = 0;
+	uint32_t last_serial = first_serial;
+	journal_skim_t skim;
+	while (journal_read_skim(read, skim_type_cb, stats, &skim)) {
+		count++;
+		size += skim.size;
+		max_size = MAX(max_size, skim.size);
+		last_serial = skim.serial_to;
+	}
+	ret = journal_read_get_error(read, KNOT_EOK);
+	journal_read_end(read);
+
+	fprintf(out, "Changesets:        %zu, serials %u -> %u, %zu bytes (max %zu)\n",
+	        count, first_serial, last_serial, size, max_size);
+
+	return ret;
+}
+
+static void zone_stats(knot_lmdb_db_t *jdb, zone_stats_t *stats)
+{
+	zone_journal_t j = { jdb, stats->zone };
+
+	FILE *out = open_memstream(&stats->out, &stats->out_len);
+	if (out == NULL) {
+		stats->ret = KNOT_ENOMEM;
+		return;
+	}
+
+	knot_dname_txt_storage_t zone_str;
+	(void)knot_dname_to_str(zone_str, stats->zone, sizeof(zone_str));
+	fprintf(out, ";; Zone %s\n", zone_str);
+
+	journal_metadata_t md;
+	knot_lmdb_txn_t txn = { 0 };
+	knot_lmdb_begin(jdb, &txn, false);
+	journal_load_metadata(&txn, stats->zone, &md);
+	bool has_zij = journal_contains(&txn, true, 0, stats->zone);
+	uint64_t occupied = journal_get_occupied(&txn, stats->zone);
+	knot_lmdb_abort(&txn);
+	int ret = txn.ret;
+
+	if (ret == KNOT_EOK && has_zij) {
+		ret = skim_special(j, true, 0, stats, out);
+	} else if (ret == KNOT_EOK && (md.flags & JOURNAL_MERGED_SERIAL_VALID)) {
+		ret = skim_special(j, false, md.merged_serial, stats, out);
+	}
+
+	if (ret == KNOT_EOK && (md.flags & JOURNAL_SERIAL_TO_VALID) &&
+	    md.first_serial != md.serial_to) {
+		ret = skim_changesets(j, md.first_serial, stats, out);
+		fprintf(out, "Flushed up to:     serial %u\n", md.flushed_upto);
+	} else if (ret == KNOT_EOK) {
+		fprintf(out, "Changesets:        0\n");
+	}
+
+	if (ret == KNOT_EOK) {
+		fprintf(out, "Records:           -%zu +%zu\n", stats->removed, stats->added);
+		dynarray_foreach(type_stats, type_stats_t, i, stats->types) {
+			char type_str[32];
+			(void)knot_rrtype_to_string(i->type, type_str, sizeof(type_str));
+			fprintf(out, "  %-16s -%zu +%zu\n", type_str, i->removed, i->added);
+		}
+		fprintf(out, "Occupied (approx): %"PRIu64" KiB\n", occupied / 1024);
+	} else {
+		fprintf(out, "Failed to read journal (%s)\n", knot_strerror(ret));
+	}
+
+	fclose(out);
+	type_stats_dynarray_free(&stats->types);
+	stats->ret = ret;
+}
+
+typedef struct {
+	knot_lmdb_db_t *jdb;
+	zone_stats_t *zones;
+	size_t count;
+	size_t offset;
+	size_t step;
+} stats_job_t;
+
+static void *stats_job(void *arg)
+{
+	stats_job_t *job = arg;
+	for (size_t i = job->offset; i < job->count; i += job->step) {
+		zone_stats(job->jdb, &job->zones[i]);
+	}
+	return NULL;
+}
+
+static void run_stats_jobs(knot_lmdb_db_t *jdb, zone_stats_t *zones, size_t count,
+                           unsigned jobs)
+{
+	// Each thread processes every jobs-th zone.
+	if (jobs > count) {
+		jobs = MAX(count, 1);
+	}
+	stats_job_t job[jobs];
+	pthread_t threads[jobs];
+	bool spawned[jobs];
+	for (unsigned i = 0; i < jobs; i++) {
+		job[i] = (stats_job_t){ jdb, zones, count, i, jobs };
+		spawned[i] = (i > 0 && pthread_create(&threads[i], NULL, stats_job, &job[i]) == 0);
+	}
+	for (unsigned i = 0; i < jobs; i++) {
+		if (spawned[i]) {
+			pthread_join(threads[i], NULL);
+		} else {
+			(void)stats_job(&job[i]);
+		}
+	}
+}
+
+static int add_zone(const knot_dname_t *zone, void *ctx)
+{
+	list_t *zones = ctx;
+	knot_dname_t *copy = knot_dname_copy(zone, NULL);
+	if (copy == NULL || ptrlist_add(zones, copy, NULL) == NULL) {
+		free(copy);
+		return KNOT_ENOMEM;
+	}
+	return KNOT_EOK;
+}
+
+int print_stats(char *path, knot_dname_t *name, int jobs)
+{
+	knot_lmdb_db_t jdb = { 0 };
+	knot_lmdb_init(&jdb, path, 0, journal_env_flags(JOURNAL_MODE_ROBUST), NULL);
+	int ret = knot_lmdb_open(&jdb);
+	if (ret != KNOT_EOK) {
+		knot_lmdb_deinit(&jdb);
+		return ret;
+	}
+
+	list_t zones;
+	init_list(&zones);
+	if (name != NULL) {
+		zone_journal_t j = { &jdb, name };
+		if (!journal_is_existing(j)) {
+			fprintf(stderr, "This zone does not exist in DB %s\n", path);
+			knot_lmdb_deinit(&jdb);
+			return KNOT_ENOENT;
+		}
+		ret = add_zone(name, &zones);
+	} else {
+		ret = journals_walk(&jdb, add_zone, &zones);
+	}
+
+	size_t count = list_size(&zones);
+	zone_stats_t *stats = calloc(count, sizeof(*stats));
+	if (ret != KNOT_EOK || stats == NULL) {
+		ret = (ret == KNOT_EOK) ? KNOT_ENOMEM : ret;
+		goto finish;
+	}
+
+	size_t idx = 0;
+	ptrnode_t *n;
+	WALK_LIST(n, zones) {
+		stats[idx++].zone = n->d;
+	}
+
+	run_stats_jobs(&jdb, stats, count, jobs);
+
+	for (size_t i = 0; i < count; i++) {
+		if (stats[i].out != NULL) {
+			fwrite(stats[i].out, 1, stats[i].out_len, stdout);
+			free(stats[i].out);
+		}
+		if (stats[i].ret != KNOT_EOK && ret == KNOT_EOK) {
+			ret = stats[i].ret;
+		}
+	}
+
+finish:
+	free(stats);
+	WALK_LIST(n, zones) {
+		free(n->d);
+	}
+	ptrlist_free(&zones, NULL);
+	knot_lmdb_deinit(&jdb);
+
+	return ret;
+}
+
 static int list_zone(const knot_dname_t *zone, void *ctx)
 {
 	(void)ctx;
@@ -234,9 +545,33 @@ int list_zones(char *path)
 	return ret;
 }
 
+static int parse_serials(const char *arg, print_params_t *params)
+{
+	char *sep = strchr(arg, ':');
+	if (sep != NULL) {
+		char *from = strndup(arg, sep - arg);
+		if (from == NULL) {
+			return KNOT_ENOMEM;
+		}
+		int ret = str_to_u32(from, &params->from);
+		free(from);
+		if (ret != KNOT_EOK || str_to_u32(sep + 1, &params->to) != KNOT_EOK) {
+			return KNOT_EINVAL;
+		}
+		params->to_valid = true;
+	} else if (str_to_u32(arg, &params->from) != KNOT_EOK) {
+		return KNOT_EINVAL;
+	}
+	params->from_valid = true;
+
+	return KNOT_EOK;
+}
+
 int main(int argc, char *argv[])
 {
 	bool justlist = false;
+	bool stats = false;
+	int jobs = 1;
 
 	print_params_t params = {
 		.debug = false,
@@ -247,8 +582,11 @@ int main(int argc, char *argv[])
 
 	struct option opts[] = {
 		{ "limit",     required_argument, NULL, 'l' },
+		{ "serial",    required_argument, NULL, 'S' },
 		{ "no-color",  no_argument,       NULL, 'n' },
 		{ "zone-list", no_argument,       NULL, 'z' },
+		{ "stats",     no_argument,       NULL, 's' },
+		{ "jobs",      required_argument, NULL, 'j' },
 		{ "check",     no_argument,       NULL, 'c' },
 		{ "debug",     no_argument,       NULL, 'd' },
 		{ "help",      no_argument,       NULL, 'h' },
@@ -257,7 +595,7 @@ int main(int argc, char *argv[])
 	};
 
 	int opt = 0;
-	while ((opt = getopt_long(argc, argv, "l:nzcdhV", opts, NULL)) != -1) {
+	while ((opt = getopt_long(argc, argv, "l:S:nzsj:cdhV", opts, NULL)) != -1) {
 		switch (opt) {
 		case 'l':
 			if (str_to_int(optarg, &params.limit, 0, INT_MAX) != KNOT_EOK) {
@@ -265,9 +603,24 @@ int main(int argc, char *argv[])
 				return EXIT_FAILURE;
 			}
 			break;
+		case 'S':
+			if (parse_serials(optarg, &params) != KNOT_EOK) {
+				print_help();
+				return EXIT_FAILURE;
+			}
+			break;
 		case 'n':
 			params.color = false;
 			break;
+		case 's':
+			stats = true;
+			break;
+		case 'j':
+			if (str_to_int(optarg, &jobs, 1, UINT16_MAX) != KNOT_EOK) {
+				print_help();
+				return EXIT_FAILURE;
+			}
+			break;
 		case 'z':
 			justlist = true;
 			break;
@@ -327,6 +680,26 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	if (stats) {
+		int ret = print_stats(db, name, jobs);
+		bool named = (name != NULL);
+		free(name);
+		switch (ret) {
+		case KNOT_ENOENT:
+			if (named) {
+				// already reported by print_stats()
+				return EXIT_FAILURE;
+			}
+			printf("No zones in journal DB\n");
+			return EXIT_SUCCESS;
+		case KNOT_EOK:
+			return EXIT_SUCCESS;
+		default:
+			fprintf(stderr, "Failed to load statistics (%s)\n", knot_strerror(ret));
+			return EXIT_FAILURE;
+		}
+	}
+
 	if (name == NULL) {
 		fprintf(stderr, "Zone not specified\n");
 		return EXIT_FAILURE;
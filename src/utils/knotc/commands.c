@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "libknot/libknot.h"
 #include "knot/common/log.h"
@@ -25,6 +26,7 @@
 #include "knot/conf/confdb.h"
 #include "knot/zone/zonefile.h"
 #include "knot/zone/zone-load.h"
+#include "contrib/getline.h"
 #include "contrib/macros.h"
 #include "contrib/string.h"
 #include "contrib/strtonum.h"
@@ -52,6 +54,7 @@
 #define CMD_ZONE_THAW		"zone-thaw"
 
 #define CMD_ZONE_READ		"zone-read"
+#define CMD_ZONE_EXPORT		"zone-export"
 #define CMD_ZONE_BEGIN		"zone-begin"
 #define CMD_ZONE_COMMIT		"zone-commit"
 #define CMD_ZONE_ABORT		"zone-abort"
@@ -75,6 +78,8 @@
 #define CMD_CONF_GET		"conf-get"
 #define CMD_CONF_SET		"conf-set"
 #define CMD_CONF_UNSET		"conf-unset"
+#define CMD_CONF_ZONE_ADD	"conf-zone-add"
+#define CMD_CONF_ZONE_REMOVE	"conf-zone-remove"
 
 #define CTL_LOG_STR		"failed to control"
 
@@ -194,8 +199,29 @@ static int get_conf_key(const char *key, knot_ctl_data_t *data)
 	return KNOT_EOK;
 }
 
+static void format_frame(const char *zone, const char *frame, size_t frame_len)
+{
+	// Each frame is preceded by its zone name and length to separate the zones.
+	uint8_t header[KNOT_DNAME_MAXLEN + sizeof(uint16_t)];
+
+	if (zone == NULL || knot_dname_from_str(header, zone, KNOT_DNAME_MAXLEN) == NULL) {
+		log_error("invalid export frame zone");
+		return;
+	}
+	size_t header_len = knot_dname_size(header);
+
+	assert(frame_len <= UINT16_MAX);
+	knot_wire_write_u16(header + header_len, frame_len);
+	header_len += sizeof(uint16_t);
+
+	if (fwrite(header, 1, header_len, stdout) != header_len ||
+	    fwrite(frame, 1, frame_len, stdout) != frame_len) {
+		log_error("failed to write export frame");
+	}
+}
+
 static void format_data(ctl_cmd_t cmd, knot_ctl_type_t data_type,
-                        knot_ctl_data_t *data, bool *empty)
+                        knot_ctl_data_t *data, size_t value_len, bool *empty)
 {
 	const char *error = (*data)[KNOT_CTL_IDX_ERROR];
 	const char *flags = (*data)[KNOT_CTL_IDX_FLAGS];
@@ -235,6 +261,20 @@ static void format_data(ctl_cmd_t cmd, knot_ctl_type_t data_type,
 			printf("error: (%s)", error);
 		}
 		break;
+	case CTL_CONF_ZONE_ADD:
+	case CTL_CONF_ZONE_REMOVE:
+		if (error != NULL) {
+			printf("%serror: (%s)%s%s%s",
+			       (!(*empty)    ? "\n"  : ""),
+			       error,
+			       (zone != NULL ? " [" : ""),
+			       (zone != NULL ? zone : ""),
+			       (zone != NULL ? "]"  : ""));
+		} else if (value != NULL) {
+			printf("%s%s", (!(*empty) ? "\n" : ""), value);
+		}
+		*empty = false;
+		break;
 	case CTL_ZONE_STATUS:
 	case CTL_ZONE_RELOAD:
 	case CTL_ZONE_REFRESH:
@@ -316,6 +356,18 @@ static void format_data(ctl_cmd_t cmd, knot_ctl_type_t data_type,
 		       (value != NULL ? value      : ""));
 		*empty = false;
 		break;
+	case CTL_ZONE_EXPORT:
+		// Keep the binary output clean.
+		if (error != NULL) {
+			log_error("%s%s%s(%s)",
+			          (zone != NULL ? "[" : ""),
+			          (zone != NULL ? zone : ""),
+			          (zone != NULL ? "] " : ""),
+			          error);
+		} else if (value != NULL) {
+			format_frame(zone, value, value_len);
+		}
+		break;
 	case CTL_STATS:
 	case CTL_ZONE_STATS:
 		printf("%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s",
@@ -386,14 +438,19 @@ static void format_block(ctl_cmd_t cmd, bool failed, bool empty)
 	case CTL_CONF_GET:
 	case CTL_ZONE_STATS:
 	case CTL_STATS:
+	case CTL_CONF_ZONE_ADD:
+	case CTL_CONF_ZONE_REMOVE:
 		printf("%s", empty ? "" : "\n");
 		break;
+	case CTL_ZONE_EXPORT:
+		fflush(stdout);
+		break;
 	default:
 		assert(0);
 	}
 }
 
-static int ctl_receive(cmd_args_t *args)
+static int receive_reply(knot_ctl_t *ctl, ctl_cmd_t cmd)
 {
 	bool failed = false;
 	bool empty = true;
@@ -402,7 +459,7 @@ static int ctl_receive(cmd_args_t *args)
 		knot_ctl_type_t type;
 		knot_ctl_data_t data;
 
-		int ret = knot_ctl_receive(args->ctl, &type, &data);
+		int ret = knot_ctl_receive(ctl, &type, &data);
 		if (ret != KNOT_EOK) {
 			log_error(CTL_LOG_STR" (%s)", knot_strerror(ret));
 			return ret;
@@ -413,11 +470,12 @@ static int ctl_receive(cmd_args_t *args)
 			log_error(CTL_LOG_STR" (%s)", knot_strerror(KNOT_EMALF));
 			return KNOT_EMALF;
 		case KNOT_CTL_TYPE_BLOCK:
-			format_block(args->desc->cmd, failed, empty);
+			format_block(cmd, failed, empty);
 			return failed ? KNOT_ERROR : KNOT_EOK;
 		case KNOT_CTL_TYPE_DATA:
 		case KNOT_CTL_TYPE_EXTRA:
-			format_data(args->desc->cmd, type, &data, &empty);
+			format_data(cmd, type, &data,
+			            knot_ctl_data_len(ctl, KNOT_CTL_IDX_DATA), &empty);
 			break;
 		default:
 			assert(0);
@@ -432,6 +490,119 @@ static int ctl_receive(cmd_args_t *args)
 	return KNOT_EOK;
 }
 
+static int pipeline_receive(cmd_pipeline_t *pipeline)
+{
+	assert(pipeline->count > 0);
+
+	cmd_pending_t *pending = &pipeline->pending[pipeline->first];
+	pipeline->first = (pipeline->first + 1) % CMD_PIPELINE_WINDOW;
+	pipeline->count--;
+
+	// The replies can't be matched to the commands after an error.
+	if (pipeline->ret != KNOT_EOK) {
+		return pipeline->ret;
+	}
+
+	int ret = receive_reply(pending->ctl, pending->cmd);
+	switch (ret) {
+	case KNOT_EOK:
+		break;
+	case KNOT_ERROR:
+		pipeline->failed++;
+		break;
+	default:
+		pipeline->ret = ret;
+		return ret;
+	}
+
+	return KNOT_EOK;
+}
+
+int cmd_pipeline_init(cmd_pipeline_t *pipeline, knot_ctl_t **ctl, size_t ctl_count)
+{
+	if (pipeline == NULL || ctl == NULL || ctl_count == 0 ||
+	    ctl_count > CMD_PIPELINE_CONNS) {
+		return KNOT_EINVAL;
+	}
+
+	memset(pipeline, 0, sizeof(*pipeline));
+	memcpy(pipeline->ctl, ctl, ctl_count * sizeof(*ctl));
+	pipeline->ctl_count = ctl_count;
+
+	return KNOT_EOK;
+}
+
+knot_ctl_t *cmd_pipeline_ctl(cmd_pipeline_t *pipeline, ctl_cmd_t cmd)
+{
+	if (pipeline == NULL) {
+		return NULL;
+	}
+
+	// Don't reorder read-only commands with the other ones.
+	bool readonly = ctl_cmd_readonly(cmd);
+	if (pipeline->readonly != readonly) {
+		while (pipeline->count > 0) {
+			(void)pipeline_receive(pipeline);
+		}
+		pipeline->readonly = readonly;
+	}
+
+	if (pipeline->ret != KNOT_EOK) {
+		return NULL;
+	}
+
+	if (!readonly) {
+		return pipeline->ctl[0];
+	}
+
+	knot_ctl_t *ctl = pipeline->ctl[pipeline->ctl_next];
+	pipeline->ctl_next = (pipeline->ctl_next + 1) % pipeline->ctl_count;
+
+	return ctl;
+}
+
+int cmd_pipeline_finish(cmd_pipeline_t *pipeline)
+{
+	if (pipeline == NULL) {
+		return KNOT_EINVAL;
+	}
+
+	while (pipeline->count > 0) {
+		(void)pipeline_receive(pipeline);
+	}
+
+	if (pipeline->ret != KNOT_EOK) {
+		return pipeline->ret;
+	}
+
+	return (pipeline->failed > 0) ? KNOT_ERROR : KNOT_EOK;
+}
+
+static int ctl_receive(cmd_args_t *args)
+{
+	cmd_pipeline_t *pipeline = args->pipeline;
+	if (pipeline == NULL) {
+		return receive_reply(args->ctl, args->desc->cmd);
+	}
+
+	// Receive the oldest reply if the window is full.
+	if (pipeline->count == CMD_PIPELINE_WINDOW) {
+		int ret = pipeline_receive(pipeline);
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+	}
+
+	size_t last = (pipeline->first + pipeline->count) % CMD_PIPELINE_WINDOW;
+	pipeline->pending[last] = (cmd_pending_t) {
+		.cmd = args->desc->cmd,
+		.ctl = args->ctl
+	};
+	pipeline->count++;
+
+	return pipeline->ret;
+}
+
 static int cmd_ctl(cmd_args_t *args)
 {
 	int ret = check_args(args, 0, (args->desc->cmd == CTL_STATUS ? 1 : 0));
@@ -772,6 +943,7 @@ static int set_node_items(cmd_args_t *args, knot_ctl_data_t *data, char *rdata,
 	int min_args, max_args;
 	switch (args->desc->cmd) {
 	case CTL_ZONE_READ:
+	case CTL_ZONE_EXPORT:
 	case CTL_ZONE_GET:   min_args = 1; max_args =  3; break;
 	case CTL_ZONE_DIFF:  min_args = 1; max_args =  1; break;
 	case CTL_ZONE_SET:   min_args = 3; max_args = -1; break;
@@ -847,6 +1019,11 @@ static int cmd_zone_node_ctl(cmd_args_t *args)
 
 	char rdata[65536]; // Maximum item size in libknot control interface.
 
+	if (args->desc->cmd == CTL_ZONE_EXPORT && isatty(STDOUT_FILENO)) {
+		log_error("refusing to write binary data to a terminal");
+		return KNOT_EINVAL;
+	}
+
 	int ret = set_node_items(args, &data, rdata, sizeof(rdata));
 	if (ret != KNOT_EOK) {
 		return ret;
@@ -1001,6 +1178,70 @@ static int cmd_conf_ctl(cmd_args_t *args)
 	return ctl_receive(args);
 }
 
+static int cmd_conf_zone_ctl(cmd_args_t *args)
+{
+	knot_ctl_data_t data = {
+		[KNOT_CTL_IDX_CMD] = ctl_cmd_to_str(args->desc->cmd),
+		[KNOT_CTL_IDX_FLAGS] = args->flags,
+	};
+
+	int ret;
+
+	// Send the zones from the arguments.
+	if (args->argc > 0) {
+		for (int i = 0; i < args->argc; i++) {
+			data[KNOT_CTL_IDX_ZONE] = args->argv[i];
+
+			CTL_SEND_DATA
+		}
+
+		CTL_SEND_BLOCK
+
+		return ctl_receive(args);
+	}
+
+	// The standard input is used for the pipelined commands.
+	if (args->pipeline != NULL) {
+		log_error("no zone specified");
+		return KNOT_EINVAL;
+	}
+
+	// Stream the zones from the standard input, '<zone> [<template>]' per line.
+	char *line = NULL;
+	size_t line_len = 0;
+	size_t count = 0;
+	while (knot_getline(&line, &line_len, stdin) != -1) {
+		char *save = NULL;
+		char *zone = strtok_r(line, " \t\r\n", &save);
+		if (zone == NULL) {
+			continue;
+		}
+		char *tpl = strtok_r(NULL, " \t\r\n", &save);
+
+		data[KNOT_CTL_IDX_ZONE] = zone;
+		data[KNOT_CTL_IDX_DATA] = (args->desc->cmd == CTL_CONF_ZONE_ADD) ?
+		                          tpl : NULL;
+
+		ret = knot_ctl_send(args->ctl, KNOT_CTL_TYPE_DATA, &data);
+		if (ret != KNOT_EOK) {
+			log_error(CTL_LOG_STR" (%s)", knot_strerror(ret));
+			free(line);
+			return ret;
+		}
+		count++;
+	}
+	free(line);
+
+	if (count == 0) {
+		log_error("no zone specified");
+		return KNOT_EINVAL;
+	}
+
+	CTL_SEND_BLOCK
+
+	return ctl_receive(args);
+}
+
 const cmd_desc_t cmd_table[] = {
 	{ CMD_EXIT,            NULL,              CTL_NONE },
 
@@ -1023,6 +1264,7 @@ const cmd_desc_t cmd_table[] = {
 	{ CMD_ZONE_THAW,       cmd_zone_ctl,          CTL_ZONE_THAW,       CMD_FOPT_ZONE },
 
 	{ CMD_ZONE_READ,       cmd_zone_node_ctl,   CTL_ZONE_READ,       CMD_FREQ_ZONE },
+	{ CMD_ZONE_EXPORT,     cmd_zone_node_ctl,   CTL_ZONE_EXPORT,     CMD_FREQ_ZONE },
 	{ CMD_ZONE_BEGIN,      cmd_zone_ctl,        CTL_ZONE_BEGIN,      CMD_FREQ_ZONE | CMD_FOPT_ZONE },
 	{ CMD_ZONE_COMMIT,     cmd_zone_ctl,        CTL_ZONE_COMMIT,     CMD_FREQ_ZONE | CMD_FOPT_ZONE },
 	{ CMD_ZONE_ABORT,      cmd_zone_ctl,        CTL_ZONE_ABORT,      CMD_FREQ_ZONE | CMD_FOPT_ZONE },
@@ -1046,6 +1288,8 @@ const cmd_desc_t cmd_table[] = {
 	{ CMD_CONF_GET,        cmd_conf_ctl,      CTL_CONF_GET,        CMD_FOPT_ITEM | CMD_FREQ_TXN },
 	{ CMD_CONF_SET,        cmd_conf_ctl,      CTL_CONF_SET,        CMD_FREQ_ITEM | CMD_FOPT_DATA | CMD_FREQ_TXN },
 	{ CMD_CONF_UNSET,      cmd_conf_ctl,      CTL_CONF_UNSET,      CMD_FOPT_ITEM | CMD_FOPT_DATA | CMD_FREQ_TXN },
+	{ CMD_CONF_ZONE_ADD,   cmd_conf_zone_ctl, CTL_CONF_ZONE_ADD },
+	{ CMD_CONF_ZONE_REMOVE, cmd_conf_zone_ctl, CTL_CONF_ZONE_REMOVE },
 	{ NULL }
 };
 
@@ -1070,6 +1314,7 @@ static const cmd_help_t cmd_help_table[] = {
 	{ CMD_ZONE_THAW,       "[<zone>...]",                            "Dismiss zone freeze. (#)" },
 	{ "",                  "",                                       "" },
 	{ CMD_ZONE_READ,       "<zone> [<owner> [<type>]]",              "Get zone data that are currently being presented." },
+	{ CMD_ZONE_EXPORT,     "<zone> [<owner> [<type>]]",              "Write the zone data in the wire format to stdout." },
 	{ CMD_ZONE_BEGIN,      "<zone>...",                              "Begin a zone transaction." },
 	{ CMD_ZONE_COMMIT,     "<zone>...",                              "Commit the zone transaction." },
 	{ CMD_ZONE_ABORT,      "<zone>...",                              "Abort the zone transaction." },
@@ -1094,6 +1339,8 @@ static const cmd_help_t cmd_help_table[] = {
 	{ CMD_CONF_GET,        "[<item>...]",                            "Get the item data within the transaction." },
 	{ CMD_CONF_SET,        " <item>  [<data>...]",                   "Set the item data within the transaction." },
 	{ CMD_CONF_UNSET,      "[<item>] [<data>...]",                   "Unset the item data within the transaction." },
+	{ CMD_CONF_ZONE_ADD,   "[<zone>...]",                            "Add zones to the confdb in one batch. (+)" },
+	{ CMD_CONF_ZONE_REMOVE, "[<zone>...]",                           "Remove zones from the confdb in one batch. (+)" },
 	{ NULL }
 };
 
@@ -1112,5 +1359,6 @@ void print_commands(void)
 	       " Type <item> parameter in the form of <section>[<identifier>].<name>.\n"
 	       " (*) indicates a local operation which requires a configuration.\n"
 	       " (#) indicates an optionally blocking operation.\n"
+	       " (+) indicates reading of '<zone> [<template>]' lines from stdin if no <zone>.\n"
 	       " The '-b' and '-f' options can be placed right after the command name.\n");
 }
@@ -37,6 +37,31 @@ typedef enum {
 struct cmd_desc;
 typedef struct cmd_desc cmd_desc_t;
 
+/*! \brief Maximum number of pipelined commands awaiting a reply. */
+#define CMD_PIPELINE_WINDOW	64
+
+/*! \brief Number of control connections for the pipelined commands. */
+#define CMD_PIPELINE_CONNS	4
+
+/*! \brief Pipelined command awaiting a reply. */
+typedef struct {
+	ctl_cmd_t cmd;   /*!< Sent command. */
+	knot_ctl_t *ctl; /*!< Control context the command was sent over. */
+} cmd_pending_t;
+
+/*! \brief Pipelined commands context. */
+typedef struct {
+	knot_ctl_t *ctl[CMD_PIPELINE_CONNS];        /*!< Control contexts. */
+	size_t ctl_count;                           /*!< Number of control contexts. */
+	size_t ctl_next;                            /*!< Next context for a read-only command. */
+	cmd_pending_t pending[CMD_PIPELINE_WINDOW]; /*!< Sent commands awaiting a reply. */
+	size_t first;                               /*!< Index of the oldest pending command. */
+	size_t count;                               /*!< Number of pending commands. */
+	bool readonly;                              /*!< Pending commands are read-only. */
+	size_t failed;                              /*!< Number of failed commands. */
+	int ret;                                    /*!< Control error code. */
+} cmd_pipeline_t;
+
 /*! \brief Command callback arguments. */
 typedef struct {
 	const cmd_desc_t *desc;
@@ -46,6 +71,7 @@ typedef struct {
 	char flags[4];
 	bool force;
 	bool blocking;
+	cmd_pipeline_t *pipeline;
 } cmd_args_t;
 
 /*! \brief Command callback description. */
@@ -66,5 +92,47 @@ typedef struct {
 /*! \brief Table of commands. */
 extern const cmd_desc_t cmd_table[];
 
+/*!
+ * Initializes the context for pipelined commands.
+ *
+ * Commands executed with the pipeline set in their arguments only send
+ * the request. Their replies are received and printed in the order the
+ * commands were sent, once CMD_PIPELINE_WINDOW commands await a reply or
+ * when the pipeline is finished. The bounded window keeps the unread replies
+ * from filling the socket buffers, so the sender and the server can't block
+ * each other.
+ *
+ * \param[in] pipeline   Pipeline context.
+ * \param[in] ctl        Connected control contexts.
+ * \param[in] ctl_count  Number of control contexts (at most CMD_PIPELINE_CONNS).
+ *
+ * \return Error code, KNOT_EOK if successful.
+ */
+int cmd_pipeline_init(cmd_pipeline_t *pipeline, knot_ctl_t **ctl, size_t ctl_count);
+
+/*!
+ * Selects the control context for the next pipelined command.
+ *
+ * Read-only commands are spread over all contexts, so the server can
+ * execute them in parallel. Other commands are sent over the first one.
+ * The pending commands are received first if their kind differs, so that
+ * no command is reordered with a command which can change the server state.
+ *
+ * \param[in] pipeline  Pipeline context.
+ * \param[in] cmd       Command to be sent.
+ *
+ * \return Control context or NULL if the pipeline failed.
+ */
+knot_ctl_t *cmd_pipeline_ctl(cmd_pipeline_t *pipeline, ctl_cmd_t cmd);
+
+/*!
+ * Receives the replies to all pending commands.
+ *
+ * \param[in] pipeline  Pipeline context.
+ *
+ * \return Error code, KNOT_EOK if all pipelined commands succeeded.
+ */
+int cmd_pipeline_finish(cmd_pipeline_t *pipeline);
+
 /*! \brief Prints commands help. */
 void print_commands(void);
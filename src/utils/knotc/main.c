@@ -44,6 +44,7 @@ static void print_help(void)
 	       " -t, --timeout <sec>      "SPACE"Use a control socket timeout (max 7200 seconds).\n"
 	       "                          "SPACE" (default %u seconds)\n"
 	       " -b, --blocking	          "SPACE"Zone event trigger commands wait until the event is finished.\n"
+	       " -p, --pipeline           "SPACE"Pipeline control commands read from the standard input.\n"
 	       " -f, --force              "SPACE"Forced operation. Overrides some checks.\n"
 	       " -v, --verbose            "SPACE"Enable debug output.\n"
 	       " -h, --help               "SPACE"Print the program help.\n"
@@ -69,6 +70,7 @@ int main(int argc, char **argv)
 		{ "socket",        required_argument, NULL, 's' },
 		{ "timeout",       required_argument, NULL, 't' },
 		{ "blocking",      no_argument,       NULL, 'b' },
+		{ "pipeline",      no_argument,       NULL, 'p' },
 		{ "force",         no_argument,       NULL, 'f' },
 		{ "verbose",       no_argument,       NULL, 'v' },
 		{ "help",          no_argument,       NULL, 'h' },
@@ -78,7 +80,7 @@ int main(int argc, char **argv)
 
 	/* Parse command line arguments */
 	int opt = 0;
-	while ((opt = getopt_long(argc, argv, "+c:C:m:s:t:bfvhV", opts, NULL)) != -1) {
+	while ((opt = getopt_long(argc, argv, "+c:C:m:s:t:bpfvhV", opts, NULL)) != -1) {
 		switch (opt) {
 		case 'c':
 			params.config = optarg;
@@ -108,6 +110,9 @@ int main(int argc, char **argv)
 		case 'b':
 			params.blocking = true;
 			break;
+		case 'p':
+			params.pipeline = true;
+			break;
 		case 'f':
 			params.force = true;
 			break;
@@ -138,7 +143,14 @@ int main(int argc, char **argv)
 	}
 
 	int ret;
-	if (argc - optind < 1) {
+	if (params.pipeline) {
+		if (argc - optind > 0) {
+			print_help();
+			log_close();
+			return EXIT_FAILURE;
+		}
+		ret = process_pipeline(stdin, &params);
+	} else if (argc - optind < 1) {
 		ret = interactive_loop(&params);
 	} else {
 		ret = process_cmd(argc - optind, (const char **)argv + optind, &params);
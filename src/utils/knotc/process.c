@@ -14,9 +14,12 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <assert.h>
+#include <histedit.h>
 #include <stddef.h>
 #include <sys/stat.h>
 
+#include "contrib/getline.h"
 #include "contrib/openbsd/strlcat.h"
 #include "knot/conf/conf.h"
 #include "knot/common/log.h"
@@ -57,6 +60,41 @@ static bool get_cmd_blocking_flag(const char *arg)
 	return false;
 }
 
+static void set_args(cmd_args_t *args, const cmd_desc_t *desc, int argc,
+                     const char **argv, params_t *params)
+{
+	*args = (cmd_args_t) {
+		.desc = desc,
+		.argc = argc - 1,
+		.argv = argv + 1,
+		.force = params->force,
+		.blocking = params->blocking
+	};
+
+	/* Check for special flags after command. */
+	while (args->argc > 0) {
+		if (get_cmd_force_flag(args->argv[0])) {
+			args->force = true;
+			args->argc--;
+			args->argv++;
+		} else if (get_cmd_blocking_flag(args->argv[0])) {
+			args->blocking = true;
+			args->argc--;
+			args->argv++;
+		} else {
+			break;
+		}
+	}
+
+	/* Prepare flags parameter. */
+	if (args->force) {
+		strlcat(args->flags, CTL_FLAG_FORCE, sizeof(args->flags));
+	}
+	if (args->blocking) {
+		strlcat(args->flags, CTL_FLAG_BLOCKING, sizeof(args->flags));
+	}
+}
+
 int set_config(const cmd_desc_t *desc, params_t *params)
 {
 	if (params->config != NULL && params->confdb != NULL) {
@@ -231,36 +269,8 @@ int process_cmd(int argc, const char **argv, params_t *params)
 	}
 
 	/* Prepare command parameters. */
-	cmd_args_t args = {
-		.desc = desc,
-		.argc = argc - 1,
-		.argv = argv + 1,
-		.force = params->force,
-		.blocking = params->blocking
-	};
-
-	/* Check for special flags after command. */
-	while (args.argc > 0) {
-		if (get_cmd_force_flag(args.argv[0])) {
-			args.force = true;
-			args.argc--;
-			args.argv++;
-		} else if (get_cmd_blocking_flag(args.argv[0])) {
-			args.blocking = true;
-			args.argc--;
-			args.argv++;
-		} else {
-			break;
-		}
-	}
-
-	/* Prepare flags parameter. */
-	if (args.force) {
-		strlcat(args.flags, CTL_FLAG_FORCE, sizeof(args.flags));
-	}
-	if (args.blocking) {
-		strlcat(args.flags, CTL_FLAG_BLOCKING, sizeof(args.flags));
-	}
+	cmd_args_t args;
+	set_args(&args, desc, argc, argv, params);
 
 	/* Set control interface if necessary. */
 	ret = set_ctl(&args.ctl, desc, params);
@@ -278,3 +288,118 @@ int process_cmd(int argc, const char **argv, params_t *params)
 
 	return ret;
 }
+
+int process_pipeline(FILE *in, params_t *params)
+{
+	/* Only the control commands can be pipelined. */
+	const cmd_desc_t *ctl_desc = get_cmd_desc("status");
+	assert(ctl_desc != NULL);
+
+	/* Set up the configuration and the control interface. */
+	int ret = set_config(ctl_desc, params);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	/* More connections let the server execute read-only commands in parallel. */
+	knot_ctl_t *ctl[CMD_PIPELINE_CONNS] = { NULL };
+	for (size_t i = 0; i < CMD_PIPELINE_CONNS; i++) {
+		ret = set_ctl(&ctl[i], ctl_desc, params);
+		if (ret != KNOT_EOK) {
+			for (size_t j = 0; j < i; j++) {
+				unset_ctl(ctl[j]);
+			}
+			conf_update(NULL, CONF_UPD_FNONE);
+			return ret;
+		}
+	}
+
+	cmd_pipeline_t pipeline;
+	ret = cmd_pipeline_init(&pipeline, ctl, CMD_PIPELINE_CONNS);
+	if (ret != KNOT_EOK) {
+		log_error("failed to initialize pipeline (%s)", knot_strerror(ret));
+		for (size_t i = 0; i < CMD_PIPELINE_CONNS; i++) {
+			unset_ctl(ctl[i]);
+		}
+		conf_update(NULL, CONF_UPD_FNONE);
+		return ret;
+	}
+
+	Tokenizer *tok = tok_init(NULL);
+
+	/* Send the commands without waiting for each reply. */
+	size_t failed = 0;
+	char *line = NULL;
+	size_t line_len = 0;
+	while (knot_getline(&line, &line_len, in) != -1) {
+		int argc;
+		const char **argv;
+		if (tok_str(tok, line, &argc, &argv) != 0 || argc == 0) {
+			tok_reset(tok);
+			continue;
+		}
+
+		const cmd_desc_t *desc = get_cmd_desc(argv[0]);
+		if (desc == NULL) {
+			failed++;
+			tok_reset(tok);
+			continue;
+		}
+
+		/* Check for exit. */
+		if (desc->fcn == NULL) {
+			tok_reset(tok);
+			break;
+		}
+
+		if (desc->flags & (CMD_FREAD | CMD_FWRITE)) {
+			log_error("command '%s' not supported in pipelined mode",
+			          desc->name);
+			failed++;
+			tok_reset(tok);
+			continue;
+		}
+
+		cmd_args_t args;
+		set_args(&args, desc, argc, argv, params);
+		args.ctl = cmd_pipeline_ctl(&pipeline, desc->cmd);
+		args.pipeline = &pipeline;
+		if (args.ctl == NULL) {
+			tok_reset(tok);
+			break;
+		}
+
+		ret = desc->fcn(&args);
+		tok_reset(tok);
+		if (ret == KNOT_ECONN || ret == KNOT_ECONNREFUSED ||
+		    pipeline.ret != KNOT_EOK) {
+			break;
+		} else if (ret != KNOT_EOK) {
+			failed++;
+		}
+	}
+	free(line);
+	tok_end(tok);
+
+	/* Finish the controls, the server replies to all pending commands. */
+	for (size_t i = 0; i < CMD_PIPELINE_CONNS; i++) {
+		ret = knot_ctl_send(ctl[i], KNOT_CTL_TYPE_END, NULL);
+		if (ret != KNOT_EOK && ret != KNOT_ECONN) {
+			log_error("failed to finish control (%s)", knot_strerror(ret));
+		}
+	}
+
+	ret = cmd_pipeline_finish(&pipeline);
+
+	for (size_t i = 0; i < CMD_PIPELINE_CONNS; i++) {
+		knot_ctl_close(ctl[i]);
+		knot_ctl_free(ctl[i]);
+	}
+	conf_update(NULL, CONF_UPD_FNONE);
+
+	if (ret == KNOT_EOK && failed > 0) {
+		ret = KNOT_ERROR;
+	}
+
+	return ret;
+}
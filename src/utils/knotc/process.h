@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <stdio.h>
+
 #include "utils/knotc/commands.h"
 
 /*! Utility command line parameters. */
@@ -27,6 +29,7 @@ typedef struct {
 	bool verbose;
 	bool force;
 	bool blocking;
+	bool pipeline;
 	int timeout;
 } params_t;
 
@@ -68,3 +71,17 @@ void unset_ctl(knot_ctl_t *ctl);
  * \return Error code, KNOT_EOK if successful.
  */
 int process_cmd(int argc, const char **argv, params_t *params);
+
+/*!
+ * Processes utility commands read from the input, one command per line.
+ *
+ * The control commands are sent over one control connection without
+ * waiting for the previous replies, which are printed in the order of
+ * the commands as they are received.
+ *
+ * \param[in] in      Input with the commands.
+ * \param[in] params  Utility parameters.
+ *
+ * \return Error code, KNOT_EOK if successful.
+ */
+int process_pipeline(FILE *in, params_t *params);
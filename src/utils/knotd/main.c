@@ -22,6 +22,8 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <pthread.h>
+#include <signal.h>
 #include <sys/stat.h>
 #include <urcu.h>
 
@@ -45,9 +47,14 @@
 #include "knot/common/stats.h"
 #include "knot/server/server.h"
 #include "knot/server/tcp-handler.h"
+#include "knot/worker/pool.h"
 
 #define PROGRAM_NAME "knotd"
 
+/* Number of control workers. A worker is held by a connection until it's
+ * closed, so the count bounds the concurrent connections, not the CPU usage. */
+#define CTL_WORKERS 32
+
 /* Signal flags. */
 static volatile bool sig_req_stop = false;
 static volatile bool sig_req_reload = false;
@@ -127,7 +134,7 @@ static const struct signal SIGNALS[] = {
 	{ SIGHUP,  true  },  /* Reload server. */
 	{ SIGINT,  true  },  /* Terminate server. */
 	{ SIGTERM, true  },  /* Terminate server. */
-	{ SIGALRM, false },  /* Internal thread synchronization. */
+	{ SIGALRM, true  },  /* Internal thread synchronization. */
 	{ SIGPIPE, false },  /* Ignored. Some I/O errors. */
 	{ 0 }
 };
@@ -208,6 +215,30 @@ static void drop_capabilities(void)
 #endif /* ENABLE_CAP_NG */
 }
 
+/*! \brief Control connection processed by a control worker. */
+typedef struct {
+	task_t task;
+	knot_ctl_t *ctl;
+	server_t *server;
+	pthread_t event_loop;
+} ctl_conn_t;
+
+/*! \brief Process commands from one control connection. */
+static void ctl_conn_run(task_t *task)
+{
+	ctl_conn_t *conn = task->ctx;
+
+	int ret = ctl_process(conn->ctl, conn->server);
+	if (ret == KNOT_CTL_ESTOP) {
+		/* Interrupt the event loop waiting for a connection. */
+		sig_req_stop = true;
+		pthread_kill(conn->event_loop, SIGALRM);
+	}
+
+	knot_ctl_free(conn->ctl);
+	free(conn);
+}
+
 /*! \brief Event loop listening for signals and remote commands. */
 static void event_loop(server_t *server, const char *socket)
 {
@@ -218,9 +249,6 @@ static void event_loop(server_t *server, const char *socket)
 		return;
 	}
 
-	// Set control timeout.
-	knot_ctl_set_timeout(ctl, conf()->cache.ctl_timeout);
-
 	/* Get control socket configuration. */
 	char *listen;
 	if (socket == NULL) {
@@ -251,6 +279,17 @@ static void event_loop(server_t *server, const char *socket)
 	}
 	free(listen);
 
+	/* Control workers, one connection per worker at a time. */
+	worker_pool_t *ctl_workers = worker_pool_create(CTL_WORKERS);
+	if (ctl_workers == NULL) {
+		knot_ctl_unbind(ctl);
+		knot_ctl_free(ctl);
+		log_fatal("control, failed to initialize (%s)",
+		          knot_strerror(KNOT_ENOMEM));
+		return;
+	}
+	worker_pool_start(ctl_workers);
+
 	enable_signals();
 
 	/* Run event loop. */
@@ -261,24 +300,42 @@ static void event_loop(server_t *server, const char *socket)
 		}
 		if (sig_req_reload) {
 			sig_req_reload = false;
+			ctl_lock(true);
 			server_reload(server);
+			ctl_unlock();
 		}
 
-		// Update control timeout.
-		knot_ctl_set_timeout(ctl, conf()->cache.ctl_timeout);
+		ctl_conn_t *conn = calloc(1, sizeof(*conn));
+		if (conn == NULL || (conn->ctl = knot_ctl_alloc()) == NULL) {
+			log_error("control, failed to accept (%s)",
+			          knot_strerror(KNOT_ENOMEM));
+			free(conn);
+			break;
+		}
+
+		// Set control timeout.
+		knot_ctl_set_timeout(conn->ctl, conf()->cache.ctl_timeout);
 
-		ret = knot_ctl_accept(ctl);
+		ret = knot_ctl_accept_to(ctl, conn->ctl);
 		if (ret != KNOT_EOK) {
+			knot_ctl_free(conn->ctl);
+			free(conn);
 			continue;
 		}
 
-		ret = ctl_process(ctl, server);
-		knot_ctl_close(ctl);
-		if (ret == KNOT_CTL_ESTOP) {
-			break;
-		}
+		conn->server = server;
+		conn->event_loop = pthread_self();
+		conn->task.ctx = conn;
+		conn->task.run = ctl_conn_run;
+		worker_pool_assign(ctl_workers, &conn->task);
 	}
 
+	/* Finish the accepted connections. */
+	worker_pool_wait(ctl_workers);
+	worker_pool_stop(ctl_workers);
+	worker_pool_join(ctl_workers);
+	worker_pool_destroy(ctl_workers);
+
 	/* Unbind the control socket. */
 	knot_ctl_unbind(ctl);
 	knot_ctl_free(ctl);
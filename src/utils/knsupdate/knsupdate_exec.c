@@ -35,6 +35,7 @@
 #include "contrib/macros.h"
 #include "contrib/string.h"
 #include "contrib/strtonum.h"
+#include "contrib/time.h"
 #include "contrib/openbsd/strlcpy.h"
 
 /* Declarations of cmd parse functions. */
@@ -474,6 +475,248 @@ static int pkt_sendrecv(knsupdate_params_t *params)
 	return rb;
 }
 
+/*! \brief Open the persistent connection of the pipelined mode. */
+static int pipe_connect(knsupdate_params_t *params)
+{
+	pipe_ctx_t *pipe = params->pipe;
+
+	int ret = net_init(params->srcif,
+	                   params->server,
+	                   get_iptype(params->ip),
+	                   get_socktype(PROTO_TCP, KNOT_RRTYPE_SOA),
+	                   params->wait,
+	                   NET_FLAGS_NONE,
+	                   NULL,
+	                   &pipe->net);
+	if (ret != KNOT_EOK) {
+		return ret;
+	}
+
+	ret = net_connect(&pipe->net);
+	DBG("%s: pipe_connect = %d\n", __func__, pipe->net.sockfd);
+	if (ret != KNOT_EOK) {
+		net_clean(&pipe->net);
+		return ret;
+	}
+
+	pipe->connected = true;
+
+	return KNOT_EOK;
+}
+
+/*! \brief Close the pipelined connection, all updates in flight are failed. */
+static void pipe_disconnect(knsupdate_params_t *params)
+{
+	pipe_ctx_t *pipe = params->pipe;
+
+	for (size_t i = 0; i < params->pipeline; i++) {
+		pipe_slot_t *slot = &pipe->slots[i];
+		if (slot->used) {
+			sign_context_deinit(&slot->sign_ctx);
+			slot->used = false;
+			pipe->failed++;
+		}
+	}
+	pipe->inflight = 0;
+
+	if (pipe->connected) {
+		net_close(&pipe->net);
+		net_clean(&pipe->net);
+		pipe->connected = false;
+	}
+}
+
+/*! \brief Receive and process one reply in the pipelined mode. */
+static int pipe_receive(knsupdate_params_t *params)
+{
+	pipe_ctx_t *pipe = params->pipe;
+	knot_pkt_t *answer = params->answer;
+
+	knot_pkt_clear(answer);
+
+	int rb = net_receive(&pipe->net, answer->wire, answer->max_size);
+	if (rb <= 0) {
+		ERR("connection lost, %zu updates failed\n", pipe->inflight);
+		pipe_disconnect(params);
+		return KNOT_ECONNREFUSED;
+	}
+	answer->size = rb;
+
+	struct timespec now = time_now();
+
+	if (rb < KNOT_WIRE_HEADER_SIZE) {
+		WARN("malformed reply\n");
+		return KNOT_EOK;
+	}
+
+	/* Match the reply with the update in flight. */
+	uint16_t idx = knot_wire_get_id(answer->wire) - pipe->id_base;
+	if (idx >= params->pipeline || !pipe->slots[idx].used) {
+		WARN("unexpected reply ID %u\n", knot_wire_get_id(answer->wire));
+		return KNOT_EOK;
+	}
+	pipe_slot_t *slot = &pipe->slots[idx];
+	slot->used = false;
+	pipe->inflight--;
+
+	int ret = knot_pkt_parse(answer, 0);
+	if (ret != KNOT_EOK) {
+		ERR("failed to parse response (%s)\n", knot_strerror(ret));
+	} else if (params->tsig_key.name) {
+		ret = verify_packet(answer, &slot->sign_ctx);
+		if (ret != KNOT_EOK) {
+			print_packet(answer, NULL, 0, -1, 0, true, &params->style);
+			ERR("reply verification (%s)\n", knot_strerror(ret));
+		}
+	}
+	sign_context_deinit(&slot->sign_ctx);
+
+	if (ret == KNOT_EOK && knot_pkt_ext_rcode(answer) != KNOT_RCODE_NOERROR) {
+		print_packet(answer, NULL, 0, -1, 0, true, &params->style);
+		ERR("update failed with error '%s'\n",
+		    knot_pkt_ext_rcode_name(answer));
+		ret = KNOT_ERROR;
+	}
+
+	if (ret != KNOT_EOK) {
+		pipe->failed++;
+		return KNOT_EOK;
+	}
+
+	double latency = time_diff_ms(&slot->sent, &now) * 1000;
+	DBG("update %u success in %.0f us\n", knot_wire_get_id(answer->wire), latency);
+
+	if (pipe->succeeded == 0 || latency < pipe->lat_min) {
+		pipe->lat_min = latency;
+	}
+	if (latency > pipe->lat_max) {
+		pipe->lat_max = latency;
+	}
+	pipe->lat_sum += latency;
+	pipe->succeeded++;
+
+	return KNOT_EOK;
+}
+
+/*! \brief Connect if needed and wait for a free slot. Returns the slot index. */
+static int pipe_reserve(knsupdate_params_t *params)
+{
+	pipe_ctx_t *pipe = params->pipe;
+
+	if (!pipe->connected) {
+		int ret = pipe_connect(params);
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+	}
+
+	while (pipe->inflight >= params->pipeline) {
+		int ret = pipe_receive(params);
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+	}
+
+	for (int i = 0; i < params->pipeline; i++) {
+		if (!pipe->slots[i].used) {
+			return i;
+		}
+	}
+
+	assert(0);
+	return KNOT_ERROR;
+}
+
+/*! \brief Send the signed update without waiting for the reply. */
+static int pipe_send(knsupdate_params_t *params, int idx, sign_context_t *sign_ctx)
+{
+	pipe_ctx_t *pipe = params->pipe;
+	pipe_slot_t *slot = &pipe->slots[idx];
+
+	if (pipe->sent == 0) {
+		pipe->begin = time_now();
+	}
+
+	slot->sent = time_now();
+	int ret = net_send(&pipe->net, params->query->wire, params->query->size);
+	if (ret != KNOT_EOK) {
+		sign_context_deinit(sign_ctx);
+		pipe->failed++;
+		pipe_disconnect(params);
+		return ret;
+	}
+
+	/* The slot takes over the signing context. */
+	slot->sign_ctx = *sign_ctx;
+	slot->used = true;
+	pipe->inflight++;
+	pipe->sent++;
+
+	return KNOT_EOK;
+}
+
+/*! \brief Wait for all updates in flight and close the connection. */
+static int pipe_flush(knsupdate_params_t *params)
+{
+	pipe_ctx_t *pipe = params->pipe;
+
+	while (pipe->inflight > 0) {
+		int ret = pipe_receive(params);
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+	}
+
+	pipe_disconnect(params);
+
+	return KNOT_EOK;
+}
+
+static int pipe_init(knsupdate_params_t *params)
+{
+	params->pipe = calloc(1, sizeof(*params->pipe));
+	if (params->pipe == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	params->pipe->slots = calloc(params->pipeline, sizeof(pipe_slot_t));
+	if (params->pipe->slots == NULL) {
+		free(params->pipe);
+		params->pipe = NULL;
+		return KNOT_ENOMEM;
+	}
+
+	params->pipe->id_base = dnssec_random_uint16_t();
+
+	return KNOT_EOK;
+}
+
+static void pipe_deinit(knsupdate_params_t *params)
+{
+	pipe_ctx_t *pipe = params->pipe;
+
+	pipe_disconnect(params);
+
+	struct timespec end = time_now();
+	double elapsed = pipe->sent > 0 ? time_diff_ms(&pipe->begin, &end) / 1000 : 0;
+
+	printf(";; Pipeline: sent %zu, succeeded %zu, failed %zu in %.3f s",
+	       pipe->sent, pipe->succeeded, pipe->failed, elapsed);
+	if (elapsed > 0) {
+		printf(" (%.0f updates/s)", pipe->succeeded / elapsed);
+	}
+	printf("\n");
+	if (pipe->succeeded > 0) {
+		printf(";; Latency: min %.0f us, avg %.0f us, max %.0f us\n",
+		       pipe->lat_min, pipe->lat_sum / pipe->succeeded,
+		       pipe->lat_max);
+	}
+
+	free(pipe->slots);
+	free(pipe);
+	params->pipe = NULL;
+}
+
 static int process_line(char *lp, void *arg)
 {
 	knsupdate_params_t *params = (knsupdate_params_t *)arg;
@@ -564,6 +807,14 @@ int knsupdate_exec(knsupdate_params_t *params)
 
 	int ret = KNOT_EOK;
 
+	/* Keep one connection with updates in flight. */
+	if (params->pipeline > 0) {
+		ret = pipe_init(params);
+		if (ret != KNOT_EOK) {
+			return ret;
+		}
+	}
+
 	/* If no file specified, use stdin. */
 	if (EMPTY_LIST(params->qfiles)) {
 		ret = process_lines(params, stdin);
@@ -595,6 +846,17 @@ int knsupdate_exec(knsupdate_params_t *params)
 		}
 	}
 
+	if (params->pipe != NULL) {
+		int flush_ret = pipe_flush(params);
+		if (ret == KNOT_EOK) {
+			ret = flush_ret;
+		}
+		if (ret == KNOT_EOK && params->pipe->failed > 0) {
+			ret = KNOT_ERROR;
+		}
+		pipe_deinit(params);
+	}
+
 	return ret;
 }
 
@@ -826,6 +1088,16 @@ int cmd_send(const char* lp, knsupdate_params_t *params)
 	DBG("%s: lp='%s'\n", __func__, lp);
 	DBG("sending packet\n");
 
+	/* Reserve a slot for the update if pipelined. */
+	int slot = -1;
+	if (params->pipe != NULL) {
+		slot = pipe_reserve(params);
+		if (slot < 0) {
+			ERR("failed to send UPDATE message (%s)\n", knot_strerror(slot));
+			return slot;
+		}
+	}
+
 	/* Build query packet. */
 	int ret = build_query(params);
 	if (ret != KNOT_EOK) {
@@ -833,6 +1105,11 @@ int cmd_send(const char* lp, knsupdate_params_t *params)
 		return ret;
 	}
 
+	/* Pipelined updates are matched by ID. */
+	if (slot >= 0) {
+		knot_wire_set_id(params->query->wire, params->pipe->id_base + slot);
+	}
+
 	/* Sign if key specified. */
 	sign_context_t sign_ctx = { 0 };
 	if (params->tsig_key.name) {
@@ -852,6 +1129,13 @@ int cmd_send(const char* lp, knsupdate_params_t *params)
 		}
 	}
 
+	/* Don't wait for the reply if pipelined. */
+	if (slot >= 0) {
+		ret = pipe_send(params, slot, &sign_ctx);
+		knsupdate_reset(params);
+		return ret;
+	}
+
 	int rb = 0;
 	/* Send/recv message (1 try + N retries). */
 	int tries = 1 + params->retries;
@@ -931,6 +1215,11 @@ int cmd_server(const char* lp, knsupdate_params_t *params)
 		return KNOT_ENOMEM;
 	}
 
+	/* Finish pending updates on the previous connection. */
+	if (params->pipe != NULL) {
+		(void)pipe_flush(params);
+	}
+
 	srv_info_free(params->server);
 	params->server = srv;
 
@@ -948,6 +1237,11 @@ int cmd_local(const char* lp, knsupdate_params_t *params)
 		return KNOT_ENOMEM;
 	}
 
+	/* Finish pending updates on the previous connection. */
+	if (params->pipe != NULL) {
+		(void)pipe_flush(params);
+	}
+
 	srv_info_free(params->srcif);
 	params->srcif = srv;
 
@@ -181,7 +181,8 @@ void knsupdate_reset(knsupdate_params_t *params)
 static void print_help(void)
 {
 	printf("Usage: %s [-d] [-v] [-k keyfile | -y [hmac:]name:key]\n"
-	       "                 [-p port] [-t timeout] [-r retries] [filename]\n",
+	       "                 [-p port] [-t timeout] [-r retries] [-P window]\n"
+	       "                 [filename]\n",
 	       PROGRAM_NAME);
 }
 
@@ -205,7 +206,7 @@ int knsupdate_parse(knsupdate_params_t *params, int argc, char *argv[])
 
 	/* Command line options processing. */
 	int opt = 0;
-	while ((opt = getopt_long(argc, argv, "dhDvVp:t:r:y:k:", opts, NULL))
+	while ((opt = getopt_long(argc, argv, "dhDvVp:t:r:y:k:P:", opts, NULL))
 	       != -1) {
 		switch (opt) {
 		case 'd':
@@ -238,6 +239,14 @@ int knsupdate_parse(knsupdate_params_t *params, int argc, char *argv[])
 				return ret;
 			}
 			break;
+		case 'P':
+			ret = str_to_u16(optarg, &params->pipeline);
+			if (ret != KNOT_EOK || params->pipeline == 0) {
+				ERR("invalid pipeline window '%s'\n", optarg);
+				return KNOT_EINVAL;
+			}
+			params->protocol = PROTO_TCP;
+			break;
 		case 't':
 			ret = params_parse_wait(optarg, &params->wait);
 			if (ret != KNOT_EOK) {
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <time.h>
 
 #include "utils/common/netio.h"
 #include "utils/common/params.h"
@@ -25,6 +26,36 @@
 #include "libzscanner/scanner.h"
 #include "contrib/ucw/lists.h"
 
+/*! \brief Update in flight in the pipelined mode. */
+typedef struct {
+	/*!< Slot is occupied. */
+	bool		used;
+	/*!< Time of sending. */
+	struct timespec	sent;
+	/*!< Signing context for reply verification. */
+	sign_context_t	sign_ctx;
+} pipe_slot_t;
+
+/*! \brief Pipelined mode state. */
+typedef struct {
+	/*!< Persistent TCP connection. */
+	net_t		net;
+	/*!< Connection is established. */
+	bool		connected;
+	/*!< Message ID of the first slot. */
+	uint16_t	id_base;
+	/*!< Updates in flight indexed by message ID offset. */
+	pipe_slot_t	*slots;
+	/*!< Number of occupied slots. */
+	size_t		inflight;
+	/*!< Time of the first sent update. */
+	struct timespec	begin;
+	/*!< Statistics. */
+	size_t		sent, succeeded, failed;
+	/*!< Latency statistics of answered updates in microseconds. */
+	double		lat_min, lat_max, lat_sum;
+} pipe_ctx_t;
+
 /*! \brief knsupdate-specific params data. */
 typedef struct {
 	/*!< Stop processing - just print help, version,... */
@@ -49,6 +80,10 @@ typedef struct {
 	uint32_t	retries;
 	/*!< Wait for network response in seconds (-1 means forever). */
 	int32_t		wait;
+	/*!< Maximum number of updates in flight (0 means not pipelined). */
+	uint16_t	pipeline;
+	/*!< Pipelined mode state. */
+	pipe_ctx_t	*pipe;
 	/*!< Current zone. */
 	char		*zone;
 	/*!< RR parser. */
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+
+'''Test for the kdig batch file and benchmark mode.'''
+
+import os
+import re
+from subprocess import PIPE, Popen
+
+import dnstest.params
+from dnstest.test import Test
+from dnstest.utils import *
+
+QUERIES = 500
+
+def bench(server, batch, window, proto):
+    cmd = [dnstest.params.kdig_bin, "@" + server.addr, "-p", str(server.port),
+           "-f", batch, "+bench=%i" % window, proto]
+    proc = Popen(cmd, stdout=PIPE, stderr=PIPE, universal_newlines=True)
+    out, err = proc.communicate(timeout=60)
+    detail_log(out + err)
+
+    compare(proc.returncode, 0, "kdig %s exit code" % proto)
+    match = re.search(r"sent (\d+), received (\d+), lost (\d+)", out)
+    if match is None:
+        set_err("KDIG BENCH OUTPUT")
+        return
+
+    sent, received, lost = (int(x) for x in match.groups())
+    compare(sent, QUERIES, "kdig %s sent" % proto)
+    compare(received, QUERIES, "kdig %s received" % proto)
+    compare(lost, 0, "kdig %s lost" % proto)
+
+t = Test()
+
+knot = t.server("knot")
+zone = t.zone("example.com.")
+t.link(zone, knot)
+
+t.start()
+knot.zone_wait(zone)
+
+batch = os.path.join(knot.dir, "batch")
+with open(batch, "w") as f:
+    f.write("; Queries for the benchmark.\n\n")
+    for i in range(QUERIES):
+        if i % 2 == 0:
+            f.write("example.com. SOA\n")
+        else:
+            f.write("host%i.example.com. A\n" % i)
+
+bench(knot, batch, 10, "+notcp")
+bench(knot, batch, 1000, "+notcp")
+# More queries in flight than fit into the socket buffers.
+bench(knot, batch, 1000, "+tcp")
+
+t.end()
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+
+'''Test for bulk zone add/remove and template change reload.'''
+
+import os
+
+from dnstest.libknot import libknot
+from dnstest.test import Test
+from dnstest.utils import *
+
+ZONES = 20
+TPL_ZONES = 10
+REMOVED = 5
+
+def zone_name(i):
+    return "bulk%i." % i
+
+def write_zone(storage, name, serial):
+    os.makedirs(storage, exist_ok=True)
+    with open(os.path.join(storage, name + "zone"), "w") as f:
+        f.write("$ORIGIN %s\n" % name)
+        f.write("@ 3600 SOA ns admin %i 3600 600 86400 300\n" % serial)
+        f.write("@ 3600 NS ns\n")
+        f.write("ns 3600 A 192.0.2.1\n")
+
+def conf_zones(ctl, cmd, zones, template=None):
+    for name in zones:
+        query = libknot.control.KnotCtlData()
+        query[libknot.control.KnotCtlDataIdx.COMMAND] = cmd
+        query[libknot.control.KnotCtlDataIdx.ZONE] = name
+        query[libknot.control.KnotCtlDataIdx.DATA] = template
+        ctl.send(libknot.control.KnotCtlType.DATA, query)
+    ctl.send(libknot.control.KnotCtlType.BLOCK)
+    ctl.receive_block()
+
+def conf_set(ctl, section, item, identifier, data):
+    ctl.send_block(cmd="conf-begin")
+    ctl.receive_block()
+    ctl.send_block(cmd="conf-set", section=section, item=item,
+                   identifier=identifier, data=data)
+    ctl.receive_block()
+    ctl.send_block(cmd="conf-commit")
+    ctl.receive_block()
+
+def check_serial(server, name, serial):
+    resp = server.dig(name, "SOA")
+    resp.check(rcode="NOERROR")
+    compare(resp.soa_serial(), serial, "%s serial" % name)
+
+t = Test()
+
+knot = t.server("knot")
+zone = t.zone("example.com.")
+t.link(zone, knot)
+
+tpl_v1 = os.path.join(knot.dir, "tpl-v1")
+tpl_v2 = os.path.join(knot.dir, "tpl-v2")
+for i in range(ZONES):
+    write_zone(knot.dir, zone_name(i), 1)
+    write_zone(tpl_v1, zone_name(i), 10)
+    write_zone(tpl_v2, zone_name(i), 20)
+
+t.start()
+knot.zone_wait(zone)
+
+ctl = libknot.control.KnotCtl()
+ctl.connect(os.path.join(knot.dir, "knot.sock"))
+
+conf_set(ctl, "template", "id", None, "tpl")
+conf_set(ctl, "template", "storage", "tpl", tpl_v1)
+
+# Add zones in one batch, part of them with the template.
+conf_zones(ctl, "conf-zone-add", [zone_name(i) for i in range(TPL_ZONES)], "tpl")
+conf_zones(ctl, "conf-zone-add", [zone_name(i) for i in range(TPL_ZONES, ZONES)])
+t.sleep(2)
+
+for i in range(ZONES):
+    check_serial(knot, zone_name(i), 10 if i < TPL_ZONES else 1)
+
+# Remove some zones in one batch.
+conf_zones(ctl, "conf-zone-remove",
+           [zone_name(i) for i in range(ZONES - REMOVED, ZONES)])
+t.sleep(2)
+
+for i in range(ZONES - REMOVED, ZONES):
+    resp = knot.dig(zone_name(i), "SOA")
+    resp.check(rcode="REFUSED")
+
+# Change the template, only the zones using it are reloaded.
+conf_set(ctl, "template", "storage", "tpl", tpl_v2)
+t.sleep(2)
+
+for i in range(ZONES - REMOVED):
+    check_serial(knot, zone_name(i), 20 if i < TPL_ZONES else 1)
+
+# Add a removed zone back.
+conf_zones(ctl, "conf-zone-add", [zone_name(ZONES - 1)])
+t.sleep(2)
+
+check_serial(knot, zone_name(ZONES - 1), 1)
+
+resp = knot.dig("example.com.", "SOA")
+resp.check(rcode="NOERROR")
+
+ctl.send(libknot.control.KnotCtlType.END)
+ctl.close()
+
+t.end()
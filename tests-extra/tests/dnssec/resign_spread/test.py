@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+
+'''Test for spreading of RRSIG refreshes by jitter and batched re-signing.'''
+
+from dnstest.utils import *
+from dnstest.test import Test
+import dns
+import time
+
+LIFETIME = 40
+REFRESH = 6
+JITTER = 16
+BATCH = 10
+
+def rrsig_times(server, zone):
+    expirations = set()
+    inceptions = set()
+    resp = server.dig(zone, "AXFR")
+    for msg in resp.resp:
+        for rrset in msg.answer:
+            if rrset.rdtype != dns.rdatatype.RRSIG:
+                continue
+            for rr in rrset:
+                expirations.add(rr.expiration)
+                inceptions.add(rr.inception)
+    return expirations, inceptions
+
+t = Test()
+
+master = t.server("knot")
+zone = t.zone_rnd(1, dnssec=False, records=300)
+t.link(zone, master)
+
+master.dnssec(zone).enable = True
+master.dnssec(zone).rrsig_lifetime = LIFETIME
+master.dnssec(zone).rrsig_refresh = REFRESH
+master.dnssec(zone).rrsig_prerefresh = 0
+master.dnssec(zone).rrsig_jitter = JITTER
+master.dnssec(zone).rrsig_batch = BATCH
+master.dnssec(zone).rrsig_batch_interval = 1
+
+t.start()
+
+serial = master.zone_wait(zone)
+
+# The jitter spreads the expirations of the initial signatures.
+expirations, _ = rrsig_times(master, zone)
+if max(expirations) - min(expirations) < JITTER / 2:
+    set_err("RRSIG expirations not spread (%d - %d)" % (min(expirations), max(expirations)))
+
+# Count the re-signing events until all initial signatures are refreshed.
+serials = set()
+for i in range(LIFETIME):
+    t.sleep(1)
+    new_serial = master.zone_wait(zone)
+    if new_serial != serial:
+        serials.add(new_serial)
+        serial = new_serial
+
+if len(serials) < 2:
+    set_err("RRSIGs refreshed in %d event(s)" % len(serials))
+
+# The refreshed signatures were issued in several batches.
+expirations, inceptions = rrsig_times(master, zone)
+if len(inceptions) < 2:
+    set_err("RRSIG inceptions not spread (%s)" % sorted(inceptions))
+if min(expirations) <= int(time.time()):
+    set_err("Expired RRSIGs left in the zone")
+
+t.stop()
@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+
+'''Check that slave validates DNSSEC signatures of incoming transfers'''
+
+from dnstest.utils import *
+from dnstest.test import Test
+import random
+
+t = Test()
+
+master = t.server("knot")
+slave = t.server("knot")
+zone = t.zone_rnd(1, dnssec=False, records=200)
+
+t.link(zone, master, slave, ddns=True, ixfr=True)
+
+master.dnssec(zone).enable = True
+master.dnssec(zone).nsec3 = random.choice([True, False])
+slave.dnssec(zone).validate = True
+
+t.start()
+serial = slave.zone_wait(zone)
+t.xfr_diff(master, slave, zone)
+
+# Signed changes pass the validation of IXFR.
+up = master.update(zone)
+up.add("valid", 3600, "A", "192.0.2.1")
+up.send("NOERROR")
+serial = slave.zone_wait(zone, serial)
+t.xfr_diff(master, slave, zone)
+
+# Unsigned changes are refused.
+master.dnssec(zone).enable = False
+master.gen_confile()
+master.reload()
+
+up = master.update(zone)
+up.add("unsigned", 3600, "A", "192.0.2.2")
+up.send("NOERROR")
+t.sleep(4)
+
+resp = slave.dig("unsigned." + zone[0].name, "A")
+resp.check(rcode="NXDOMAIN")
+slave.zone_wait(zone, serial, equal=True, greater=False)
+
+t.end()
@@ -51,6 +51,9 @@ class ZoneDnssec(object):
         self.rrsig_lifetime = None
         self.rrsig_refresh = None
         self.rrsig_prerefresh = None
+        self.rrsig_jitter = None
+        self.rrsig_batch = None
+        self.rrsig_batch_interval = None
         self.nsec3 = None
         self.nsec3_iters = None
         self.nsec3_opt_out = None
@@ -62,6 +65,7 @@ class ZoneDnssec(object):
         self.ksk_shared = None
         self.cds_publish = None
         self.offline_ksk = None
+        self.validate = None
 
 class Zone(object):
     '''DNS zone description'''
@@ -1215,6 +1219,9 @@ class Knot(Server):
             self._str(s, "rrsig-lifetime", z.dnssec.rrsig_lifetime)
             self._str(s, "rrsig-refresh", z.dnssec.rrsig_refresh)
             self._str(s, "rrsig-pre-refresh", z.dnssec.rrsig_prerefresh)
+            self._str(s, "rrsig-jitter", z.dnssec.rrsig_jitter)
+            self._str(s, "rrsig-batch", z.dnssec.rrsig_batch)
+            self._str(s, "rrsig-batch-interval", z.dnssec.rrsig_batch_interval)
             self._bool(s, "nsec3", z.dnssec.nsec3)
             self._str(s, "nsec3-iterations", z.dnssec.nsec3_iters)
             self._bool(s, "nsec3-opt-out", z.dnssec.nsec3_opt_out)
@@ -1305,6 +1312,9 @@ class Knot(Server):
                 s.item_str("dnssec-signing", "on")
                 s.item_str("dnssec-policy", z.name)
 
+            if z.dnssec.validate:
+                s.item_str("dnssec-validation", "on")
+
             if len(z.modules) > 0:
                 modules = ""
                 for module in z.modules:
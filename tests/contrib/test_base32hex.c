@@ -22,13 +22,48 @@
 #include "libknot/libknot.h"
 #include "contrib/base32hex.h"
 #include "contrib/openbsd/strlcpy.h"
+#include "contrib/time.h"
 
 #define BUF_LEN			256
 #define MAX_BIN_DATA_LEN	((INT32_MAX / 8) * 5)
+#define HASH_LEN		20
+#define BENCH_ROUNDS		1000000
+
+static void test_bench(void)
+{
+	uint8_t hash[HASH_LEN], txt[BUF_LEN], bin[BUF_LEN];
+	for (int i = 0; i < HASH_LEN; i++) {
+		hash[i] = i * 13;
+	}
+
+	// NSEC3 owner names are encoded SHA-1 hashes.
+	int32_t txt_len = 0, bin_len = 0;
+	struct timespec begin = time_now();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		hash[0] = i;
+		txt_len = base32hex_encode(hash, HASH_LEN, txt, sizeof(txt));
+	}
+	struct timespec end = time_now();
+	double enc_ms = time_diff_ms(&begin, &end);
+
+	begin = time_now();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		txt[0] = '0' + i % 10;
+		bin_len = base32hex_decode(txt, txt_len, bin, sizeof(bin));
+	}
+	end = time_now();
+	double dec_ms = time_diff_ms(&begin, &end);
+
+	ok(txt_len == 32, "Benchmark - ENC");
+	ok(bin_len == HASH_LEN, "Benchmark - DEC");
+	diag("NSEC3 hash throughput: encode %.1f M/s, decode %.1f M/s",
+	     BENCH_ROUNDS / (enc_ms * 1000 + 0.001),
+	     BENCH_ROUNDS / (dec_ms * 1000 + 0.001));
+}
 
 int main(int argc, char *argv[])
 {
-	plan(67);
+	plan(71);
 
 	int32_t  ret;
 	uint8_t  in[BUF_LEN], ref[BUF_LEN], out[BUF_LEN], out2[BUF_LEN], *out3;
@@ -262,6 +297,12 @@ int main(int argc, char *argv[])
 	ok(ret == KNOT_BASE32HEX_ECHAR, "Bad data character dollar on position 2");
 	ret = base32hex_decode((uint8_t *)"$AAAAAAA", 8, out, BUF_LEN);
 	ok(ret == KNOT_BASE32HEX_ECHAR, "Bad data character dollar on position 1");
+	ret = base32hex_decode((uint8_t *)"AAAAA$AAAAAAAAAA", 16, out, BUF_LEN);
+	ok(ret == KNOT_BASE32HEX_ECHAR, "Bad data character dollar in first octet");
+	ret = base32hex_decode((uint8_t *)"AAAAAA==AAAAAAAA", 16, out, BUF_LEN);
+	ok(ret == KNOT_BASE32HEX_ECHAR, "Padding in first octet");
+
+	test_bench();
 
 	return 0;
 }
@@ -14,21 +14,206 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 #include <tap/basic.h>
 
 #include "libknot/libknot.h"
 #include "contrib/base64.h"
 #include "contrib/openbsd/strlcpy.h"
+#include "contrib/time.h"
 
 #define BUF_LEN			256
 #define MAX_BIN_DATA_LEN	((INT32_MAX / 4) * 3)
+#define LONG_LEN		1024
+#define BENCH_LEN		(3 * 256 * 1024)
+#define BENCH_ROUNDS		64
+
+static const char *alphabet =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/*! \brief Bit-by-bit reference encoder. */
+static uint32_t ref_encode(const uint8_t *in, uint32_t in_len, uint8_t *out)
+{
+	uint32_t out_len = 0;
+	for (uint32_t bit = 0; bit < in_len * 8; bit += 6) {
+		uint8_t val = 0;
+		for (int i = 0; i < 6; i++) {
+			uint32_t pos = bit + i;
+			uint8_t b = (pos < in_len * 8) ? (in[pos / 8] >> (7 - pos % 8)) & 1 : 0;
+			val = (val << 1) | b;
+		}
+		out[out_len++] = alphabet[val];
+	}
+	while (out_len % 4 != 0) {
+		out[out_len++] = '=';
+	}
+	return out_len;
+}
+
+static void test_long(void)
+{
+	uint8_t in[LONG_LEN], ref[2 * LONG_LEN], out[2 * LONG_LEN], bin[LONG_LEN];
+	bool enc_ok = true, dec_ok = true, bad_ok = true, pad_ok = true;
+
+	for (uint32_t i = 0; i < sizeof(in); i++) {
+		in[i] = (i * 7919) ^ (i >> 3);
+	}
+
+	for (uint32_t len = 0; len <= sizeof(in); len += (len < 128) ? 1 : 29) {
+		uint32_t ref_len = ref_encode(in, len, ref);
+		int32_t ret = base64_encode(in, len, out, sizeof(out));
+		if (ret != ref_len || memcmp(out, ref, ref_len) != 0) {
+			enc_ok = false;
+			continue;
+		}
+
+		ret = base64_decode(ref, ref_len, bin, sizeof(bin));
+		if (ret != len || memcmp(bin, in, len) != 0) {
+			dec_ok = false;
+		}
+
+		// Invalid character at any position must be detected.
+		for (uint32_t pos = 0; pos < ref_len; pos += 13) {
+			uint8_t orig = ref[pos];
+			ref[pos] = (pos % 2 == 0) ? '$' : 0xC1;
+			if (base64_decode(ref, ref_len, bin, sizeof(bin)) != KNOT_BASE64_ECHAR) {
+				bad_ok = false;
+			}
+			ref[pos] = orig;
+		}
+
+		// Padding is allowed only in the last quartet.
+		if (ref_len > 4) {
+			uint8_t orig = ref[ref_len - 5];
+			ref[ref_len - 5] = '=';
+			if (base64_decode(ref, ref_len, bin, sizeof(bin)) != KNOT_BASE64_ECHAR) {
+				pad_ok = false;
+			}
+			ref[ref_len - 5] = orig;
+		}
+	}
+
+	ok(enc_ok, "Long data - ENC matches reference");
+	ok(dec_ok, "Long data - DEC matches input");
+	ok(bad_ok, "Long data - bad character detected");
+	ok(pad_ok, "Long data - inner padding detected");
+}
+
+/*! \brief Character-by-character reference decoder. */
+static int32_t ref_decode(const uint8_t *in, uint32_t in_len, uint8_t *out)
+{
+	uint32_t out_len = 0, acc = 0, bits = 0;
+	for (uint32_t i = 0; i < in_len; i++) {
+		const char *pos = (in[i] != 0) ? strchr(alphabet, in[i]) : NULL;
+		if (pos == NULL) {
+			// Padding only at the end of the last quartet.
+			if (in[i] == '=' && i + 2 >= in_len && in[in_len - 1] == '=') {
+				continue;
+			}
+			return KNOT_BASE64_ECHAR;
+		}
+		acc = (acc << 6) | (pos - alphabet);
+		bits += 6;
+		if (bits >= 8) {
+			bits -= 8;
+			out[out_len++] = acc >> bits;
+		}
+	}
+	return out_len;
+}
+
+static void test_random(void)
+{
+	uint8_t in[LONG_LEN], txt[2 * LONG_LEN], ref[2 * LONG_LEN], out[2 * LONG_LEN];
+	bool enc_ok = true, dec_ok = true, bad_ok = true;
+
+	srandom(time(NULL));
+
+	// The vector code, if supported by the CPU, must match the references.
+	for (uint32_t len = 0; len <= sizeof(in); len += (len < 128) ? 1 : 37) {
+		for (uint32_t i = 0; i < len; i++) {
+			in[i] = random();
+		}
+
+		uint32_t ref_len = ref_encode(in, len, ref);
+		int32_t ret = base64_encode(in, len, out, sizeof(out));
+		if (ret != ref_len || memcmp(out, ref, ref_len) != 0) {
+			enc_ok = false;
+			continue;
+		}
+
+		ret = base64_decode(ref, ref_len, out, sizeof(out));
+		if (ret != len || memcmp(out, in, len) != 0) {
+			dec_ok = false;
+		}
+
+		// Random characters from the alphabet, sometimes a bad one or padding.
+		for (uint32_t i = 0; i < ref_len; i++) {
+			txt[i] = (random() % (2 * ref_len) != 0) ? alphabet[random() % 64] : random();
+		}
+		if (ref_len > 0 && random() % 2 == 0) {
+			txt[ref_len - 1 - random() % 2] = '=';
+		}
+
+		int32_t ref_ret = ref_decode(txt, ref_len, ref);
+		ret = base64_decode(txt, ref_len, out, sizeof(out));
+		if (ret != ref_ret || (ret > 0 && memcmp(out, ref, ret) != 0)) {
+			bad_ok = false;
+		}
+	}
+
+	ok(enc_ok, "Random data - ENC matches reference");
+	ok(dec_ok, "Random data - DEC matches input");
+	ok(bad_ok, "Random text - DEC matches reference");
+}
+
+static void test_bench(void)
+{
+	uint8_t *in = malloc(BENCH_LEN);
+	uint8_t *txt = malloc(BENCH_LEN / 3 * 4);
+	if (in == NULL || txt == NULL) {
+		free(in);
+		free(txt);
+		skip_block(2, "Not enough memory");
+		return;
+	}
+	for (int i = 0; i < BENCH_LEN; i++) {
+		in[i] = i * 31;
+	}
+
+	int32_t txt_len = 0, bin_len = 0;
+	struct timespec begin = time_now();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		txt_len = base64_encode(in, BENCH_LEN, txt, BENCH_LEN / 3 * 4);
+	}
+	struct timespec end = time_now();
+	double enc_ms = time_diff_ms(&begin, &end);
+
+	begin = time_now();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		bin_len = base64_decode(txt, txt_len, in, BENCH_LEN);
+	}
+	end = time_now();
+	double dec_ms = time_diff_ms(&begin, &end);
+
+	ok(txt_len > 0, "Benchmark - ENC");
+	ok(bin_len == BENCH_LEN, "Benchmark - DEC");
+
+	double mib = (double)BENCH_LEN * BENCH_ROUNDS / (1024 * 1024);
+	diag("binary data throughput: encode %.0f MiB/s, decode %.0f MiB/s",
+	     mib * 1000 / (enc_ms + 0.001), mib * 1000 / (dec_ms + 0.001));
+
+	free(in);
+	free(txt);
+}
 
 int main(int argc, char *argv[])
 {
-	plan(52);
+	plan(61);
 
 	int32_t  ret;
 	uint8_t  in[BUF_LEN], ref[BUF_LEN], out[BUF_LEN], out2[BUF_LEN], *out3;
@@ -233,5 +418,12 @@ int main(int argc, char *argv[])
 	ret = base64_decode((uint8_t *)"AAA ", 4, out, BUF_LEN);
 	ok(ret == KNOT_BASE64_ECHAR, "Bad data character space");
 
+	// Long data processed in blocks.
+	test_long();
+
+	// Random data and text processed in blocks.
+	test_random();
+	test_bench();
+
 	return 0;
 }
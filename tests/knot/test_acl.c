@@ -15,6 +15,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <tap/basic.h>
@@ -52,11 +53,14 @@ void check_update(conf_t *conf, knot_rrset_t *authority, knot_tsig_key_t *key,
 
 	conf_val_t acl = conf_zone_get(conf, C_ACL, zone_name);
 	ok(acl.code == KNOT_EOK, "Get zone ACL");
+	acl_rules_t *rules = acl_rules_new(conf, &acl);
+	ok(rules != NULL, "Parse zone ACL");
 
-	bool ret = acl_allowed(conf, &acl, ACL_ACTION_UPDATE, &addr, key,
+	bool ret = acl_allowed(rules, ACL_ACTION_UPDATE, &addr, key,
 	                       zone_name, parsed);
 	ok(ret == allowed, "%s", desc);
 
+	acl_rules_free(rules);
 	knot_pkt_free(parsed);
 	knot_pkt_free(query);
 }
@@ -141,88 +145,70 @@ static void test_acl_allowed(void)
 
 	acl = conf_zone_get(conf(), C_ACL, zone_name);
 	ok(acl.code == KNOT_EOK, "Get zone ACL");
+	acl_rules_t *rules = acl_rules_new(conf(), &acl);
+	ok(rules != NULL, "Parse zone ACL");
+	is_int(6, rules->count, "Parsed zone ACL rules");
+
 	check_sockaddr_set(&addr, AF_INET6, "2001::1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_NONE, &addr, &key1, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_NONE, &addr, &key1, zone_name, NULL);
 	ok(ret == true, "Address, key, empty action");
+	ok(key1.secret.size == 3 && memcmp(key1.secret.data, "foo", 3) == 0,
+	   "Key secret filled");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET6, "2001::1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_TRANSFER, &addr, &key1, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_TRANSFER, &addr, &key1, zone_name, NULL);
 	ok(ret == true, "Address, key, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET6, "2001::2", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_TRANSFER, &addr, &key1, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_TRANSFER, &addr, &key1, zone_name, NULL);
 	ok(ret == false, "Address not match, key, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET6, "2001::1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_TRANSFER, &addr, &key0, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_TRANSFER, &addr, &key0, zone_name, NULL);
 	ok(ret == false, "Address match, no key, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET6, "2001::1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_TRANSFER, &addr, &key2, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_TRANSFER, &addr, &key2, zone_name, NULL);
 	ok(ret == false, "Address match, key not match, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET6, "2001::1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_NOTIFY, &addr, &key1, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_NOTIFY, &addr, &key1, zone_name, NULL);
 	ok(ret == false, "Address, key match, action not match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET, "240.0.0.1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_NOTIFY, &addr, &key0, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_NOTIFY, &addr, &key0, zone_name, NULL);
 	ok(ret == true, "Second address match, no key, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET, "240.0.0.1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_NOTIFY, &addr, &key1, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_NOTIFY, &addr, &key1, zone_name, NULL);
 	ok(ret == false, "Second address match, extra key, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET, "240.0.0.2", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_NOTIFY, &addr, &key0, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_NOTIFY, &addr, &key0, zone_name, NULL);
 	ok(ret == false, "Denied address match, no key, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET, "240.0.0.2", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_UPDATE, &addr, &key0, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_UPDATE, &addr, &key0, zone_name, NULL);
 	ok(ret == true, "Denied address match, no key, action not match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET, "240.0.0.3", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_UPDATE, &addr, &key0, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_UPDATE, &addr, &key0, zone_name, NULL);
 	ok(ret == false, "Denied address match, no key, no action");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET, "1.1.1.1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_UPDATE, &addr, &key3, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_UPDATE, &addr, &key3, zone_name, NULL);
 	ok(ret == true, "Arbitrary address, second key, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET, "100.0.0.1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_TRANSFER, &addr, &key0, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_TRANSFER, &addr, &key0, zone_name, NULL);
 	ok(ret == true, "IPv4 address from range, no key, action match");
 
-	acl = conf_zone_get(conf(), C_ACL, zone_name);
-	ok(acl.code == KNOT_EOK, "Get zone ACL");
 	check_sockaddr_set(&addr, AF_INET6, "::1", 0);
-	ret = acl_allowed(conf(), &acl, ACL_ACTION_TRANSFER, &addr, &key0, zone_name, NULL);
+	ret = acl_allowed(rules, ACL_ACTION_TRANSFER, &addr, &key0, zone_name, NULL);
 	ok(ret == true, "IPv6 address from range, no key, action match");
 
+	acl_rules_free(rules);
+
 	knot_rrset_t A;
 	knot_rrset_init(&A, key1_name, KNOT_RRTYPE_A, KNOT_CLASS_IN, 3600);
 	knot_rrset_add_rdata(&A, (uint8_t *)"\x00\x00\x00\x00", 4, NULL);
@@ -26,6 +26,7 @@
 
 #include "knot/journal/journal_read.h"
 #include "knot/journal/journal_write.h"
+#include "knot/journal/serialization.h"
 
 #include "libknot/libknot.h"
 #include "knot/zone/zone.h"
@@ -320,6 +321,18 @@ static void test_store_load(const knot_dname_t *apex)
 	ok(changesets_eq(m_ch, HEAD(l)), "journal: changeset equal after read");
 	changesets_free(&l);
 
+	journal_read_end(read);
+
+	journal_skim_t skim;
+	ret = journal_read_begin(jj, false, changeset_from(m_ch), &read);
+	ok(ret == KNOT_EOK && journal_read_skim(read, NULL, NULL, &skim),
+	   "journal: skim single changeset");
+	ok(!skim.zone_in_journal && skim.serial_from == changeset_from(m_ch) &&
+	   skim.serial_to == changeset_to(m_ch), "journal: skimmed serials");
+	is_int(changeset_serialized_size(m_ch), skim.size, "journal: skimmed size");
+	is_int(changeset_size(m_ch), skim.remove_count + skim.add_count,
+	       "journal: skimmed record count");
+	ok(!journal_read_skim(read, NULL, NULL, &skim), "journal: skim no more changesets");
 	journal_read_end(read);
 	ret = journal_set_flushed(jj);
 	is_int(KNOT_EOK, ret, "journal: first simple flush (%s)", knot_strerror(ret));
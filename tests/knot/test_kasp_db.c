@@ -176,6 +176,32 @@ int main(int argc, char *argv[])
 	is_int(KNOT_EOK, ret, "kasp_db: load lastsigned_serial");
 	is_int(2, serial, "kasp_db: lastsigned_serial preserved");
 
+	const key_params_t zone_keys[] = { params1, params2 };
+	salt1.size = 500;
+	ret = kasp_db_store_zone(db, zone2, zone_keys, 2, &salt1, 4321);
+	is_int(KNOT_EOK, ret, "kasp_db: store zone");
+	MDB_envinfo info1, info2;
+	mdb_env_info(db->env, &info1);
+	ret = kasp_db_store_zone(db, zone2, zone_keys, 2, &salt1, 4321);
+	mdb_env_info(db->env, &info2);
+	ok(ret == KNOT_EOK && info1.me_last_txnid == info2.me_last_txnid,
+	   "kasp_db: store unchanged zone without writing");
+	ret = kasp_db_load_zone(db, zone2, &l, &salt2, &time);
+	is_int(KNOT_EOK, ret, "kasp_db: load zone");
+	ok(list_size(&l) == 2 && time == 4321 && dnssec_binary_cmp(&salt1, &salt2) == 0,
+	   "kasp_db: zone preserved");
+	params = ((ptrnode_t *)HEAD(l))->d;
+	ok(params_eq(params, &params1), "kasp_db: zone key params equal");
+	free_params
+	params = ((ptrnode_t *)TAIL(l))->d;
+	free_params
+	ptrlist_deep_free(&l, NULL);
+	dnssec_binary_free(&salt2);
+	ret = kasp_db_delete_all(db, zone2);
+	is_int(KNOT_EOK, ret, "kasp_db: delete zone");
+	ret = kasp_db_load_zone(db, zone2, &l, &salt2, &time);
+	ok(ret == KNOT_EOK && EMPTY_LIST(l) && salt2.size == 0, "kasp_db: load empty zone");
+
 	ret = kasp_db_add_key(db, zone1, &params1);
 	ok(ret == KNOT_EOK, "kasp_db: add key1");
 	ret = kasp_db_add_key(db, zone2, &params2);
@@ -0,0 +1,97 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <tap/basic.h>
+
+#include "knot/dnssec/zone-nsec.h"
+#include "knot/nameserver/nsec_cache.h"
+#include "libknot/libknot.h"
+
+static bool owner_ok(nsec_cache_t *cache, const knot_dname_t *name,
+                     const knot_dname_t *apex, const dnssec_nsec3_params_t *params)
+{
+	knot_dname_storage_t ref, out;
+
+	if (knot_create_nsec3_owner(ref, sizeof(ref), name, apex, params) != KNOT_EOK ||
+	    nsec_cache_nsec3_owner(cache, out, sizeof(out), name, apex, params) != KNOT_EOK) {
+		return false;
+	}
+
+	return knot_dname_is_equal(ref, out);
+}
+
+int main(int argc, char *argv[])
+{
+	plan_lazy();
+
+	const knot_dname_t *apex = (const knot_dname_t *)"\x07""example""\x00";
+	const knot_dname_t *name1 = (const knot_dname_t *)"\x01""a""\x07""example""\x00";
+	const knot_dname_t *name2 = (const knot_dname_t *)"\x01""b""\x07""example""\x00";
+
+	uint8_t salt[64] = { 0xaa, 0xbb, 0xcc, 0xdd };
+	dnssec_nsec3_params_t params = {
+		.algorithm = DNSSEC_NSEC3_ALGORITHM_SHA1,
+		.iterations = 10,
+		.salt = { .data = salt, .size = 4 }
+	};
+
+	nsec_cache_t *cache = nsec_cache_new();
+	ok(cache != NULL, "nsec_cache: new");
+
+	knot_dname_storage_t out;
+	int ret = nsec_cache_nsec3_owner(cache, NULL, 0, name1, apex, &params);
+	is_int(KNOT_EINVAL, ret, "nsec_cache: NULL output");
+	ret = nsec_cache_nsec3_owner(cache, out, 10, name1, apex, &params);
+	ok(ret != KNOT_EOK, "nsec_cache: output too small");
+
+	ok(owner_ok(cache, name1, apex, &params), "nsec_cache: miss");
+	ok(owner_ok(cache, name1, apex, &params), "nsec_cache: hit");
+	ok(owner_ok(cache, name2, apex, &params), "nsec_cache: another name");
+
+	params.iterations = 11;
+	ok(owner_ok(cache, name1, apex, &params), "nsec_cache: changed iterations");
+	salt[0] = 0x00;
+	ok(owner_ok(cache, name1, apex, &params), "nsec_cache: changed salt");
+	params.salt.size = 0;
+	ok(owner_ok(cache, name1, apex, &params), "nsec_cache: empty salt");
+	params.salt.size = sizeof(salt);
+	ok(owner_ok(cache, name1, apex, &params), "nsec_cache: long salt");
+	ok(owner_ok(NULL, name1, apex, &params), "nsec_cache: no cache");
+
+	// Wildcard proofs are bound to the contents instance.
+	zone_contents_t *zone = zone_contents_new(apex, false);
+	zone_contents_t *other = zone_contents_new(apex, false);
+	ok(zone != NULL && other != NULL && zone->generation != other->generation,
+	   "nsec_cache: contents generation");
+	const zone_node_t *encloser = zone->apex, *proof = zone->apex;
+
+	ok(nsec_cache_wildcard_get(cache, zone, encloser) == NULL,
+	   "nsec_cache: wildcard miss");
+	nsec_cache_wildcard_put(cache, zone, encloser, proof);
+	ok(nsec_cache_wildcard_get(cache, zone, encloser) == proof,
+	   "nsec_cache: wildcard hit");
+	ok(nsec_cache_wildcard_get(cache, other, encloser) == NULL,
+	   "nsec_cache: wildcard other contents");
+	ok(nsec_cache_wildcard_get(NULL, zone, encloser) == NULL,
+	   "nsec_cache: wildcard no cache");
+
+	zone_contents_deep_free(other);
+	zone_contents_deep_free(zone);
+	nsec_cache_free(cache);
+
+	return 0;
+}
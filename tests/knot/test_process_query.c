@@ -22,6 +22,7 @@
 #include "libknot/descriptor.h"
 #include "libknot/packet/wire.h"
 #include "knot/nameserver/process_query.h"
+#include "knot/nameserver/query_module.h"
 #include "test_server.h"
 #include "contrib/sockaddr.h"
 #include "contrib/ucw/mempool.h"
@@ -76,6 +77,63 @@ static void exec_query(knot_layer_t *layer, const char *name,
 	memcpy(dst, src, src_len); \
 	dst_len = src_len;
 
+static unsigned end_step_calls = 0;
+static unsigned end_batch_calls = 0;
+static unsigned end_batch_queries = 0;
+
+static unsigned end_step(unsigned state, knot_pkt_t *pkt, knotd_qdata_t *qdata,
+                         knotd_mod_t *mod)
+{
+	end_step_calls++;
+	return state;
+}
+
+static void end_batch(knotd_state_t *states, knot_pkt_t **pkts,
+                      knotd_qdata_t **qdatas, unsigned count, knotd_mod_t *mod)
+{
+	end_batch_calls++;
+	end_batch_queries += count;
+}
+
+/* Batch processing of the end stage (3 TAP tests). */
+static void test_batch_end(knot_mm_t *mm, knot_pkt_t *query,
+                           const knotd_qdata_params_t *params)
+{
+	struct query_plan *plan = query_plan_create();
+	(void)query_plan_batch_step(plan, KNOTD_STAGE_END, end_step, end_batch, NULL);
+	(void)query_plan_step(plan, KNOTD_STAGE_END, end_step, NULL);
+	conf()->query_plan = plan;
+
+	knotd_qdata_params_t batch_params = *params;
+	batch_params.flags |= KNOTD_QUERY_FLAG_BATCH;
+
+	knot_layer_t layers[2];
+	knot_pkt_t *answers[2];
+	for (unsigned i = 0; i < 2; i++) {
+		knot_layer_init(&layers[i], mm, process_query_layer());
+		knot_layer_begin(&layers[i], &batch_params);
+		answers[i] = knot_pkt_new(NULL, KNOT_WIRE_MAX_PKTSIZE, mm);
+		knot_pkt_parse(query, 0);
+		knot_layer_consume(&layers[i], query);
+		knot_layer_produce(&layers[i], answers[i]);
+	}
+	ok(end_step_calls == 0 && end_batch_calls == 0,
+	   "ns: batch end stage postponed");
+
+	process_query_batch_end(layers, answers, 2);
+	ok(end_batch_calls == 1 && end_batch_queries == 2 && end_step_calls == 2,
+	   "ns: batch end stage processed");
+	ok(layers[0].state == KNOT_STATE_DONE && layers[1].state == KNOT_STATE_DONE,
+	   "ns: batch queries answered");
+
+	for (unsigned i = 0; i < 2; i++) {
+		knot_layer_finish(&layers[i]);
+	}
+
+	conf()->query_plan = NULL;
+	query_plan_free(plan);
+}
+
 int main(int argc, char *argv[])
 {
 	plan_lazy();
@@ -181,6 +239,11 @@ int main(int argc, char *argv[])
 	knot_layer_finish(&proc);
 	ok(proc.state == KNOT_STATE_NOOP, "ns: processing end" );
 
+	/* Query processor (batch). */
+	knot_pkt_clear(query);
+	knot_pkt_put_question(query, ROOT_DNAME, KNOT_CLASS_IN, KNOT_RRTYPE_SOA);
+	test_batch_end(&mm, query, &params);
+
 fatal:
 	/* Cleanup. */
 	mp_delete((struct mempool *)mm.ctx);
@@ -47,6 +47,16 @@ int main(int argc, char *argv[])
 		goto fatal;
 	}
 
+	/* Empty plan must skip all stages. */
+	unsigned visited = 0;
+	for (unsigned stage = KNOTD_STAGE_BEGIN; stage < KNOTD_STAGES; ++stage) {
+		struct query_step *step = NULL;
+		WALK_PLAN(step, plan, stage) {
+			visited++;
+		}
+	}
+	ok(plan->stage_mask == 0 && visited == 0, "query_plan: empty stages skipped");
+
 	/* Register all stage visits. */
 	int ret = KNOT_EOK;
 	for (unsigned stage = KNOTD_STAGE_BEGIN; stage < KNOTD_STAGES; ++stage) {
@@ -56,12 +66,13 @@ int main(int argc, char *argv[])
 		}
 	}
 	is_int(KNOT_EOK, ret, "query_plan: planned all steps");
+	ok(plan->stage_mask == (1U << KNOTD_STAGES) - 1, "query_plan: all stages marked");
 
 	/* Execute the plan. */
 	int state = 0, next_state = 0;
 	for (unsigned stage = KNOTD_STAGE_BEGIN; stage < KNOTD_STAGES; ++stage) {
 		struct query_step *step = NULL;
-		WALK_LIST(step, plan->stage[stage]) {
+		WALK_PLAN(step, plan, stage) {
 			next_state = step->process(state, NULL, NULL, step->ctx);
 			if (next_state != state + 1) {
 				break;
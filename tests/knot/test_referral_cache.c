@@ -0,0 +1,117 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <tap/basic.h>
+
+#include "knot/nameserver/referral_cache.h"
+#include "libknot/libknot.h"
+
+static knot_pkt_t *referral(const knot_dname_t *qname, const knot_rrset_t *ns,
+                            const knot_rrset_t *glue)
+{
+	knot_pkt_t *pkt = knot_pkt_new(NULL, KNOT_WIRE_MAX_PKTSIZE, NULL);
+	knot_pkt_put_question(pkt, qname, KNOT_CLASS_IN, KNOT_RRTYPE_A);
+	knot_pkt_begin(pkt, KNOT_ANSWER);
+	knot_pkt_begin(pkt, KNOT_AUTHORITY);
+	if (ns != NULL) {
+		knot_pkt_put(pkt, KNOT_COMPR_HINT_NONE, ns, 0);
+		knot_pkt_begin(pkt, KNOT_ADDITIONAL);
+		uint16_t hint = knot_compr_hint(&pkt->rr_info[0], KNOT_COMPR_HINT_RDATA);
+		knot_pkt_put(pkt, hint, glue, 0);
+	}
+
+	return pkt;
+}
+
+static bool pkt_equal(const knot_pkt_t *a, const knot_pkt_t *b)
+{
+	return a->size == b->size && memcmp(a->wire, b->wire, a->size) == 0 &&
+	       a->rrset_count == b->rrset_count &&
+	       a->sections[KNOT_AUTHORITY].count == b->sections[KNOT_AUTHORITY].count &&
+	       a->sections[KNOT_ADDITIONAL].count == b->sections[KNOT_ADDITIONAL].count;
+}
+
+int main(int argc, char *argv[])
+{
+	plan_lazy();
+
+	const knot_dname_t *apex = (const knot_dname_t *)"\x07""example""\x00";
+	const knot_dname_t *ns_name = (const knot_dname_t *)"\x02""ns""\x07""example""\x00";
+	const knot_dname_t *qname1 = (const knot_dname_t *)"\x03""www""\x07""example""\x00";
+	const knot_dname_t *qname2 = (const knot_dname_t *)"\x01""x""\x01""y""\x07""example""\x00";
+	const uint8_t addr[] = { 192, 0, 2, 1 };
+
+	knot_rrset_t *ns = knot_rrset_new(apex, KNOT_RRTYPE_NS, KNOT_CLASS_IN, 3600, NULL);
+	knot_rrset_add_rdata(ns, ns_name, knot_dname_size(ns_name), NULL);
+	knot_rrset_t *glue = knot_rrset_new(ns_name, KNOT_RRTYPE_A, KNOT_CLASS_IN, 3600, NULL);
+	knot_rrset_add_rdata(glue, addr, sizeof(addr), NULL);
+
+	referral_cache_t *cache = referral_cache_new();
+	zone_contents_t *zone = zone_contents_new(apex, false);
+	zone_contents_t *other = zone_contents_new(apex, false);
+	ok(cache != NULL && zone != NULL && other != NULL, "referral_cache: new");
+	const zone_node_t *node = zone->apex;
+
+	knot_pkt_t *pkt = referral(qname2, NULL, NULL);
+	int ret = referral_cache_get(cache, pkt, zone, node, false);
+	is_int(KNOT_ENOENT, ret, "referral_cache: miss");
+	knot_pkt_free(pkt);
+
+	// Store a referral and reuse it for a longer QNAME.
+	pkt = referral(qname1, ns, glue);
+	referral_cache_put(cache, pkt, zone, node, false);
+	knot_pkt_free(pkt);
+
+	knot_pkt_t *ref = referral(qname2, ns, glue);
+	pkt = referral(qname2, NULL, NULL);
+	ret = referral_cache_get(cache, pkt, zone, node, false);
+	ok(ret == KNOT_EOK && pkt_equal(pkt, ref), "referral_cache: hit");
+	knot_pkt_free(pkt);
+
+	pkt = referral(qname2, NULL, NULL);
+	ret = referral_cache_get(cache, pkt, zone, node, true);
+	is_int(KNOT_ENOENT, ret, "referral_cache: DNSSEC miss");
+	ret = referral_cache_get(cache, pkt, other, node, false);
+	is_int(KNOT_ENOENT, ret, "referral_cache: other contents");
+
+	size_t size = pkt->size;
+	pkt->max_size = ref->size - 1;
+	ret = referral_cache_get(cache, pkt, zone, node, false);
+	ok(ret == KNOT_ESPACE && pkt->size == size && pkt->rrset_count == 0,
+	   "referral_cache: no space");
+	knot_pkt_free(pkt);
+	knot_pkt_free(ref);
+
+	// NS name equal to the QNAME is compressed to a QNAME-specific suffix.
+	referral_cache_free(cache);
+	cache = referral_cache_new();
+	pkt = referral(ns_name, ns, glue);
+	referral_cache_put(cache, pkt, zone, node, false);
+	knot_pkt_free(pkt);
+	pkt = referral(qname1, NULL, NULL);
+	ret = referral_cache_get(cache, pkt, zone, node, false);
+	is_int(KNOT_ENOENT, ret, "referral_cache: QNAME specific referral");
+	knot_pkt_free(pkt);
+
+	zone_contents_deep_free(other);
+	zone_contents_deep_free(zone);
+	referral_cache_free(cache);
+	knot_rrset_free(glue, NULL);
+	knot_rrset_free(ns, NULL);
+
+	return 0;
+}
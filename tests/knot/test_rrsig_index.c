@@ -0,0 +1,135 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <tap/basic.h>
+
+#include "knot/dnssec/rrsig-index.h"
+#include "libknot/libknot.h"
+#include "contrib/wire_ctx.h"
+
+static const knot_dname_t *apex = (const knot_dname_t *)"\x07""example""\x00";
+
+static zone_node_t *add_rrsig(zone_contents_t *zone, const knot_dname_t *owner,
+                              uint32_t expire)
+{
+	uint8_t rdata[64] = { 0 };
+	wire_ctx_t wire = wire_ctx_init(rdata, sizeof(rdata));
+	wire_ctx_write_u16(&wire, KNOT_RRTYPE_A);  // type covered
+	wire_ctx_write_u8(&wire, 13);              // algorithm
+	wire_ctx_write_u8(&wire, 2);               // labels
+	wire_ctx_write_u32(&wire, 3600);           // original TTL
+	wire_ctx_write_u32(&wire, expire);         // expiration
+	wire_ctx_write_u32(&wire, 1);              // inception
+	wire_ctx_write_u16(&wire, 1234);           // key tag
+	wire_ctx_write(&wire, apex, knot_dname_size(apex));
+	wire_ctx_write_u32(&wire, expire);         // signature
+
+	knot_rrset_t rr;
+	knot_rrset_init(&rr, (knot_dname_t *)owner, KNOT_RRTYPE_RRSIG, KNOT_CLASS_IN, 3600);
+	zone_node_t *node = NULL;
+	if (knot_rrset_add_rdata(&rr, rdata, wire_ctx_offset(&wire), NULL) != KNOT_EOK ||
+	    zone_contents_add_rr(zone, &rr, &node) != KNOT_EOK) {
+		node = NULL;
+	}
+	knot_rdataset_clear(&rr.rrs, NULL);
+
+	return node;
+}
+
+int main(int argc, char *argv[])
+{
+	plan_lazy();
+
+	const knot_dname_t *name1 = (const knot_dname_t *)"\x01""a""\x07""example""\x00";
+	const knot_dname_t *name2 = (const knot_dname_t *)"\x01""b""\x07""example""\x00";
+
+	zone_contents_t *zone = zone_contents_new(apex, false);
+	zone_node_t *node1 = add_rrsig(zone, name1, 3000);
+	zone_node_t *node2 = add_rrsig(zone, name2, 2000);
+	ok(add_rrsig(zone, name2, 4000) != NULL && node1 != NULL && node2 != NULL,
+	   "rrsig_index: zone created");
+
+	zone_keyset_t keyset = { 0 };
+	rrsig_index_t *index = rrsig_index_new(&keyset);
+	ok(index != NULL, "rrsig_index: new");
+	ok(rrsig_index_next(index) == 0, "rrsig_index: empty");
+	ok(rrsig_index_keys_match(index, &keyset), "rrsig_index: same keys");
+	zone_keyset_t other_keyset = { .count = 1 };
+	ok(!rrsig_index_keys_match(index, &other_keyset), "rrsig_index: other keys");
+
+	int ret = rrsig_index_add_tree(index, zone->nodes, false);
+	is_int(KNOT_EOK, ret, "rrsig_index: add tree");
+	ok(rrsig_index_next(index) == 2000, "rrsig_index: earliest expiration");
+
+	// Updating a node replaces its entry.
+	knot_rrset_t rrsig = node_rrset(node2, KNOT_RRTYPE_RRSIG);
+	knot_rrset_t *copy = knot_rrset_copy(&rrsig, NULL);
+	zone_node_t *removed = NULL;
+	ret = zone_contents_remove_rr(zone, copy, &removed);
+	knot_rrset_free(copy, NULL);
+	ok(ret == KNOT_EOK && add_rrsig(zone, name2, 5000) != NULL, "rrsig_index: node re-signed");
+	ret = rrsig_index_add_tree(index, zone->nodes, false);
+	ok(ret == KNOT_EOK && rrsig_index_next(index) == 3000, "rrsig_index: entry updated");
+
+	// The next batch is postponed, but not past the expiration or deadline.
+	ok(rrsig_index_next_batch(index, 1000, 100, 0) == 1100,
+	   "rrsig_index: next batch postponed");
+	ok(rrsig_index_next_batch(index, 2950, 100, 0) == 3000,
+	   "rrsig_index: next batch before expiration");
+	ok(rrsig_index_next_batch(index, 1000, 100, 1050) == 1050,
+	   "rrsig_index: next batch before deadline");
+
+	// Popping returns the expiring nodes.
+	zone_tree_t *nodes = zone_tree_create(false);
+	zone_tree_t *nsec3_nodes = zone_tree_create(false);
+	ret = rrsig_index_pop(index, 2999, 0, zone, nodes, nsec3_nodes);
+	ok(ret == KNOT_EOK && zone_tree_is_empty(nodes), "rrsig_index: nothing due");
+	ret = rrsig_index_pop(index, 3000, 0, zone, nodes, nsec3_nodes);
+	ok(ret == KNOT_EOK && zone_tree_count(nodes) == 1 &&
+	   zone_tree_get(nodes, name1) != NULL && zone_tree_is_empty(nsec3_nodes),
+	   "rrsig_index: due node");
+	ok(rrsig_index_next(index) == 5000, "rrsig_index: popped");
+
+	// Popping is limited to given number of nodes.
+	ret = rrsig_index_add_tree(index, nodes, false);
+	ok(ret == KNOT_EOK && rrsig_index_next(index) == 3000, "rrsig_index: node re-added");
+	ret = rrsig_index_pop(index, 10000, 1, zone, nodes, nsec3_nodes);
+	ok(ret == KNOT_EOK && zone_tree_count(nodes) == 1 &&
+	   zone_tree_get(nodes, name2) == NULL && rrsig_index_next(index) == 5000,
+	   "rrsig_index: limited pop");
+
+	// Entries of removed nodes are dropped silently.
+	rrsig = node_rrset(zone_contents_find_node(zone, name2), KNOT_RRTYPE_RRSIG);
+	copy = knot_rrset_copy(&rrsig, NULL);
+	removed = NULL;
+	ret = zone_contents_remove_rr(zone, copy, &removed);
+	knot_rrset_free(copy, NULL);
+	ok(ret == KNOT_EOK && zone_contents_find_node(zone, name2) == NULL,
+	   "rrsig_index: node removed");
+	ret = rrsig_index_pop(index, 10000, 0, zone, nodes, nsec3_nodes);
+	ok(ret == KNOT_EOK && zone_tree_count(nodes) == 1 && rrsig_index_next(index) == 0,
+	   "rrsig_index: removed node skipped");
+	ok(rrsig_index_next_batch(index, 1000, 100, 0) == 1100,
+	   "rrsig_index: next batch of empty index");
+
+	zone_tree_free(&nodes);
+	zone_tree_free(&nsec3_nodes);
+	rrsig_index_free(index);
+	zone_contents_deep_free(zone);
+
+	return 0;
+}
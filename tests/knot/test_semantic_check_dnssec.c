@@ -0,0 +1,131 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <tap/basic.h>
+
+#include "knot/zone/semantic-check.h"
+#include "knot/zone/zonefile.h"
+#include "libknot/libknot.h"
+
+#define ZONE_FILE "knot/semantic_check_data/no_error_delegaton_bitmap.signed"
+
+// Within the validity period of the signatures in the zone file.
+#define CHECK_TIME 1500000000
+
+typedef struct {
+	sem_handler_t handler;
+	unsigned count;
+} test_handler_t;
+
+static void test_cb(sem_handler_t *handler, const zone_contents_t *zone,
+                    const zone_node_t *node, sem_error_t error, const char *data)
+{
+	test_handler_t *h = (test_handler_t *)handler;
+	h->count++;
+	handler->warning = true;
+}
+
+static int check(zone_contents_t *zone, zone_tree_t *nodes, unsigned threads,
+                 unsigned *count)
+{
+	test_handler_t h = { .handler = { .cb = test_cb } };
+	int ret = sem_checks_dnssec(zone, nodes, NULL, &h.handler, CHECK_TIME, threads);
+	*count = h.count;
+	return ret;
+}
+
+static zone_contents_t *load_zone(const char *path, const knot_dname_t *origin)
+{
+	test_handler_t h = { .handler = { .cb = test_cb } };
+
+	zloader_t zl;
+	if (zonefile_open(&zl, path, origin, false, CHECK_TIME) != KNOT_EOK) {
+		return NULL;
+	}
+	zl.err_handler = &h.handler;
+	zl.creator->master = true;
+
+	zone_contents_t *zone = zonefile_load(&zl);
+	zonefile_close(&zl);
+
+	return zone;
+}
+
+static void corrupt_rrsig(zone_node_t *node)
+{
+	knot_rdataset_t *rrsigs = node_rdataset(node, KNOT_RRTYPE_RRSIG);
+	knot_rdata_t *rrsig = rrsigs->rdata;
+	rrsig->data[rrsig->len - 1] ^= 0xff;
+}
+
+int main(int argc, char *argv[])
+{
+	plan_lazy();
+
+	const knot_dname_t *origin = (const knot_dname_t *)"\x07""example""\x03""com""\x00";
+	const knot_dname_t *dns1 = (const knot_dname_t *)"\x04""dns1""\x07""example""\x03""com""\x00";
+
+	char *path = test_file_path(ZONE_FILE);
+	zone_contents_t *zone = load_zone(path, origin);
+	test_file_path_free(path);
+	if (zone == NULL) {
+		skip_all("failed to load the zone file");
+		return 0;
+	}
+
+	unsigned count = 0;
+
+	// Valid zone.
+	int ret = check(zone, NULL, 1, &count);
+	ok(ret == KNOT_EOK && count == 0, "sem_checks_dnssec: valid zone");
+	ret = check(zone, NULL, 4, &count);
+	ok(ret == KNOT_EOK && count == 0, "sem_checks_dnssec: valid zone, parallel");
+
+	// Expired signatures.
+	test_handler_t h = { .handler = { .cb = test_cb } };
+	ret = sem_checks_dnssec(zone, NULL, NULL, &h.handler, 4000000000, 1);
+	ok(ret == KNOT_ESEMCHECK && h.count > 0, "sem_checks_dnssec: expired signatures");
+
+	// Bad signature.
+	zone_node_t *node = zone_tree_get(zone->nodes, dns1);
+	ok(node != NULL, "sem_checks_dnssec: node found");
+	corrupt_rrsig(node);
+	ret = check(zone, NULL, 1, &count);
+	ok(ret == KNOT_ESEMCHECK && count == 1, "sem_checks_dnssec: bad signature");
+	ret = check(zone, NULL, 4, &count);
+	ok(ret == KNOT_ESEMCHECK && count == 1, "sem_checks_dnssec: bad signature, parallel");
+
+	// Only the changed nodes are validated.
+	zone_tree_t *changed = zone_tree_create(zone->nodes->flags & ZONE_TREE_USE_BINODES);
+	ret = zone_tree_insert(changed, &zone->apex);
+	ok(ret == KNOT_EOK, "sem_checks_dnssec: changed nodes created");
+	ret = check(zone, changed, 1, &count);
+	ok(ret == KNOT_EOK && count == 0, "sem_checks_dnssec: valid changed nodes");
+	ret = zone_tree_insert(changed, &node);
+	ok(ret == KNOT_EOK, "sem_checks_dnssec: bad node changed");
+	ret = check(zone, changed, 1, &count);
+	ok(ret == KNOT_ESEMCHECK && count == 1, "sem_checks_dnssec: bad changed node");
+
+	// Invalid parameters.
+	ok(sem_checks_dnssec(NULL, NULL, NULL, &h.handler, CHECK_TIME, 1) == KNOT_EINVAL &&
+	   sem_checks_dnssec(zone, NULL, NULL, NULL, CHECK_TIME, 1) == KNOT_EINVAL,
+	   "sem_checks_dnssec: invalid parameters");
+
+	zone_tree_free(&changed);
+	zone_contents_deep_free(zone);
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tap/basic.h>
+
+#include "knot/zone/zone-dump.h"
+#include "libknot/libknot.h"
+#include "contrib/wire_ctx.h"
+
+// More nodes than fit into one round of the parallel dump.
+#define NODES		(3 * 16384 + 1000)
+#define NSEC3_NODES	(16384 + 1000)
+
+static const knot_dname_t *apex = (const knot_dname_t *)"\x07""example""\x00";
+
+static int add_rr(zone_contents_t *zone, const char *owner, uint16_t type,
+                  const uint8_t *rdata, uint16_t rdlen)
+{
+	knot_dname_t *name = knot_dname_from_str_alloc(owner);
+	if (name == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	knot_rrset_t rr;
+	knot_rrset_init(&rr, name, type, KNOT_CLASS_IN, 3600);
+	zone_node_t *node = NULL;
+	int ret = knot_rrset_add_rdata(&rr, rdata, rdlen, NULL);
+	if (ret == KNOT_EOK) {
+		ret = zone_contents_add_rr(zone, &rr, &node);
+	}
+	knot_rrset_clear(&rr, NULL);
+
+	return ret;
+}
+
+static int add_rrsig(zone_contents_t *zone, const char *owner, uint16_t covered)
+{
+	uint8_t rdata[64] = { 0 };
+	wire_ctx_t wire = wire_ctx_init(rdata, sizeof(rdata));
+	wire_ctx_write_u16(&wire, covered);
+	wire_ctx_write_u8(&wire, 13);
+	wire_ctx_write_u8(&wire, 2);
+	wire_ctx_write_u32(&wire, 3600);
+	wire_ctx_write_u32(&wire, 2000000000);
+	wire_ctx_write_u32(&wire, 1000000000);
+	wire_ctx_write_u16(&wire, 1234);
+	wire_ctx_write(&wire, apex, knot_dname_size(apex));
+	wire_ctx_write(&wire, (const uint8_t *)"signature", 9);
+
+	return add_rr(zone, owner, KNOT_RRTYPE_RRSIG, rdata, wire_ctx_offset(&wire));
+}
+
+static zone_contents_t *create_zone(void)
+{
+	zone_contents_t *zone = zone_contents_new(apex, false);
+	if (zone == NULL) {
+		return NULL;
+	}
+
+	const uint8_t soa[] = "\x02""ns""\x07""example""\x00"
+	                      "\x04""host""\x07""example""\x00"
+	                      "\x00\x00\x00\x01" "\x00\x00\x0e\x10" "\x00\x00\x0e\x10"
+	                      "\x00\x00\x0e\x10" "\x00\x00\x0e\x10";
+	int ret = add_rr(zone, "example.", KNOT_RRTYPE_SOA, soa, sizeof(soa) - 1);
+
+	char owner[KNOT_DNAME_TXT_MAXLEN];
+	for (unsigned i = 0; i < NODES && ret == KNOT_EOK; i++) {
+		(void)snprintf(owner, sizeof(owner), "n%u.example.", i);
+		uint8_t a[4] = { 10, i >> 16, i >> 8, i };
+		ret = add_rr(zone, owner, KNOT_RRTYPE_A, a, sizeof(a));
+		if (ret == KNOT_EOK && i % 3 == 0) {
+			ret = add_rrsig(zone, owner, KNOT_RRTYPE_A);
+		}
+		if (ret == KNOT_EOK && i % 5 == 0) {
+			const uint8_t txt[] = "\x0b""hello world";
+			ret = add_rr(zone, owner, KNOT_RRTYPE_TXT, txt, sizeof(txt) - 1);
+		}
+	}
+
+	for (unsigned i = 0; i < NSEC3_NODES && ret == KNOT_EOK; i++) {
+		(void)snprintf(owner, sizeof(owner), "%032u.example.", i);
+		// Algorithm, flags, iterations, no salt, hash and A in bitmap.
+		uint8_t nsec3[6 + 20 + 3] = { 1, 0, 0, 10, 0, 20 };
+		nsec3[6] = i >> 8;
+		nsec3[7] = i;
+		nsec3[26] = 0;
+		nsec3[27] = 1;
+		nsec3[28] = 0x40;
+		ret = add_rr(zone, owner, KNOT_RRTYPE_NSEC3, nsec3, sizeof(nsec3));
+		if (ret == KNOT_EOK && i % 2 == 0) {
+			ret = add_rrsig(zone, owner, KNOT_RRTYPE_NSEC3);
+		}
+	}
+
+	if (ret != KNOT_EOK) {
+		zone_contents_deep_free(zone);
+		return NULL;
+	}
+
+	return zone;
+}
+
+static int dump(zone_contents_t *zone, unsigned threads, char **out, size_t *out_len)
+{
+	FILE *file = open_memstream(out, out_len);
+	if (file == NULL) {
+		return KNOT_ENOMEM;
+	}
+
+	int ret = zone_dump_text(zone, file, true, threads);
+	fclose(file);
+
+	// Ignore the trailing dump time.
+	char *time = strstr(*out, ";; Time");
+	if (time != NULL) {
+		*out_len = time - *out;
+	}
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	plan_lazy();
+
+	zone_contents_t *zone = create_zone();
+	ok(zone != NULL, "zone dump: create zone");
+	if (zone == NULL) {
+		return 0;
+	}
+
+	char *seq = NULL, *par = NULL;
+	size_t seq_len = 0, par_len = 0;
+
+	int ret = dump(zone, 1, &seq, &seq_len);
+	is_int(KNOT_EOK, ret, "zone dump: sequential");
+
+	ret = dump(zone, 4, &par, &par_len);
+	is_int(KNOT_EOK, ret, "zone dump: parallel");
+
+	ok(seq_len > 0 && seq_len == par_len && memcmp(seq, par, seq_len) == 0,
+	   "zone dump: parallel output identical");
+
+	free(seq);
+	free(par);
+
+	// Three threads don't divide the node count evenly.
+	ret = dump(zone, 1, &seq, &seq_len);
+	ok(ret == KNOT_EOK && dump(zone, 3, &par, &par_len) == KNOT_EOK &&
+	   seq_len == par_len && memcmp(seq, par, seq_len) == 0,
+	   "zone dump: uneven parallel output identical");
+
+	free(seq);
+	free(par);
+
+	zone_contents_deep_free(zone);
+
+	return 0;
+}
@@ -14,6 +14,9 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
 #include <tap/basic.h>
 #include <tap/files.h>
 
@@ -69,6 +72,36 @@ int main(void)
 	ok(r == DNSSEC_EOK, "read B");
 	dnssec_key_free(key);
 
+	// reading cached content
+
+	dnssec_key_new(&key);
+	dnssec_key_set_algorithm(key, DNSSEC_KEY_ALGORITHM_RSA_SHA256);
+	r = dnssec_keystore_export(store, id_A, key);
+	ok(r == DNSSEC_EOK && dnssec_key_can_sign(key), "read A again");
+	dnssec_key_free(key);
+
+	// replaced content isn't read from the cache
+
+	char path_A[PATH_MAX], path_B[PATH_MAX];
+	(void)snprintf(path_A, sizeof(path_A), "%s/%s.pem", dir, id_A);
+	(void)snprintf(path_B, sizeof(path_B), "%s/%s.pem", dir, id_B);
+	ok(unlink(path_A) == 0 && link(path_B, path_A) == 0, "replace A with B");
+
+	dnssec_binary_t pubkey_A = { 0 }, pubkey_B = { 0 };
+	dnssec_key_new(&key);
+	dnssec_key_set_algorithm(key, DNSSEC_KEY_ALGORITHM_RSA_SHA256);
+	r = dnssec_keystore_export(store, id_A, key);
+	dnssec_key_get_pubkey(key, &pubkey_A);
+	dnssec_key_t *key_B = NULL;
+	dnssec_key_new(&key_B);
+	dnssec_key_set_algorithm(key_B, DNSSEC_KEY_ALGORITHM_RSA_SHA256);
+	r |= dnssec_keystore_export(store, id_B, key_B);
+	dnssec_key_get_pubkey(key_B, &pubkey_B);
+	ok(r == DNSSEC_EOK && dnssec_binary_cmp(&pubkey_A, &pubkey_B) == 0,
+	   "read replaced A");
+	dnssec_key_free(key);
+	dnssec_key_free(key_B);
+
 	// content removal
 
 	r = dnssec_keystore_remove(store, id_A);
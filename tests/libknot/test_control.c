@@ -197,7 +197,7 @@ static void test_client_server_client(void)
 	if (child_pid == 0) {
 		ctl_client(socket, data_len, data);
 		free(socket);
-		return;
+		exit(0);
 	} else {
 		ctl_server(socket, data_len, data);
 	}
@@ -210,6 +210,84 @@ static void test_client_server_client(void)
 	free(socket);
 }
 
+static void test_binary_accept_to(void)
+{
+	char *socket = test_mktemp();
+	ok(socket != NULL, "Make a temporary socket file '%s'", socket);
+
+	knot_ctl_t *ctl = knot_ctl_alloc();
+	knot_ctl_t *client_ctl = knot_ctl_alloc();
+	ok(ctl != NULL && client_ctl != NULL, "Allocate controls");
+
+	int ret = knot_ctl_bind(ctl, socket);
+	is_int(KNOT_EOK, ret, "Bind control socket");
+
+	const char bin[] = "\x01\x00\x02\x00";
+	knot_ctl_data_t data = {
+		[KNOT_CTL_IDX_ZONE] = "zone",
+		[KNOT_CTL_IDX_DATA] = bin
+	};
+
+	// Fork a client process.
+	pid_t child_pid = fork();
+	if (child_pid == -1) {
+		ok(child_pid >= 0, "Process fork");
+		return;
+	}
+	if (child_pid == 0) {
+		knot_ctl_t *cli = knot_ctl_alloc();
+		fake_ok(cli != NULL, "Allocate control");
+		for (int i = 0; i < 20; i++) {
+			ret = knot_ctl_connect(cli, socket);
+			if (ret == KNOT_EOK) {
+				break;
+			}
+			usleep(100000);
+		}
+		fake_ok(ret == KNOT_EOK, "Connect to socket");
+		ret = knot_ctl_send_binary(cli, KNOT_CTL_TYPE_DATA, &data,
+		                           KNOT_CTL_IDX_DATA, sizeof(bin));
+		fake_ok(ret == KNOT_EOK, "Client send binary data");
+		ret = knot_ctl_send(cli, KNOT_CTL_TYPE_END, NULL);
+		fake_ok(ret == KNOT_EOK, "Client send final data");
+		knot_ctl_free(cli);
+		free(socket);
+		exit(0);
+	}
+
+	ret = knot_ctl_accept_to(ctl, client_ctl);
+	is_int(KNOT_EOK, ret, "Accept a connection to another control");
+
+	knot_ctl_data_t recv_data;
+	knot_ctl_type_t type = KNOT_CTL_TYPE_END;
+	ret = knot_ctl_receive(client_ctl, &type, &recv_data);
+	ok(ret == KNOT_EOK && type == KNOT_CTL_TYPE_DATA, "Receive data");
+	ok(strcmp(recv_data[KNOT_CTL_IDX_ZONE], "zone") == 0 &&
+	   knot_ctl_data_len(client_ctl, KNOT_CTL_IDX_ZONE) == 4,
+	   "Compare string item");
+	ok(knot_ctl_data_len(client_ctl, KNOT_CTL_IDX_DATA) == sizeof(bin) &&
+	   memcmp(recv_data[KNOT_CTL_IDX_DATA], bin, sizeof(bin)) == 0,
+	   "Compare binary item");
+	ok(knot_ctl_data_len(client_ctl, KNOT_CTL_IDX_OWNER) == 0,
+	   "Missing item length");
+
+	ret = knot_ctl_receive(client_ctl, &type, &recv_data);
+	ok(ret == KNOT_EOK && type == KNOT_CTL_TYPE_END, "Receive EOF type");
+	ok(knot_ctl_data_len(client_ctl, KNOT_CTL_IDX_DATA) == 0,
+	   "Reset item length");
+
+	int status = 0;
+	wait(&status);
+	ok(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Wait for client");
+
+	knot_ctl_free(client_ctl);
+	knot_ctl_unbind(ctl);
+	knot_ctl_free(ctl);
+
+	test_rm_rf(socket);
+	free(socket);
+}
+
 int main(int argc, char *argv[])
 {
 	plan_lazy();
@@ -217,5 +295,8 @@ int main(int argc, char *argv[])
 	diag("Client -> Server -> Client");
 	test_client_server_client();
 
+	diag("Binary data, accept to another control");
+	test_binary_accept_to();
+
 	return 0;
 }
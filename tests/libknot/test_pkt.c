@@ -38,6 +38,148 @@ const char *g_rdata[DATACOUNT] = {
 #define RDVAL(i) ((const uint8_t*)(g_rdata[(i)] + 1))
 #define RDLEN(i) ((uint16_t)(g_rdata[(i)][0]))
 
+/*! \brief Pre-renders the RRSet with the owner placeholder. */
+static uint16_t render_wire(const knot_rrset_t *rr, uint8_t *wire, size_t max_size)
+{
+	wire_ctx_t ctx = wire_ctx_init(wire, max_size);
+	knot_rdata_t *rdata = rr->rrs.rdata;
+	for (uint16_t i = 0; i < rr->rrs.count; i++) {
+		wire_ctx_write_u16(&ctx, 0);
+		wire_ctx_write_u16(&ctx, rr->type);
+		wire_ctx_write_u16(&ctx, rr->rclass);
+		wire_ctx_write_u32(&ctx, rr->ttl);
+		wire_ctx_write_u16(&ctx, rdata->len);
+		wire_ctx_write(&ctx, rdata->data, rdata->len);
+		rdata = knot_rdataset_next(rdata);
+	}
+
+	return wire_ctx_offset(&ctx);
+}
+
+/* @note Rotated pre-rendered RRSet test, 1 check. */
+static void test_put_wire_rotate(const knot_rrset_t *rr, knot_mm_t *mm)
+{
+	knot_rrset_t *multi = knot_rrset_copy(rr, NULL);
+	for (uint8_t i = 2; i <= 3; i++) {
+		const uint8_t addr[] = { 192, 0, 2, i };
+		knot_rrset_add_rdata(multi, addr, sizeof(addr), NULL);
+	}
+
+	uint8_t wire[KNOT_WIRE_MAX_PKTSIZE];
+	uint16_t wire_len = render_wire(multi, wire, sizeof(wire));
+
+	knot_pkt_t *ref = knot_pkt_new(NULL, KNOT_WIRE_MAX_PKTSIZE, mm);
+	knot_pkt_t *pkt = knot_pkt_new(NULL, KNOT_WIRE_MAX_PKTSIZE, mm);
+	knot_pkt_put_question(ref, multi->owner, KNOT_CLASS_IN, multi->type);
+	knot_pkt_put_question(pkt, multi->owner, KNOT_CLASS_IN, multi->type);
+	knot_pkt_begin(ref, KNOT_ANSWER);
+	knot_pkt_begin(pkt, KNOT_ANSWER);
+
+	int ret = knot_pkt_put_rotate(ref, KNOT_COMPR_HINT_QNAME, multi, 5, 0);
+	ret |= knot_pkt_put_wire_rotate(pkt, KNOT_COMPR_HINT_QNAME, multi, wire,
+	                                wire_len, 5, 0);
+	ok(ret == KNOT_EOK && pkt->size == ref->size &&
+	   memcmp(pkt->wire, ref->wire, ref->size) == 0,
+	   "pkt: rotated pre-rendered RRSet matches");
+
+	knot_pkt_free(ref);
+	knot_pkt_free(pkt);
+	knot_rrset_free(multi, NULL);
+}
+
+/* @note Pre-rendered RRSet test, 5 checks. */
+static void test_put_wire(const knot_rrset_t *rr, knot_mm_t *mm)
+{
+	uint8_t wire[KNOT_WIRE_MAX_PKTSIZE];
+	uint16_t wire_len = render_wire(rr, wire, sizeof(wire));
+
+	knot_pkt_t *ref = knot_pkt_new(NULL, KNOT_WIRE_MAX_PKTSIZE, mm);
+	knot_pkt_t *pkt = knot_pkt_new(NULL, KNOT_WIRE_MAX_PKTSIZE, mm);
+	knot_pkt_put_question(ref, rr->owner, KNOT_CLASS_IN, rr->type);
+	knot_pkt_put_question(pkt, rr->owner, KNOT_CLASS_IN, rr->type);
+	knot_pkt_begin(ref, KNOT_ANSWER);
+	knot_pkt_begin(pkt, KNOT_ANSWER);
+
+	int ret = knot_pkt_put(ref, KNOT_COMPR_HINT_QNAME, rr, 0);
+	ret |= knot_pkt_put_wire(pkt, KNOT_COMPR_HINT_QNAME, rr, wire, wire_len, 0);
+	is_int(KNOT_EOK, ret, "pkt: put pre-rendered RRSet");
+	ok(pkt->size == ref->size && memcmp(pkt->wire, ref->wire, ref->size) == 0 &&
+	   pkt->rrset_count == 1 && knot_wire_get_ancount(pkt->wire) == rr->rrs.count,
+	   "pkt: pre-rendered RRSet matches");
+
+	/* Verbatim copy of an already compressed RRSet. */
+	knot_pkt_t *copy = knot_pkt_new(NULL, KNOT_WIRE_MAX_PKTSIZE, mm);
+	knot_pkt_put_question(copy, rr->owner, KNOT_CLASS_IN, rr->type);
+	knot_pkt_begin(copy, KNOT_ANSWER);
+	size_t pos = ref->rr_info[0].pos;
+	ret = knot_pkt_put_wire(copy, KNOT_COMPR_HINT_NONE, rr, ref->wire + pos,
+	                        ref->size - pos, 0);
+	ok(ret == KNOT_EOK && copy->size == ref->size &&
+	   memcmp(copy->wire, ref->wire, ref->size) == 0,
+	   "pkt: verbatim RRSet wire");
+	knot_pkt_free(copy);
+
+	/* No space left, optional RRSet. */
+	pkt->max_size = pkt->size + wire_len - 1;
+	ret = knot_pkt_put_wire(pkt, KNOT_COMPR_HINT_QNAME, rr, wire, wire_len,
+	                        KNOT_PF_NOTRUNC);
+	ok(ret == KNOT_ESPACE && !knot_wire_get_tc(pkt->wire),
+	   "pkt: pre-rendered RRSet, no truncation");
+
+	/* No space left, mandatory RRSet. */
+	ret = knot_pkt_put_wire(pkt, KNOT_COMPR_HINT_QNAME, rr, wire, wire_len, 0);
+	ok(ret == KNOT_ESPACE && knot_wire_get_tc(pkt->wire),
+	   "pkt: pre-rendered RRSet, truncation");
+
+	knot_pkt_free(ref);
+	knot_pkt_free(pkt);
+
+	test_put_wire_rotate(rr, mm);
+}
+
+/* @note RRSet size limit test, 3 checks. */
+static void test_put_limit(knot_mm_t *mm)
+{
+	/* Odd RDATA lengths to cover the RDATA padding. */
+	knot_rrset_t *rr = knot_rrset_new((const uint8_t *)"\x03""txt""\x00",
+	                                  KNOT_RRTYPE_TXT, KNOT_CLASS_IN, TTL, NULL);
+	knot_rrset_add_rdata(rr, (const uint8_t *)"\x02""ab", 3, NULL);
+	knot_rrset_add_rdata(rr, (const uint8_t *)"\x04""abcd", 5, NULL);
+
+	knot_pkt_t *pkt = knot_pkt_new(NULL, KNOT_WIRE_MAX_PKTSIZE, mm);
+	knot_pkt_put_question(pkt, rr->owner, KNOT_CLASS_IN, rr->type);
+	knot_pkt_begin(pkt, KNOT_ANSWER);
+	size_t begin = pkt->size;
+	int ret = knot_pkt_put(pkt, KNOT_COMPR_HINT_QNAME, rr, 0);
+	size_t rr_size = pkt->size - begin;
+
+	/* Exactly fitting RRSet. */
+	knot_pkt_clear(pkt);
+	knot_pkt_put_question(pkt, rr->owner, KNOT_CLASS_IN, rr->type);
+	knot_pkt_begin(pkt, KNOT_ANSWER);
+	pkt->max_size = pkt->size + rr_size;
+	ret |= knot_pkt_put(pkt, KNOT_COMPR_HINT_QNAME, rr, 0);
+	ok(ret == KNOT_EOK && pkt->size == pkt->max_size, "pkt: fitting RRSet");
+
+	/* One byte short. */
+	knot_pkt_clear(pkt);
+	knot_pkt_put_question(pkt, rr->owner, KNOT_CLASS_IN, rr->type);
+	knot_pkt_begin(pkt, KNOT_ANSWER);
+	pkt->max_size = pkt->size + rr_size - 1;
+	ret = knot_pkt_put(pkt, KNOT_COMPR_HINT_QNAME, rr, KNOT_PF_NOTRUNC);
+	ok(ret == KNOT_ESPACE && !knot_wire_get_tc(pkt->wire),
+	   "pkt: oversized RRSet, no truncation");
+
+	/* Far too small, skipped without rendering. */
+	pkt->max_size = pkt->size + 1;
+	ret = knot_pkt_put(pkt, KNOT_COMPR_HINT_QNAME, rr, 0);
+	ok(ret == KNOT_ESPACE && knot_wire_get_tc(pkt->wire) &&
+	   pkt->rrset_count == 0, "pkt: oversized RRSet, truncation");
+
+	knot_pkt_free(pkt);
+	knot_rrset_free(rr, NULL);
+}
+
 /* @note Packet equivalence test, 5 checks. */
 static void packet_match(knot_pkt_t *in, knot_pkt_t *out)
 {
@@ -183,6 +325,12 @@ int main(int argc, char *argv[])
 	/* Compare copied packet to original. */
 	packet_match(in, copy);
 
+	/* Pre-rendered RRSet. */
+	test_put_wire(rrsets[0], &mm);
+
+	/* RRSet size limit. */
+	test_put_limit(&mm);
+
 	/* Free packets. */
 	knot_pkt_free(copy);
 	knot_pkt_free(out);
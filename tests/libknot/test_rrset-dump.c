@@ -0,0 +1,171 @@
+/*  Copyright (C) 2019 CZ.NIC, z.s.p.o. <knot-dns@labs.nic.cz>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <tap/basic.h>
+
+#include "libknot/rrset-dump.c"
+
+#define ROUNDS	100000
+
+static void test_num(void)
+{
+	const uint64_t nums[] = { 0, 1, 9, 10, 99, 100, 65535, 4294967295ULL,
+	                          10000000000000000000ULL, UINT64_MAX };
+
+	bool match = true;
+	for (int i = 0; i < sizeof(nums) / sizeof(*nums); i++) {
+		char ref[32], out[32];
+		int ref_len = snprintf(ref, sizeof(ref), "%"PRIu64, nums[i]);
+		int len = num_to_str(out, sizeof(out), nums[i]);
+		if (len != ref_len || strcmp(out, ref) != 0) {
+			match = false;
+		}
+	}
+	for (int i = 0; i < ROUNDS; i++) {
+		uint64_t num = (uint64_t)random() << 33 ^ (uint64_t)random() << 2 ^ random();
+		num >>= random() % 64;
+		char ref[32], out[32];
+		int ref_len = snprintf(ref, sizeof(ref), "%"PRIu64, num);
+		int len = num_to_str(out, sizeof(out), num);
+		if (len != ref_len || strcmp(out, ref) != 0) {
+			match = false;
+		}
+	}
+	ok(match, "num_to_str: matches printf");
+
+	char out[3];
+	ok(num_to_str(out, sizeof(out), 100) == -1, "num_to_str: output too small");
+	ok(num_to_str(out, sizeof(out), 99) == 2 && strcmp(out, "99") == 0,
+	   "num_to_str: output fits");
+}
+
+static void test_ipv4(void)
+{
+	bool match = true;
+	for (int i = 0; i < ROUNDS; i++) {
+		uint8_t addr[4];
+		for (int j = 0; j < sizeof(addr); j++) {
+			addr[j] = (random() % 4 == 0) ? 0 : random();
+		}
+		char ref[INET_ADDRSTRLEN], out[INET_ADDRSTRLEN];
+		inet_ntop(AF_INET, addr, ref, sizeof(ref));
+		int len = ipv4_to_str(out, sizeof(out), addr);
+		if (len != strlen(ref) || strcmp(out, ref) != 0) {
+			match = false;
+		}
+	}
+	ok(match, "ipv4_to_str: matches inet_ntop");
+
+	char out[8];
+	const uint8_t addr[4] = { 255, 255, 255, 255 };
+	ok(ipv4_to_str(out, sizeof(out), addr) == -1, "ipv4_to_str: output too small");
+}
+
+static bool ipv6_match(const char *str)
+{
+	uint8_t addr[16];
+	if (inet_pton(AF_INET6, str, addr) != 1) {
+		return false;
+	}
+
+	char ref[INET6_ADDRSTRLEN], out[INET6_ADDRSTRLEN];
+	inet_ntop(AF_INET6, addr, ref, sizeof(ref));
+	int len = ipv6_to_str(out, sizeof(out), addr);
+
+	return len == strlen(ref) && strcmp(out, ref) == 0;
+}
+
+static void test_ipv6(void)
+{
+	ok(ipv6_match("::"), "ipv6_to_str: unspecified address");
+	ok(ipv6_match("::1"), "ipv6_to_str: loopback");
+	ok(ipv6_match("::2"), "ipv6_to_str: trailing word");
+	ok(ipv6_match("::1.2.3.4"), "ipv6_to_str: IPv4-compatible");
+	ok(ipv6_match("::ffff:1.2.3.4"), "ipv6_to_str: IPv4-mapped");
+	ok(ipv6_match("::fffe:1.2.3.4"), "ipv6_to_str: not IPv4-mapped");
+	ok(ipv6_match("1::"), "ipv6_to_str: trailing zero run");
+	ok(ipv6_match("::1:0:0:0:1"), "ipv6_to_str: leading zero run");
+	ok(ipv6_match("1:0:0:1::1"), "ipv6_to_str: longer second zero run");
+	ok(ipv6_match("1:0:0:1:0:0:1:1"), "ipv6_to_str: equal zero runs");
+	ok(ipv6_match("1:0:1:1:1:1:1:1"), "ipv6_to_str: single zero word");
+	ok(ipv6_match("2001:db8:a:bc:def:1234:ffff:10"), "ipv6_to_str: no zeros");
+
+	bool match = true;
+	for (int i = 0; i < ROUNDS; i++) {
+		uint8_t addr[16];
+		long zeros = random();
+		for (int j = 0; j < 8; j++) {
+			uint16_t word = (zeros & (1 << j)) ? 0 : random() >> (random() % 16);
+			addr[2 * j] = word >> 8;
+			addr[2 * j + 1] = word;
+		}
+		char ref[INET6_ADDRSTRLEN], out[INET6_ADDRSTRLEN];
+		inet_ntop(AF_INET6, addr, ref, sizeof(ref));
+		int len = ipv6_to_str(out, sizeof(out), addr);
+		if (len != strlen(ref) || strcmp(out, ref) != 0) {
+			match = false;
+		}
+	}
+	ok(match, "ipv6_to_str: matches inet_ntop");
+}
+
+static bool timestamp_match(uint32_t timestamp)
+{
+	time_t time = timestamp;
+	struct tm tm;
+	gmtime_r(&time, &tm);
+
+	char ref[32], out[32];
+	strftime(ref, sizeof(ref), "%Y%m%d%H%M%S", &tm);
+	int len = timestamp_to_str(out, sizeof(out), timestamp);
+
+	return len == strlen(ref) && strcmp(out, ref) == 0;
+}
+
+static void test_timestamp(void)
+{
+	ok(timestamp_match(0), "timestamp_to_str: epoch");
+	ok(timestamp_match(951782400), "timestamp_to_str: leap day 2000");
+	ok(timestamp_match(4107456000), "timestamp_to_str: no leap day 2100");
+	ok(timestamp_match(UINT32_MAX), "timestamp_to_str: maximum");
+
+	bool match = true;
+	for (int i = 0; i < ROUNDS; i++) {
+		if (!timestamp_match(random() ^ (uint32_t)random() << 1)) {
+			match = false;
+		}
+	}
+	ok(match, "timestamp_to_str: matches strftime");
+
+	char out[14];
+	ok(timestamp_to_str(out, sizeof(out), 0) == -1,
+	   "timestamp_to_str: output too small");
+}
+
+int main(int argc, char *argv[])
+{
+	plan_lazy();
+
+	srandom(time(NULL));
+
+	test_num();
+	test_ipv4();
+	test_ipv6();
+	test_timestamp();
+
+	return 0;
+}
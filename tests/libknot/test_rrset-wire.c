@@ -73,7 +73,7 @@ struct wire_data {
 	const char *msg;
 };
 
-#define FROM_CASE_COUNT 17
+#define FROM_CASE_COUNT 19
 
 static const struct wire_data FROM_CASES[FROM_CASE_COUNT] = {
 { .wire = { MESSAGE_HEADER(1, 0, 0), QUERY(QNAME, KNOT_RRTYPE_A)},
@@ -110,6 +110,18 @@ static const struct wire_data FROM_CASES[FROM_CASE_COUNT] = {
   .pos = QUERY_SIZE + QNAME_SIZE,
   .code = KNOT_EMALF,
   .msg = "Trailing RDATA" },
+{ .wire = { MESSAGE_HEADER(1, 0, 0), QUERY(QNAME, KNOT_RRTYPE_AAAA),
+            RR_HEADER(QNAME_POINTER, KNOT_RRTYPE_AAAA, 0x00, 0x03), 0x00, 0x01, 0x08 },
+  .size = QUERY_SIZE + QNAME_SIZE + RR_HEADER_SIZE + 2 + 3,
+  .pos = QUERY_SIZE + QNAME_SIZE,
+  .code = KNOT_EMALF,
+  .msg = "Short AAAA RDATA" },
+{ .wire = { MESSAGE_HEADER(1, 0, 0), QUERY(QNAME, KNOT_RRTYPE_DS),
+            RR_HEADER(QNAME_POINTER, KNOT_RRTYPE_DS, 0x00, 0x05), 0x00, 0x01, 0x08, 0x02, 0xff },
+  .size = QUERY_SIZE + QNAME_SIZE + RR_HEADER_SIZE + 2 + 5,
+  .pos = QUERY_SIZE + QNAME_SIZE,
+  .code = KNOT_EOK,
+  .msg = "Remainder RDATA" },
 { .wire = { MESSAGE_HEADER(1, 0, 0), QUERY(QNAME_LONG, KNOT_RRTYPE_SOA),
             RR_HEADER(QNAME_POINTER, KNOT_RRTYPE_SOA, 0x00, 0x18), QNAME_POINTER, QNAME_POINTER,
             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,